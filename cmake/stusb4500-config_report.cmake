@@ -0,0 +1,126 @@
+# Rapport de la configuration NVM : valeurs Kconfig demandées et image de
+# 40 octets telle que compilée (KCONFIG_NVM_IMAGE, relue dans l'objet de
+# stusb4500-config_macro.cpp). Aucune quantification n'est refaite ici : les
+# static_assert de stusb4500-config_macro.cpp refusent à la compilation toute
+# valeur que l'image ne restituerait pas exactement.
+#
+#   cmake -DSDKCONFIG=<sdkconfig|sdkconfig.h> -DOBJDUMP=<objdump> -DOBJECTS="a.obj|b.obj"
+#         [-DOUTPUT=<rapport.txt>] -P stusb4500-config_report.cmake
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT SDKCONFIG OR NOT EXISTS "${SDKCONFIG}")
+    message(FATAL_ERROR "SDKCONFIG doit désigner le fichier sdkconfig")
+endif()
+if(NOT OBJDUMP OR NOT OBJECTS)
+    message(FATAL_ERROR "OBJDUMP et OBJECTS sont requis")
+endif()
+
+# sdkconfig (CONFIG_X=valeur) ou sdkconfig.h (#define CONFIG_X valeur)
+file(STRINGS "${SDKCONFIG}" lines REGEX "CONFIG_STUSB4500_")
+set(options "")
+foreach(line IN LISTS lines)
+    if(line MATCHES "^CONFIG_STUSB4500_([A-Z0-9_]+)=(.*)$" OR
+       line MATCHES "^#define CONFIG_STUSB4500_([A-Z0-9_]+) (.*)$")
+        set(K_${CMAKE_MATCH_1} "${CMAKE_MATCH_2}")
+        list(APPEND options ${CMAKE_MATCH_1})
+    endif()
+endforeach()
+
+function(pad_right out value width)
+    string(LENGTH "${value}" len)
+    if(len LESS width)
+        math(EXPR n "${width} - ${len}")
+        string(REPEAT " " ${n} spaces)
+    endif()
+    set(${out} "${value}${spaces}" PARENT_SCOPE)
+endfunction()
+
+set(report "STUSB4500 NVM configuration from ${SDKCONFIG}\n")
+
+macro(row field value)
+    pad_right(c1 "${field}" 22)
+    string(APPEND report "  ${c1}${value}\n")
+endmacro()
+
+if(K_PDO3_ENABLE)
+    row("snk_pdo_numb" 3)
+elseif(K_PDO2_ENABLE)
+    row("snk_pdo_numb" 2)
+else()
+    row("snk_pdo_numb" 1)
+endif()
+foreach(pdo 1 2 3)
+    if(pdo EQUAL 1)
+        row("pdo1_voltage_mv" 5000)
+    else()
+        row("pdo${pdo}_voltage_mv" ${K_PDO${pdo}_VOLTAGE})
+    endif()
+    # Choix Kconfig : seule l'option retenue est présente
+    set(current "?")
+    foreach(option IN LISTS options)
+        if(option MATCHES "^PDO${pdo}_CURRENT_(.+)$")
+            string(TOLOWER "${CMAKE_MATCH_1}" current)
+        endif()
+    endforeach()
+    row("pdo${pdo}_current_ma" ${current})
+    row("pdo${pdo}_vbus_low_%" ${K_PDO${pdo}_VBUS_LOW})
+    row("pdo${pdo}_vbus_high_%" ${K_PDO${pdo}_VBUS_HIGH})
+endforeach()
+row("flex_current_ma" ${K_FLEX_CURRENT})
+row("discharge_to_0v" ${K_DISCHARGE_TO_0V})
+row("discharge_to_pdo" ${K_DISCHARGE_TO_PDO})
+
+# Image compilée : symbole local KCONFIG_NVM_IMAGE (section, décalage, taille)
+string(REPLACE "|" ";" object_list "${OBJECTS}")
+set(image "")
+foreach(obj IN LISTS object_list)
+    if(NOT obj MATCHES "stusb4500-config_macro")
+        continue()
+    endif()
+    execute_process(COMMAND ${OBJDUMP} -t ${obj} OUTPUT_VARIABLE symbols RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0 OR NOT symbols MATCHES
+       "([0-9a-f]+)[ \t]+l[ \t]+O[ \t]+([^ \t\n]+)[ \t]+([0-9a-f]+)[ \t]+[^\n]*KCONFIG_NVM_IMAGE")
+        continue()
+    endif()
+    set(section "${CMAKE_MATCH_2}")
+    math(EXPR offset "0x${CMAKE_MATCH_1}")
+    math(EXPR size "0x${CMAKE_MATCH_3}")
+
+    # Lignes " 0010 02400f00 3200fcf1 ...  ascii" : adresse puis jusqu'à 16 octets
+    execute_process(COMMAND ${OBJDUMP} -s -j ${section} ${obj} OUTPUT_VARIABLE dump RESULT_VARIABLE rc)
+    string(REGEX MATCHALL "\n [0-9a-f]+ [0-9a-f ]+" dump_lines "${dump}")
+    set(hex "")
+    foreach(dump_line IN LISTS dump_lines)
+        string(REGEX REPLACE "^\n [0-9a-f]+ " "" words "${dump_line}")
+        string(SUBSTRING "${words}" 0 35 words)
+        string(REGEX REPLACE "[ ]" "" words "${words}")
+        string(APPEND hex "${words}")
+    endforeach()
+    math(EXPR start "${offset} * 2")
+    math(EXPR length "${size} * 2")
+    string(SUBSTRING "${hex}" ${start} ${length} image)
+    break()
+endforeach()
+
+string(LENGTH "${image}" image_len)
+if(NOT image_len EQUAL 80)
+    message(FATAL_ERROR "KCONFIG_NVM_IMAGE introuvable dans les objets du composant")
+endif()
+
+string(TOUPPER "${image}" image)
+string(APPEND report "NVM image (compiled)\n")
+foreach(bank 0 1 2 3 4)
+    set(bytes "")
+    foreach(i RANGE 0 7)
+        math(EXPR pos "(${bank} * 8 + ${i}) * 2")
+        string(SUBSTRING "${image}" ${pos} 2 byte)
+        string(APPEND bytes " ${byte}")
+    endforeach()
+    string(APPEND report "  bank ${bank} :${bytes}\n")
+endforeach()
+
+message("${report}")
+if(OUTPUT)
+    file(WRITE "${OUTPUT}" "${report}")
+endif()
@@ -0,0 +1,74 @@
+# Agrège la sortie de `size` (format Berkeley) par sous-système, c'est-à-dire
+# par sous-dossier de src/ (status, nvm, pd, config, ctrl, ...). Les fichiers
+# directement sous src/ sont regroupés dans "core".
+#
+#   cmake -DSIZE_TOOL=<size> -DOBJECTS="a.obj|b.obj" -P stusb4500-size_report.cmake
+#
+# flash = text + data, ram = data + bss
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT SIZE_TOOL OR NOT OBJECTS)
+    message(FATAL_ERROR "SIZE_TOOL et OBJECTS sont requis")
+endif()
+
+string(REPLACE "|" ";" object_list "${OBJECTS}")
+set(subsystems "")
+
+foreach(obj IN LISTS object_list)
+    if(obj MATCHES "/src/([^/]+)/[^/]+$")
+        set(sub "${CMAKE_MATCH_1}")
+    else()
+        set(sub "core")
+    endif()
+
+    execute_process(COMMAND ${SIZE_TOOL} ${obj}
+                    OUTPUT_VARIABLE out
+                    RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0)
+        message(WARNING "size a échoué sur ${obj}")
+        continue()
+    endif()
+
+    # Deuxième ligne : text data bss dec hex filename
+    string(REGEX MATCH "\n[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)" row "${out}")
+    if(NOT row)
+        continue()
+    endif()
+
+    if(NOT sub IN_LIST subsystems)
+        list(APPEND subsystems ${sub})
+        set(text_${sub} 0)
+        set(data_${sub} 0)
+        set(bss_${sub} 0)
+    endif()
+    math(EXPR text_${sub} "${text_${sub}} + ${CMAKE_MATCH_1}")
+    math(EXPR data_${sub} "${data_${sub}} + ${CMAKE_MATCH_2}")
+    math(EXPR bss_${sub} "${bss_${sub}} + ${CMAKE_MATCH_3}")
+endforeach()
+
+function(pad_right out value width)
+    string(LENGTH "${value}" len)
+    if(len LESS width)
+        math(EXPR n "${width} - ${len}")
+        string(REPEAT " " ${n} spaces)
+    endif()
+    set(${out} "${value}${spaces}" PARENT_SCOPE)
+endfunction()
+
+list(SORT subsystems)
+set(total_flash 0)
+set(total_ram 0)
+message("STUSB4500 footprint (bytes, before --gc-sections)")
+message("  subsystem     flash     ram")
+foreach(sub IN LISTS subsystems)
+    math(EXPR flash "${text_${sub}} + ${data_${sub}}")
+    math(EXPR ram "${data_${sub}} + ${bss_${sub}}")
+    math(EXPR total_flash "${total_flash} + ${flash}")
+    math(EXPR total_ram "${total_ram} + ${ram}")
+    pad_right(c1 "${sub}" 14)
+    pad_right(c2 "${flash}" 10)
+    message("  ${c1}${c2}${ram}")
+endforeach()
+pad_right(c2 "${total_flash}" 10)
+message("  total         ${c2}${total_ram}")
@@ -1,8 +1,14 @@
 #pragma once
+#include <array>
+#include <cstdint>
+
 #include "config/stusb4500-config_types.hpp"
 
 namespace stusb4500
 {
     ConfigParams load_config_from_kconfig();
 
+    /// Image NVM de 40 octets encodée à la compilation depuis la configuration Kconfig
+    const std::array<uint8_t, 40> &kconfig_nvm_image();
+
 } // namespace stusb4500
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_err.h"
+
+#include "stusb4500-interface.hpp"
+#include "config/stusb4500-config_types.hpp"
+
+namespace stusb4500
+{
+    /// Écriture en rafale d'un bloc de registres contigus
+    struct RegisterWrite
+    {
+        uint8_t reg = 0;
+        uint8_t len = 0;
+        std::array<uint8_t, 12> data{};
+    };
+
+    /**
+     * @brief Différence minimale entre deux ConfigParams, appliquée en registres volatils.
+     *
+     * compute() ne retient que ce qui change : masque d'alerte (0x0C), plage
+     * contiguë des PDO sink modifiés (0x85-0x90) et nombre de PDO (0x70), dans
+     * cet ordre. Les champs sans registre volatil (décharge, GPIO, POWER_OK,
+     * courant flex, seuils VBUS...) ne peuvent changer que par la NVM :
+     * needs_nvm() le signale sans rien programmer.
+     */
+    class ConfigPatch : public INTERFACE
+    {
+    public:
+        static constexpr size_t MAX_WRITES = 3;
+
+        explicit ConfigPatch(I2CDevices &dev) : INTERFACE(dev) {}
+
+        /// Relit les registres volatils concernés et complète `current` (reste inchangé)
+        esp_err_t read_current(ConfigParams &current);
+
+        void compute(const ConfigParams &current, const ConfigParams &target);
+
+        /// État obtenu en appliquant à `current` la seule part volatile de `target`
+        static ConfigParams reachable(const ConfigParams &current, const ConfigParams &target);
+
+        /// Écrit les blocs calculés ; le soft reset éventuel reste à la charge de l'appelant
+        esp_err_t apply();
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        const RegisterWrite &operator[](size_t i) const { return writes_[i]; }
+
+        /// La table des PDO change : une renégociation est nécessaire pour en profiter
+        bool needs_renegotiation() const { return renegotiate_; }
+
+        /// La cible comporte des champs que seule la programmation NVM peut appliquer
+        bool needs_nvm() const { return nvm_; }
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        inline static const char *TAG = "STUSB4500-CONFIG_PATCH";
+
+        void add(uint8_t reg, const uint8_t *data, uint8_t len);
+
+        std::array<RegisterWrite, MAX_WRITES> writes_{};
+        size_t count_ = 0;
+        bool renegotiate_ = false;
+        bool nvm_ = false;
+        bool valid_ = true;
+    };
+
+} // namespace stusb4500
@@ -2,6 +2,7 @@
 #include <cstdint>
 
 #include "stusb4500-common_types.hpp"
+#include "stusb4500-fields.hpp"
 
 namespace stusb4500
 {
@@ -10,6 +11,13 @@ namespace stusb4500
         public:
         uint8_t reg_addr = 0x0C;
 
+        static constexpr Field PORT_STATUS_AL_MASK{"port_status_al_mask", 6};
+        static constexpr Field TYPEC_MONITORING_STATUS_AL_MASK{"typec_monitoring_status_al_mask", 5};
+        static constexpr Field CC_HW_FAULT_STATUS_AL_MASK{"cc_hw_fault_status_al_mask", 4};
+        static constexpr Field PRT_STATUS_AL_MASK{"prt_status_al_mask", 1};
+        static constexpr std::array<Field, 4> fields{PORT_STATUS_AL_MASK, TYPEC_MONITORING_STATUS_AL_MASK,
+                                                     CC_HW_FAULT_STATUS_AL_MASK, PRT_STATUS_AL_MASK};
+
         struct AlertStatus1MaskReg
         {
             bool port_status_al_mask = 1;
@@ -18,9 +26,13 @@ namespace stusb4500
             bool prt_status_al_mask = 1;
         };
 
-        void set_raw(uint8_t raw) { raw_ = raw; }
-        uint8_t get_raw() const { return raw_; }
-        AlertStatus1MaskReg get_values() const;
+        constexpr void set_raw(uint8_t raw) { raw_ = raw; }
+        constexpr uint8_t get_raw() const { return raw_; }
+        constexpr AlertStatus1MaskReg get_values() const
+        {
+            return {PORT_STATUS_AL_MASK.test(raw_), TYPEC_MONITORING_STATUS_AL_MASK.test(raw_),
+                    CC_HW_FAULT_STATUS_AL_MASK.test(raw_), PRT_STATUS_AL_MASK.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -32,7 +44,7 @@ namespace stusb4500
     class ConfigParams
     {
     public:
-        ConfigParams();
+        constexpr ConfigParams() = default;
 
         enum class PowerOkConfig : uint8_t
         {
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "sdkconfig.h"
+
+#if defined(CONFIG_STUSB4500_POLL_FAST_MS)
+#define STUSB4500_POLL_FAST_MS CONFIG_STUSB4500_POLL_FAST_MS
+#define STUSB4500_POLL_SLOW_MS CONFIG_STUSB4500_POLL_SLOW_MS
+#define STUSB4500_POLL_HOLD_MS CONFIG_STUSB4500_POLL_HOLD_MS
+#else
+#define STUSB4500_POLL_FAST_MS 20
+#define STUSB4500_POLL_SLOW_MS 1000
+#define STUSB4500_POLL_HOLD_MS 2000
+#endif
+
+namespace stusb4500
+{
+    /**
+     * @brief Cadence de lecture d'ALERT_STATUS_1 quand la broche ALERT n'est pas câblée.
+     *
+     * Décide seulement (aucun accès I2C). Intervalle court pendant une
+     * négociation et pendant hold_ms après chaque alerte, puis doublé à chaque
+     * lecture sans alerte jusqu'à slow_ms : la tâche reste bloquée entre deux
+     * lectures, ce qui laisse le tickless idle s'appliquer en régime établi.
+     */
+    class AlertPoller
+    {
+    public:
+        struct Settings
+        {
+            uint32_t fast_ms = STUSB4500_POLL_FAST_MS;
+            uint32_t slow_ms = STUSB4500_POLL_SLOW_MS;
+            uint32_t hold_ms = STUSB4500_POLL_HOLD_MS;
+        };
+
+        struct Stats
+        {
+            uint32_t polls = 0;
+            uint32_t alerts = 0;
+            // Fenêtre entre la lecture précédente et celle qui voit l'alerte : borne de la latence
+            uint32_t latency_max_ms = 0;
+            uint64_t latency_sum_ms = 0;
+            int64_t started_us = 0;
+            int64_t last_us = 0;
+
+            /// Latence moyenne estimée (alerte uniformément répartie dans la fenêtre)
+            uint32_t latency_mean_ms() const { return alerts ? static_cast<uint32_t>(latency_sum_ms / alerts / 2) : 0; }
+
+            /// Occupation estimée du bus I2C par le polling, en parties par million
+            uint32_t bus_utilization_ppm(uint32_t bus_hz) const;
+
+            void log() const;
+            std::string to_json() const;
+        };
+
+        AlertPoller() = default;
+        explicit AlertPoller(const Settings &settings) : settings_(settings), interval_ms_(settings.fast_ms) {}
+
+        /// Délai avant la prochaine lecture
+        uint32_t interval_ms() const { return interval_ms_; }
+
+        /// Négociation en cours (watchdog armé) : reste en cadence rapide
+        void keep_fast(int64_t now_us);
+
+        /// Résultat d'une lecture d'ALERT_STATUS_1 ; adapte l'intervalle suivant
+        void on_poll(int64_t now_us, bool alert);
+
+        const Stats &stats() const { return stats_; }
+
+    private:
+        inline static const char *TAG = "STUSB4500-POLLER";
+
+        Settings settings_;
+        uint32_t interval_ms_ = STUSB4500_POLL_FAST_MS;
+        int64_t fast_until_us_ = 0;
+        Stats stats_;
+    };
+
+} // namespace stusb4500
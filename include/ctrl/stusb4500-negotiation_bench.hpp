@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esp_err.h"
+#include "I2CDevices.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Échantillons de latence (µs) à capacité fixe, avec percentiles.
+     */
+    struct LatencySamples
+    {
+        static constexpr size_t MAX_SAMPLES = 64;
+
+        uint32_t samples_us[MAX_SAMPLES] = {0};
+        size_t count = 0;
+        size_t dropped = 0; // mesures au-delà de MAX_SAMPLES, absentes des percentiles
+
+        void add(uint32_t us)
+        {
+            if (count < MAX_SAMPLES)
+                samples_us[count++] = us;
+            else
+                ++dropped;
+        }
+
+        /// Percentile p (0 à 100) par rang le plus proche, 0 si aucun échantillon
+        uint32_t percentile(uint8_t p) const;
+        uint32_t min() const { return percentile(0); }
+        uint32_t max() const { return percentile(100); }
+        uint32_t mean() const;
+
+        void log(const char *name) const;
+        std::string to_json() const;
+    };
+
+    struct NegotiationResult
+    {
+        LatencySamples to_ready; // déclenchement -> PE_SNK_READY (0x29 == 0x18)
+        LatencySamples to_rdo;   // déclenchement -> nouveau RDO relu en 0x91
+        uint16_t iterations = 0;
+        uint16_t timeouts = 0;
+        uint16_t errors = 0;
+        uint16_t rdo_unchanged = 0; // contrat redemandé à l'identique : pas de mesure to_rdo
+
+        void log() const;
+        std::string to_json() const;
+    };
+
+    /**
+     * @brief Mesure le temps de renégociation d'un contrat sur le composant réel.
+     *
+     * Chaque itération appelle trigger (soft reset par défaut, ou reconfigure()),
+     * attend que le policy engine quitte puis retrouve PE_SNK_READY, et date le
+     * premier RDO différent de celui d'avant le déclenchement. Les registres sont
+     * scrutés toutes les poll_ms millisecondes (au moins un tick) en rendant la
+     * main au scheduler : la mesure a la résolution du tick FreeRTOS.
+     */
+    class NegotiationBench
+    {
+    public:
+        using Trigger = std::function<esp_err_t()>;
+
+        explicit NegotiationBench(I2CDevices &dev) : dev_(dev) {}
+
+        esp_err_t run(uint16_t iterations,
+                      NegotiationResult &result,
+                      const Trigger &trigger = nullptr,
+                      uint32_t timeout_ms = 2000,
+                      uint32_t poll_ms = 1);
+
+    private:
+        I2CDevices &dev_;
+        inline static const char *TAG = "STUSB4500-BENCH";
+
+        static constexpr uint8_t PE_SNK_READY = 0x18;
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "sdkconfig.h"
+
+#if defined(CONFIG_STUSB4500_CONTRACT_DEADLINE_MS)
+#define STUSB4500_CONTRACT_DEADLINE_MS CONFIG_STUSB4500_CONTRACT_DEADLINE_MS
+#else
+#define STUSB4500_CONTRACT_DEADLINE_MS 3000
+#endif
+
+namespace stusb4500
+{
+    /**
+     * @brief Surveillance de la négociation et échelle de reprise.
+     *
+     * Décide seulement (aucun accès I2C) : le manager lui signale attachement,
+     * contrat, hard resets reçus et défauts CC, puis exécute l'action rendue par
+     * poll(). Chaque échec fait monter d'un cran (soft reset, hard reset, PDO de
+     * repli 5 V) et double le délai avant la vérification suivante. Port
+     * détaché, hard resets et défauts CC sont comptés sans armer l'échelle.
+     */
+    class NegotiationWatchdog
+    {
+    public:
+        enum class Action : uint8_t
+        {
+            None,
+            SoftReset,
+            HardReset,
+            FallbackPdo,
+        };
+
+        struct Settings
+        {
+            int64_t contract_deadline_us = static_cast<int64_t>(STUSB4500_CONTRACT_DEADLINE_MS) * 1000;
+            int64_t backoff_max_us = 60 * 1000 * 1000;
+            uint8_t hard_reset_limit = 3;                // hard resets reçus tolérés...
+            int64_t hard_reset_window_us = 10 * 1000 * 1000; // ...dans cette fenêtre
+            int64_t failed_action_retry_us = 100 * 1000;     // action non exécutée (erreur bus) : nouvel essai
+        };
+
+        struct Counters
+        {
+            uint32_t soft_resets = 0;
+            uint32_t hard_resets = 0;
+            uint32_t fallbacks = 0;
+            uint32_t hard_resets_received = 0;
+            uint32_t cc_faults = 0;
+            uint32_t deadlines_missed = 0;
+            uint32_t recoveries = 0; // contrat obtenu après au moins une action
+            uint32_t failed_actions = 0; // actions rendues par poll() que le manager n'a pas pu exécuter
+        };
+
+        NegotiationWatchdog() = default;
+        explicit NegotiationWatchdog(const Settings &settings) : settings_(settings) {}
+
+        void on_attach(int64_t now_us);
+        void on_detach();
+        void on_contract();
+        void on_hard_reset_received(int64_t now_us);
+        void on_cc_fault(int64_t now_us);
+
+        /// Action à exécuter maintenant, None si rien n'est dû
+        Action poll(int64_t now_us);
+
+        /// L'action rendue par poll() n'a pas pu être exécutée : même marche rejouée après failed_action_retry_us
+        void on_action_failed(Action action, int64_t now_us);
+
+        /// Délai avant la prochaine échéance (µs), -1 si aucune n'est armée
+        int64_t time_to_deadline(int64_t now_us) const;
+
+        bool armed() const { return armed_; }
+        uint8_t level() const { return level_; }
+        const Counters &counters() const { return counters_; }
+
+        static const char *to_string(Action action);
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        void escalate_now(int64_t now_us);
+        void reset_ladder();
+
+        Settings settings_;
+        Counters counters_;
+
+        bool attached_ = false;
+        bool armed_ = false;
+        uint8_t level_ = 0;        // prochaine marche de l'échelle
+        uint8_t attempts_ = 0;     // actions depuis le dernier attachement ou contrat
+        int64_t deadline_us_ = 0;
+        int64_t hard_reset_window_start_us_ = 0;
+        uint8_t hard_resets_in_window_ = 0;
+    };
+
+} // namespace stusb4500
@@ -1,64 +1,234 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include "config/stusb4500-config_types.hpp"
-#include "pd/stusb4500-pdo.hpp"
+#include "stusb4500-fields.hpp"
 
 namespace stusb4500
 {
-    class Bank
+    constexpr uint16_t encode_voltage_step(uint16_t voltage_mv)
     {
-    public:
-        explicit Bank(ConfigParams &data)
-            : data_(data) {}
-        virtual void decode(const uint8_t *buffer) = 0;
-        virtual void encode(uint8_t *buffer) const = 0;
-        virtual ~Bank() = default;
-    protected:
-    ConfigParams &data_;
+        return voltage_mv / 50;
+    }
+
+    constexpr uint16_t decode_voltage_step(uint16_t step)
+    {
+        return step * 50;
+    }
+
+    constexpr uint16_t encode_current_step(uint16_t current_ma)
+    {
+        return current_ma / 10;
+    }
+
+    constexpr uint16_t decode_current_step(uint16_t step)
+    {
+        return step * 10;
+    }
+
+    inline constexpr uint16_t lup_current_table[16] = {
+        0, 500, 750, 1000,
+        1250, 1500, 1750, 2000,
+        2250, 2500, 2750, 3000,
+        3500, 4000, 4500, 5000
     };
 
-    class Bank0 : public Bank
+    constexpr uint16_t decode_lup_current(uint8_t step)
+    {
+        return lup_current_table[step & 0x0F];
+    }
+
+    constexpr uint8_t encode_lup_current(uint16_t current_ma)
+    {
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+            if (lup_current_table[i] == current_ma)
+                return i;
+        }
+
+        return 0x00;
+    }
+
+    /// Vrai si le courant figure dans la table NVM (sinon encode_lup_current() retombe sur 0, courant flex)
+    constexpr bool is_lup_current(uint16_t current_ma)
     {
-    public:
-        explicit Bank0(ConfigParams &data) : Bank(data) {}
+        for (uint16_t entry : lup_current_table)
+        {
+            if (entry == current_ma)
+                return true;
+        }
+        return false;
+    }
 
-        void decode(const uint8_t * /*buffer*/) override {}
-        void encode(uint8_t * /*buffer*/) const override {}
+    /// Vrai si la tension est représentable sans troncature (pas de 50 mV)
+    constexpr bool is_voltage_step(uint16_t voltage_mv)
+    {
+        return decode_voltage_step(encode_voltage_step(voltage_mv)) == voltage_mv;
+    }
+
+    /**
+     * Chaque banc NVM (secteur de 8 octets) est un type sans état exposant
+     * decode()/encode() statiques : la disposition complète est résolue à la
+     * compilation par NVMLayout, sans vtable ni référence stockée.
+     */
+    template <std::size_t Index>
+    struct Bank
+    {
+        static constexpr std::size_t index = Index;
+        static constexpr std::size_t offset = Index * 8;
     };
 
-    class Bank1 : public Bank
+    struct Bank0 : Bank<0>
     {
-    public:
-        explicit Bank1(ConfigParams &data) : Bank(data) {}
- 
-        void decode(const uint8_t *buffer) override;
-        void encode(uint8_t *buffer) const override;
+        static constexpr void decode(ConfigParams & /*data*/, const uint8_t * /*buffer*/) {}
+        static constexpr void encode(const ConfigParams & /*data*/, uint8_t * /*buffer*/) {}
     };
 
-    class Bank2 : public Bank
+    struct Bank1 : Bank<1>
     {
-    public:
-        explicit Bank2(ConfigParams &data) : Bank(data) {}
+        static constexpr NvmField GPIO_CFG{"gpio_cfg", 4, 2};
+        static constexpr NvmField DISCHARGE_TIME_TO_PDO{"vbus_dchg_mask_time_to_pdo", 16, 4};
+        static constexpr NvmField DISCHARGE_TIME_TO_0V{"discharge_time_to_0v", 20, 4};
 
-        void decode(const uint8_t * /*buffer*/) override {}
-        void encode(uint8_t * /*buffer*/) const override {}
+        static constexpr void decode(ConfigParams &data, const uint8_t *buffer)
+        {
+            const uint64_t raw = load_le64(buffer);
+            data.gpio_function = static_cast<ConfigParams::GPIOFunction>(GPIO_CFG.decode(raw));
+            data.discharge_.time_to_pdo = DISCHARGE_TIME_TO_PDO.decode(raw);
+            data.discharge_.time_to_0v = DISCHARGE_TIME_TO_0V.decode(raw);
+        }
+
+        static constexpr void encode(const ConfigParams &data, uint8_t *buffer)
+        {
+            uint64_t raw = load_le64(buffer);
+            raw = GPIO_CFG.encode(raw, static_cast<uint8_t>(data.gpio_function));
+            raw = DISCHARGE_TIME_TO_PDO.encode(raw, data.discharge_.time_to_pdo);
+            raw = DISCHARGE_TIME_TO_0V.encode(raw, data.discharge_.time_to_0v);
+            store_le64(raw, buffer);
+        }
     };
 
-    class Bank3 : public Bank
+    struct Bank2 : Bank<2>
     {
-    public:
-        explicit Bank3(ConfigParams &data) : Bank(data) {}
+        static constexpr void decode(ConfigParams & /*data*/, const uint8_t * /*buffer*/) {}
+        static constexpr void encode(const ConfigParams & /*data*/, uint8_t * /*buffer*/) {}
+    };
+
+    struct Bank3 : Bank<3>
+    {
+        static constexpr NvmField USB_COMM_CAPABLE{"usb_comm_capable", 16};
+        static constexpr NvmField SNK_PDO_NUMB{"snk_pdo_numb", 17, 2};
+        static constexpr NvmField SNK_UNCONS_POWER{"snk_uncons_power", 19};
+        static constexpr NvmField LUT_SNK_PDO1_I{"lut_snk_pdo1_i", 20, 4};
+        static constexpr NvmField SNK_PDO1_LOWER{"snk_pdo1_lower_percent", 24, 4};
+        static constexpr NvmField SNK_PDO1_UPPER{"snk_pdo1_upper_percent", 28, 4};
+        static constexpr NvmField LUT_SNK_PDO2_I{"lut_snk_pdo2_i", 32, 4};
+        static constexpr NvmField SNK_PDO2_LOWER{"snk_pdo2_lower_percent", 36, 4};
+        static constexpr NvmField SNK_PDO2_UPPER{"snk_pdo2_upper_percent", 40, 4};
+        static constexpr NvmField LUT_SNK_PDO3_I{"lut_snk_pdo3_i", 44, 4};
+        static constexpr NvmField SNK_PDO3_LOWER{"snk_pdo3_lower_percent", 48, 4};
+        static constexpr NvmField SNK_PDO3_UPPER{"snk_pdo3_upper_percent", 52, 4};
+
+        static constexpr void decode(ConfigParams &data, const uint8_t *buffer)
+        {
+            auto &power = data.power_;
+            const uint64_t raw = load_le64(buffer);
 
-        void decode(const uint8_t *buffer);
-        void encode(uint8_t *buffer) const;
+            power.usb_comm_capable = USB_COMM_CAPABLE.test(raw);
+            power.pdo_number = SNK_PDO_NUMB.decode(raw);
+            power.unconstrained_power = SNK_UNCONS_POWER.test(raw);
+
+            power.pdos[0].current_ma = decode_lup_current(LUT_SNK_PDO1_I.decode(raw));
+            power.pdos[0].vbus_monitor.lower_percent = SNK_PDO1_LOWER.decode(raw);
+            power.pdos[0].vbus_monitor.upper_percent = SNK_PDO1_UPPER.decode(raw);
+
+            power.pdos[1].current_ma = decode_lup_current(LUT_SNK_PDO2_I.decode(raw));
+            power.pdos[1].vbus_monitor.lower_percent = SNK_PDO2_LOWER.decode(raw);
+            power.pdos[1].vbus_monitor.upper_percent = SNK_PDO2_UPPER.decode(raw);
+
+            power.pdos[2].current_ma = decode_lup_current(LUT_SNK_PDO3_I.decode(raw));
+            power.pdos[2].vbus_monitor.lower_percent = SNK_PDO3_LOWER.decode(raw);
+            power.pdos[2].vbus_monitor.upper_percent = SNK_PDO3_UPPER.decode(raw);
+        }
+
+        static constexpr void encode(const ConfigParams &data, uint8_t *buffer)
+        {
+            const auto &power = data.power_;
+            uint64_t raw = load_le64(buffer);
+
+            raw = USB_COMM_CAPABLE.encode(raw, power.usb_comm_capable);
+            raw = SNK_PDO_NUMB.encode(raw, power.pdo_number);
+            raw = SNK_UNCONS_POWER.encode(raw, power.unconstrained_power);
+
+            raw = LUT_SNK_PDO1_I.encode(raw, encode_lup_current(power.pdos[0].current_ma));
+            raw = SNK_PDO1_LOWER.encode(raw, power.pdos[0].vbus_monitor.lower_percent);
+            raw = SNK_PDO1_UPPER.encode(raw, power.pdos[0].vbus_monitor.upper_percent);
+
+            raw = LUT_SNK_PDO2_I.encode(raw, encode_lup_current(power.pdos[1].current_ma));
+            raw = SNK_PDO2_LOWER.encode(raw, power.pdos[1].vbus_monitor.lower_percent);
+            raw = SNK_PDO2_UPPER.encode(raw, power.pdos[1].vbus_monitor.upper_percent);
+
+            raw = LUT_SNK_PDO3_I.encode(raw, encode_lup_current(power.pdos[2].current_ma));
+            raw = SNK_PDO3_LOWER.encode(raw, power.pdos[2].vbus_monitor.lower_percent);
+            raw = SNK_PDO3_UPPER.encode(raw, power.pdos[2].vbus_monitor.upper_percent);
+
+            store_le64(raw, buffer);
+        }
     };
 
-    class Bank4 : public Bank
+    struct Bank4 : Bank<4>
     {
-    public:
-        explicit Bank4(ConfigParams &data) : Bank(data) {}
+        static constexpr NvmField SNK_PDO2_V{"snk_pdo2_voltage_mv", 6, 10, 50};
+        static constexpr NvmField SNK_PDO3_V{"snk_pdo3_voltage_mv", 16, 10, 50};
+        static constexpr NvmField I_SNK_PDO_FLEX{"i_snk_pdo_flex_ma", 26, 10, 10};
+        static constexpr NvmField POWER_OK_CFG{"power_ok_cfg", 37, 2};
+        static constexpr NvmField REQ_SRC_CURRENT{"req_src_current", 52};
+        static constexpr NvmField ALERT_STATUS_1_MASK{"alert_status_1_mask", 56, 8};
+
+        static constexpr void decode(ConfigParams &data, const uint8_t *buffer)
+        {
+            auto &power = data.power_;
+            const uint64_t raw = load_le64(buffer);
 
-        void decode(const uint8_t *buffer);
-        void encode(uint8_t *buffer) const;
+            power.pdos[1].voltage_mv = SNK_PDO2_V.decode(raw);
+            power.pdos[2].voltage_mv = SNK_PDO3_V.decode(raw);
+            power.flex_current_ma = I_SNK_PDO_FLEX.decode(raw);
+            data.power_ok = static_cast<ConfigParams::PowerOkConfig>(POWER_OK_CFG.decode(raw));
+            data.req_src_current = REQ_SRC_CURRENT.test(raw);
+            data.alert_mask.set_raw(ALERT_STATUS_1_MASK.decode(raw));
+        }
+
+        // Le masque d'alerte est lu mais n'est pas reprogrammé (comportement historique)
+        static constexpr void encode(const ConfigParams &data, uint8_t *buffer)
+        {
+            const auto &power = data.power_;
+            uint64_t raw = load_le64(buffer);
+
+            raw = SNK_PDO2_V.encode(raw, power.pdos[1].voltage_mv);
+            raw = SNK_PDO3_V.encode(raw, power.pdos[2].voltage_mv);
+            raw = I_SNK_PDO_FLEX.encode(raw, power.flex_current_ma);
+            raw = POWER_OK_CFG.encode(raw, static_cast<uint8_t>(data.power_ok));
+            raw = REQ_SRC_CURRENT.encode(raw, data.req_src_current);
+
+            store_le64(raw, buffer);
+        }
     };
-};
\ No newline at end of file
+
+    template <typename... Banks>
+    struct BankLayout
+    {
+        static constexpr std::size_t size = sizeof...(Banks) * 8;
+
+        static constexpr void decode(ConfigParams &data, const uint8_t *buffer)
+        {
+            (Banks::decode(data, buffer + Banks::offset), ...);
+        }
+
+        static constexpr void encode(const ConfigParams &data, uint8_t *buffer)
+        {
+            (Banks::encode(data, buffer + Banks::offset), ...);
+        }
+    };
+
+    using NVMLayout = BankLayout<Bank0, Bank1, Bank2, Bank3, Bank4>;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include <array>
 #include <cstdint>
 
 #include "stusb4500-interface.hpp"
@@ -17,12 +18,25 @@ namespace stusb4500
 
         esp_err_t write(const NVMData &nvm);
 
+        /// Programme une image complète (ex. kconfig_nvm_image()) puis vérifie la relecture
+        esp_err_t write(const std::array<uint8_t, 40> &image);
+
     private:
         inline static const char *TAG = "STUSB4500-NVM";
 
         esp_err_t write_ctrl0(uint8_t flags);
         esp_err_t write_ctrl1(uint8_t flags);
 
+        esp_err_t read_sectors(uint8_t *full_buffer);
+        esp_err_t program(const uint8_t *raw_nvm);
+
+        /// Quitte le mode test FTP et efface la clé (fin normale de séquence)
+        esp_err_t leave_ftp();
+
+        /// Après une séquence interrompue : leave_ftp() au plus RECOVERY_ATTEMPTS fois, durée comptée dans Metrics
+        void recover();
+        static constexpr int RECOVERY_ATTEMPTS = 3;
+
 
         // Adresses des registres de contrôle
         static constexpr uint8_t REG_FTP_KEY = 0x95;
@@ -49,6 +63,7 @@ namespace stusb4500
 
         // Clé FTP pour activer les accès NVM
         static constexpr uint8_t FTP_CUST_PASSWORD = 0x47;
+        static constexpr uint8_t FTP_KEY_LOCK = 0x00;
 
         // Taille des secteurs NVM
         static constexpr uint8_t NVM_SECTOR_SIZE = 8;
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <array>
+#include <tuple>
 #include <cstring>
 
 #include "nvm/stusb4500-banks.hpp"
@@ -12,27 +13,32 @@ namespace stusb4500
     class NVMData
     {
     public:
-        Bank0 bank0;
-        Bank1 bank1;
-        Bank2 bank2;
-        Bank3 bank3;
-        Bank4 bank4;
-
         explicit NVMData(ConfigParams &data)
-            : bank0(data),
-              bank1(data),
-              bank2(data),
-              bank3(data),
-              bank4(data)
+            : data_(data)
         {}
 
-        static const std::array<uint8_t, 40> default_nvm_map;
+        static constexpr std::array<uint8_t, 40> default_nvm_map = {
+            0x00, 0x00, 0xB0, 0xAA, 0x00, 0x45, 0x00, 0x00,
+            0x10, 0x40, 0x9C, 0x1C, 0xFF, 0x01, 0x3C, 0xDF,
+            0x02, 0x40, 0x0F, 0x00, 0x32, 0x00, 0xFC, 0xF1,
+            0x00, 0x19, 0x56, 0xAF, 0xF5, 0x35, 0x5F, 0x00,
+            0x00, 0x4B, 0x90, 0x21, 0x43, 0x00, 0x40, 0xFB};
+
+        static_assert(NVMLayout::size == default_nvm_map.size(), "NVM layout must cover the 5 banks");
+
+        /// Image NVM complète calculable à la compilation
+        static constexpr std::array<uint8_t, 40> encode_image(const ConfigParams &data)
+        {
+            std::array<uint8_t, 40> result = default_nvm_map;
+            NVMLayout::encode(data, result.data());
+            return result;
+        }
 
-        void decode(const uint8_t *buffer);
+        void decode(const uint8_t *buffer) { NVMLayout::decode(data_, buffer); }
 
-        void encode(uint8_t *buffer) const;
+        void encode(uint8_t *buffer) const { NVMLayout::encode(data_, buffer); }
 
-        std::array<uint8_t, 40> to_array() const;
+        std::array<uint8_t, 40> to_array() const { return encode_image(data_); }
 
         bool equals(const std::array<uint8_t, 40> &other) const;
 
@@ -42,6 +48,7 @@ namespace stusb4500
 
         void log() const;
         private:
+                ConfigParams &data_;
                 inline static const char *TAG = "STUSB4500-NVMDATA";
     };
 } // namespace stusb4500
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "stusb4500-common_types.hpp"
+#include "pd/stusb4500-policy.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+
+#if defined(CONFIG_STUSB4500_CHARGER_CACHE_SIZE)
+#define STUSB4500_CHARGER_CACHE_SIZE CONFIG_STUSB4500_CHARGER_CACHE_SIZE
+#else
+#define STUSB4500_CHARGER_CACHE_SIZE 0
+#endif
+
+namespace stusb4500
+{
+    class KeyValueStore;
+
+    /**
+     * @brief Chargeur connu : table de PDO sink retenue et dernier contrat obtenu.
+     */
+    struct ChargerEntry
+    {
+        uint32_t fingerprint = 0; // FNV-1a des data objects Source_Capabilities, 0 = libre
+        uint32_t last_used = 0;   // Horloge LRU
+        std::array<uint32_t, 3> sink_pdos{}; // PDO sink encodés (0x85-0x90)
+        uint8_t pdo_number = 0;
+        uint32_t rdo = 0;         // Dernier RDO accepté (0x91)
+
+        bool used() const { return fingerprint != 0; }
+        void to_profile(PowerProfile &power) const;
+    };
+
+    /**
+     * @brief Cache LRU des chargeurs rencontrés, persistable dans un KeyValueStore.
+     *
+     * Les tables retenues ne valent que pour la configuration sous laquelle
+     * elles ont été choisies : le contexte (empreinte de cette configuration)
+     * est sauvegardé avec les entrées, et tout changement de contexte vide le cache.
+     */
+    class ChargerCache
+    {
+    public:
+        static constexpr std::size_t CAPACITY = STUSB4500_CHARGER_CACHE_SIZE;
+
+        /// FNV-1a 32 bits sur les data objects en little-endian (jamais 0)
+        static uint32_t fingerprint(const uint32_t *objects, std::size_t count);
+        static uint32_t fingerprint(const SourceCapabilities &caps);
+
+        /// Entrée du chargeur, rafraîchie dans l'ordre LRU ; nullptr si inconnu
+        const ChargerEntry *find(uint32_t fingerprint);
+
+        /// Entrée utilisée le plus récemment, sans la rafraîchir ; nullptr si le cache est vide
+        const ChargerEntry *most_recent() const;
+
+        /// Mémorise la table et le contrat du chargeur ; retourne true si le contenu a changé
+        bool remember(uint32_t fingerprint, const PowerProfile &power, uint32_t rdo);
+
+        /// Oublie le chargeur (table devenue obsolète) ; retourne false s'il était inconnu
+        bool forget(uint32_t fingerprint);
+
+        /// Empreinte de la table sink configurée (Kconfig/NVM, profil ou table imposée) et du profil de charge
+        /// de la politique (nullptr si elle est inactive), jamais 0
+        static uint32_t context_of(const PowerProfile &configured, const LoadProfile *load = nullptr);
+
+        /// Contexte courant ; s'il diffère du précédent, toutes les entrées sont oubliées. Retourne true dans ce cas
+        bool set_context(uint32_t context);
+        uint32_t context() const { return context_; }
+
+        void clear();
+        std::size_t size() const;
+        bool dirty() const { return dirty_; }
+
+        /// ESP_ERR_INVALID_VERSION / ESP_ERR_INVALID_SIZE si le blob stocké est incompatible : le cache reste inchangé.
+        /// Entrées d'un autre contexte que le contexte courant : ignorées, cache vidé
+        esp_err_t load(KeyValueStore &store);
+        esp_err_t save(KeyValueStore &store);
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        static constexpr std::size_t STORAGE = CAPACITY ? CAPACITY : 1;
+        static constexpr const char *STORE_KEY = "chg_cache";
+        static constexpr uint8_t STORE_VERSION = 2;
+
+        std::array<ChargerEntry, STORAGE> entries_{};
+        uint32_t clock_ = 0;
+        uint32_t context_ = 0; // 0 : pas encore connu, le contexte stocké est repris au chargement
+        bool dirty_ = false;
+    };
+
+} // namespace stusb4500
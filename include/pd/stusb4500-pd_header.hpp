@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "stusb4500-fields.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Champs du header de message PD (16 bits), partagés par RXDatas et MessageTrace.
+     *
+     * Message Type sur 5 bits (PD 3.x) : les types ≥ 0x10 ne doivent pas être
+     * confondus avec leur équivalent sur 4 bits (ex. 0x11 n'est pas Source_Capabilities).
+     */
+    struct PDHeader
+    {
+        static constexpr Field MESSAGE_TYPE{"message_type", 0, 5};
+        static constexpr Field NUM_OBJECTS{"num_objects", 12, 3};
+
+        static constexpr uint8_t message_type(uint16_t header)
+        {
+            return static_cast<uint8_t>(MESSAGE_TYPE.decode(header));
+        }
+
+        static constexpr uint8_t num_objects(uint16_t header)
+        {
+            return static_cast<uint8_t>(NUM_OBJECTS.decode(header));
+        }
+    };
+
+} // namespace stusb4500
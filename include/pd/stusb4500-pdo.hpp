@@ -26,4 +26,32 @@ namespace stusb4500
         static constexpr uint8_t reg_len = 4;
 
     };
+
+    /**
+     * @brief Table complète des PDO sink (0x85-0x90) et DPM_PDO_NUMB (0x70).
+     *
+     * write() envoie les trois PDO en une seule rafale de 12 octets puis le
+     * nombre de PDO valides : deux transactions au lieu de quatre.
+     */
+    class PDOTable : public INTERFACE
+    {
+    public:
+        explicit PDOTable(I2CDevices &dev, const PowerProfile &power = {})
+            : INTERFACE(dev), power_(power) {}
+
+        esp_err_t read();
+        esp_err_t write(bool verify = false);
+
+        PowerProfile &power() { return power_; }
+        const PowerProfile &power() const { return power_; }
+
+        static constexpr uint8_t base_reg_addr = 0x85;
+        static constexpr uint8_t pdo_len = 4;
+        static constexpr uint8_t table_len = 3 * pdo_len;
+        static constexpr uint8_t pdo_number_reg = 0x70;
+
+    private:
+        inline static const char *TAG = "STUSB4500-PDO_TABLE";
+        PowerProfile power_;
+    };
 };
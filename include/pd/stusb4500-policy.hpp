@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "stusb4500-common_types.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Besoins déclarés de la charge, utilisés pour choisir les PDO sink.
+     */
+    struct LoadProfile
+    {
+        enum class Preference : uint8_t
+        {
+            MaxPower,       // puissance maximale, puis tension la plus basse
+            LowestVoltage,  // tension la plus basse couvrant required_power_mw
+            HighestVoltage, // tension la plus haute dans la plage
+        };
+
+        uint16_t min_voltage_mv = 5000;
+        uint16_t max_voltage_mv = 20000;
+        uint32_t required_power_mw = 0;
+        uint16_t max_current_ma = 3000; // limite câble / carte
+        Preference preference = Preference::MaxPower;
+    };
+
+    /**
+     * @brief Jeu de PDO sink calculé pour un Source_Capabilities donné.
+     *
+     * pdos[0] reste le PDO1 5 V imposé par le STUSB4500 ; le meilleur choix est
+     * placé dans le PDO de plus haut index, que le composant évalue en premier.
+     */
+    struct SinkPlan
+    {
+        std::array<PDObjectProfile, 3> pdos{};
+        uint8_t pdo_number = 1;
+        uint8_t source_position = 0; // position du PDO source visé (1 à 7), 0 si aucun
+        uint32_t expected_power_mw = 0;
+        bool meets_requirement = false;
+
+        bool same_pdos(const PowerProfile &power) const;
+
+        void log() const;
+        std::string to_json() const;
+    };
+
+    /**
+     * @brief Sélection du meilleur contrat : fonction pure, sans accès I2C.
+     *
+     * Seuls les PDO fixes de la source sont retenus, le STUSB4500 ne sachant pas
+     * demander de contrat PPS/AVS.
+     */
+    class ContractPolicy
+    {
+    public:
+        static SinkPlan select(const SourceCapabilities &caps,
+                               const LoadProfile &load,
+                               const PDObjectProfile &pdo1 = {});
+
+    private:
+        static bool better(const SourcePDO &a, uint32_t power_a,
+                           const SourcePDO &b, uint32_t power_b,
+                           const LoadProfile &load);
+    };
+
+} // namespace stusb4500
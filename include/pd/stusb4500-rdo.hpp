@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <string>
 
 #include "esp_err.h"
 #include "stusb4500-interface.hpp"
+#include "stusb4500-fields.hpp"
 
 namespace stusb4500
 {
@@ -13,21 +16,33 @@ namespace stusb4500
     public:
         explicit RDO(I2CDevices &dev) : INTERFACE(dev) {}
 
+        static constexpr Field OBJ_POSITION{"obj_position", 28, 3};
+        static constexpr Field GIVEBACK{"giveback", 27};
+        static constexpr Field CAPABILITY_MISMATCH{"capability_mismatch", 26};
+        static constexpr Field USB_COMM_CAPABLE{"usb_comm_capable", 25};
+        static constexpr Field NO_USB_SUSPEND{"no_usb_suspend", 24};
+        static constexpr Field UNCHUNKED_EXT{"unchunked_ext", 23};
+        static constexpr Field OPERATING_CURRENT{"operating_ma", 10, 10, 10};
+        static constexpr Field MAX_OPERATING_CURRENT{"max_operating_ma", 0, 10, 10};
+        static constexpr std::array<Field, 8> fields{OBJ_POSITION, GIVEBACK, CAPABILITY_MISMATCH, USB_COMM_CAPABLE,
+                                                     NO_USB_SUSPEND, UNCHUNKED_EXT, OPERATING_CURRENT, MAX_OPERATING_CURRENT};
+
         esp_err_t read();
         
         void decode(const uint8_t *buf, size_t len);
-        uint32_t encode() const;
-
-        uint8_t obj_position() const;
-        bool giveback() const;
-        bool capability_mismatch() const;
-        bool usb_comm_capable() const;
-        bool no_usb_suspend() const;
-        bool unchunked_ext() const;
-        uint16_t operating_ma() const;
-        uint16_t max_operating_ma() const;
+        uint32_t encode() const { return raw_; }
+
+        uint8_t obj_position() const { return static_cast<uint8_t>(OBJ_POSITION.decode(raw_)); }
+        bool giveback() const { return GIVEBACK.test(raw_); }
+        bool capability_mismatch() const { return CAPABILITY_MISMATCH.test(raw_); }
+        bool usb_comm_capable() const { return USB_COMM_CAPABLE.test(raw_); }
+        bool no_usb_suspend() const { return NO_USB_SUSPEND.test(raw_); }
+        bool unchunked_ext() const { return UNCHUNKED_EXT.test(raw_); }
+        uint16_t operating_ma() const { return static_cast<uint16_t>(OPERATING_CURRENT.decode(raw_)); }
+        uint16_t max_operating_ma() const { return static_cast<uint16_t>(MAX_OPERATING_CURRENT.decode(raw_)); }
         
         void log() const;
+        std::string to_json() const;
 
     private:
         inline static const char *TAG = "STUSB4500-RDO";
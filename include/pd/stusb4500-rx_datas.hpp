@@ -2,7 +2,9 @@
 
 #include <cstdint>
 #include "stusb4500-interface.hpp"
+#include "pd/stusb4500-pd_header.hpp"
 #include "pd/stusb4500-pdo.hpp"
+#include "pd/stusb4500-source_caps.hpp"
 
 namespace stusb4500 {
 
@@ -10,7 +12,12 @@ class RXDatas : public INTERFACE {
 public:
     explicit RXDatas(I2CDevices& dev) : INTERFACE(dev) {}
 
-    esp_err_t read();
+    /**
+     * Lecture en deux temps : header (2 octets) puis uniquement les
+     * num_objects() * 4 octets annoncés. Si expected_objects >= 0, une seule
+     * rafale de cette taille est tentée et complétée si le header en annonce plus.
+     */
+    esp_err_t read(int expected_objects = -1);
 
     void decode(const uint8_t* buf, size_t len);
 
@@ -20,17 +27,33 @@ public:
     bool is_data_message() const;
     bool is_control_message() const;
 
+    /// Message de données Source_Capabilities (type 1)
+    static constexpr uint8_t SOURCE_CAPABILITIES = 0x01;
+
+    bool is_source_capabilities() const;
+    uint32_t data_object(size_t index) const;
+
+    /// Décode les PDO si le message reçu est un Source_Capabilities, sinon retourne false
+    bool source_capabilities(SourceCapabilities& out) const;
+
+    /// Lecture au format PDO fixe uniquement, préférer source_capabilities()
     PowerProfile get_pdo(size_t index) const;
 
     void log() const;
 
+    /// Octets non transférés par rapport à une lecture complète de la fenêtre de 30 octets
+    static uint32_t bytes_saved() { return Metrics::instance().rx_bytes_saved(); }
+
 private:
     inline static const char *TAG = "STUSB4500-RXDATAS";
     uint32_t data_[7] = {0};
     uint16_t header_ = 0;
+    uint8_t objects_ = 0;
 
     static constexpr uint8_t reg_addr = 0x31;
     static constexpr uint8_t reg_len = 30;
+    static constexpr uint8_t header_len = 2;
+    static constexpr uint8_t object_len = 4;
 };
 
 }
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "stusb4500-fields.hpp"
+
+namespace stusb4500
+{
+    enum class SourcePDOType : uint8_t
+    {
+        Fixed,
+        Battery,
+        Variable,
+        PPS,     // APDO SPR Programmable Power Supply
+        EPR_AVS, // APDO EPR Adjustable Voltage Supply
+        SPR_AVS, // APDO SPR Adjustable Voltage Supply
+        Unknown
+    };
+
+    /**
+     * @brief Data object d'un message Source_Capabilities, classé par type.
+     *
+     * Les tensions sont en mV, les courants en mA et la puissance en mW quel que
+     * soit le type : un PDO fixe a min_voltage_mv == max_voltage_mv, un PDO
+     * batterie n'annonce qu'une puissance (max_current_ma est déduit à Vmin).
+     */
+    struct SourcePDO
+    {
+        // Bits communs
+        static constexpr Field TYPE{"type", 30, 2};
+        static constexpr Field APDO_TYPE{"apdo_type", 28, 2};
+
+        // Fixed supply
+        static constexpr Field FIXED_DUAL_ROLE_POWER{"dual_role_power", 29};
+        static constexpr Field FIXED_USB_SUSPEND{"usb_suspend_supported", 28};
+        static constexpr Field FIXED_UNCONSTRAINED_POWER{"unconstrained_power", 27};
+        static constexpr Field FIXED_USB_COMM_CAPABLE{"usb_comm_capable", 26};
+        static constexpr Field FIXED_DUAL_ROLE_DATA{"dual_role_data", 25};
+        static constexpr Field FIXED_UNCHUNKED_EXT{"unchunked_ext", 24};
+        static constexpr Field FIXED_EPR_CAPABLE{"epr_capable", 23};
+        static constexpr Field FIXED_PEAK_CURRENT{"peak_current", 20, 2};
+        static constexpr Field FIXED_VOLTAGE{"voltage_mv", 10, 10, 50};
+        static constexpr Field FIXED_MAX_CURRENT{"max_current_ma", 0, 10, 10};
+
+        // Battery / Variable supply
+        static constexpr Field RANGE_MAX_VOLTAGE{"max_voltage_mv", 20, 10, 50};
+        static constexpr Field RANGE_MIN_VOLTAGE{"min_voltage_mv", 10, 10, 50};
+        static constexpr Field BATTERY_MAX_POWER{"max_power_mw", 0, 10, 250};
+        static constexpr Field VARIABLE_MAX_CURRENT{"max_current_ma", 0, 10, 10};
+
+        // APDO
+        static constexpr Field PPS_POWER_LIMITED{"pps_power_limited", 27};
+        static constexpr Field PPS_MAX_VOLTAGE{"max_voltage_mv", 17, 8, 100};
+        static constexpr Field PPS_MIN_VOLTAGE{"min_voltage_mv", 8, 8, 100};
+        static constexpr Field PPS_MAX_CURRENT{"max_current_ma", 0, 7, 50};
+        static constexpr Field EPR_AVS_MAX_VOLTAGE{"max_voltage_mv", 17, 9, 100};
+        static constexpr Field AVS_MIN_VOLTAGE{"min_voltage_mv", 8, 8, 100};
+        static constexpr Field EPR_AVS_PDP{"pdp_w", 0, 8};
+        static constexpr Field SPR_AVS_MAX_CURRENT_15V{"max_current_15v_ma", 10, 10, 10};
+        static constexpr Field SPR_AVS_MAX_CURRENT_20V{"max_current_20v_ma", 0, 10, 10};
+
+        uint32_t raw = 0;
+        SourcePDOType type = SourcePDOType::Unknown;
+        uint16_t min_voltage_mv = 0;
+        uint16_t max_voltage_mv = 0;
+        uint16_t max_current_ma = 0;
+        uint32_t max_power_mw = 0;
+
+        // Drapeaux (PDO fixe, significatifs surtout sur vSafe5V en position 1)
+        bool dual_role_power = false;
+        bool usb_suspend_supported = false;
+        bool unconstrained_power = false;
+        bool usb_comm_capable = false;
+        bool dual_role_data = false;
+        bool unchunked_ext = false;
+        bool epr_capable = false;
+        uint8_t peak_current = 0;
+        bool pps_power_limited = false;
+
+        static SourcePDO decode(uint32_t raw);
+
+        /// Vrai si une tension v (mV) peut être fournie par ce PDO
+        bool covers(uint16_t voltage_mv) const { return voltage_mv >= min_voltage_mv && voltage_mv <= max_voltage_mv; }
+
+        static const char *to_string(SourcePDOType type);
+
+        void log() const;
+        std::string to_json() const;
+    };
+
+    /**
+     * @brief Contenu d'un message Source_Capabilities (jusqu'à 7 objets, stockés sans allocation).
+     */
+    class SourceCapabilities
+    {
+    public:
+        static constexpr std::size_t MAX_OBJECTS = 7;
+
+        void decode(const uint32_t *objects, std::size_t count);
+        void clear() { count_ = 0; }
+
+        std::size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        const SourcePDO &operator[](std::size_t index) const { return pdos_[index]; }
+        const SourcePDO *begin() const { return pdos_.data(); }
+        const SourcePDO *end() const { return pdos_.data() + count_; }
+
+        /// PDO désigné par une position d'objet de RDO (1 à 7), nullptr si hors limites
+        const SourcePDO *at_position(uint8_t position) const;
+
+        /// Puissance maximale annoncée par la source, tous PDO confondus (mW)
+        uint32_t max_power_mw() const;
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        std::array<SourcePDO, MAX_OBJECTS> pdos_{};
+        uint8_t count_ = 0;
+    };
+
+} // namespace stusb4500
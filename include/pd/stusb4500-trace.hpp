@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "pd/stusb4500-pd_header.hpp"
+#include "stusb4500-output.hpp"
+
+namespace stusb4500
+{
+    class RXDatas;
+
+    /**
+     * @brief Message PD reçu, tel que relu dans le buffer RX (0x31).
+     */
+    struct TraceRecord
+    {
+        int64_t timestamp_us = 0;
+        uint16_t header = 0;
+        uint8_t pe_state = 0;   // 0x29 au moment de la lecture
+        uint8_t num_objects = 0;
+        uint32_t objects[7] = {0};
+
+        uint8_t message_type() const { return PDHeader::message_type(header); }
+    };
+
+    /**
+     * @brief Journal circulaire des messages PD reçus (STUSB4500_TRACE_DEPTH entrées).
+     *
+     * record() ne fait qu'une copie de 40 octets sous section critique ; les
+     * entrées les plus anciennes sont écrasées. dump() produit une image binaire
+     * décodable sur PC avec tools/stusb4500_trace.py.
+     */
+    class MessageTrace
+    {
+    public:
+        static constexpr std::size_t CAPACITY = STUSB4500_TRACE_DEPTH;
+
+        // Format binaire : en-tête de 8 octets puis count * RECORD_SIZE octets, little-endian
+        static constexpr uint32_t DUMP_MAGIC = 0x52544450; // "PDTR"
+        static constexpr uint8_t DUMP_VERSION = 1;
+        static constexpr std::size_t DUMP_HEADER_SIZE = 8;
+        static constexpr std::size_t RECORD_SIZE = 8 + 2 + 1 + 1 + 7 * 4;
+
+        void record(const RXDatas &rx, uint8_t pe_state, int64_t timestamp_us);
+        void clear();
+
+        std::size_t size() const;
+        /// Entrées écrasées depuis le dernier clear()
+        uint32_t dropped() const;
+
+        /// Entrée i, 0 étant la plus ancienne ; false si i >= size()
+        bool at(std::size_t index, TraceRecord &out) const;
+
+        /// Taille nécessaire à dump() pour le contenu actuel
+        std::size_t dump_size() const { return DUMP_HEADER_SIZE + size() * RECORD_SIZE; }
+        /// Image binaire du journal, retourne le nombre d'octets écrits (0 si out trop petit)
+        std::size_t dump(uint8_t *out, std::size_t len) const;
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        static constexpr std::size_t STORAGE = CAPACITY ? CAPACITY : 1;
+
+        std::array<TraceRecord, STORAGE> records_{};
+        std::size_t head_ = 0; // prochaine position d'écriture
+        std::size_t count_ = 0;
+        uint32_t dropped_ = 0;
+        mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+
+#include "status/stusb4500-snapshot.hpp"
+
+namespace stusb4500
+{
+    /// Familles d'alertes masquables ; la valeur est le bit commun à ALERT_STATUS_1 et à son masque (0x0C)
+    enum class AlertClass : uint8_t
+    {
+        PortStatus = 1 << 6,
+        TypeCMonitoring = 1 << 5,
+        CCHwFault = 1 << 4,
+        PRTStatus = 1 << 1,
+    };
+
+    constexpr uint8_t operator|(AlertClass a, AlertClass b) { return static_cast<uint8_t>(a) | static_cast<uint8_t>(b); }
+    constexpr uint8_t operator|(uint8_t a, AlertClass b) { return a | static_cast<uint8_t>(b); }
+
+    /// Appelé depuis la tâche du driver après traitement de l'alerte, snapshot à jour
+    using AlertHandler = void (*)(AlertClass alert, const StatusSnapshot &snapshot, void *ctx);
+
+    /**
+     * @brief Abonnements aux alertes et masque ALERT_STATUS_1_MASK qui en découle.
+     *
+     * Une famille n'est démasquée que si le driver lui-même (attachement,
+     * contrat, défauts pour le watchdog) ou au moins un abonné la consomme :
+     * les autres ne réveillent plus la tâche ni ne coûtent de lecture I2C.
+     */
+    class AlertSubscriptions
+    {
+    public:
+        static constexpr size_t CAPACITY = 8;
+        static constexpr uint8_t MASKABLE = AlertClass::PortStatus | AlertClass::TypeCMonitoring |
+                                            AlertClass::CCHwFault | AlertClass::PRTStatus;
+        /// Consommées par le driver : détection d'attachement, suivi du contrat, watchdog
+        static constexpr uint8_t INTERNAL = AlertClass::PortStatus | AlertClass::PRTStatus | AlertClass::CCHwFault;
+
+        /// Retourne un identifiant >= 0, ou -1 si la table est pleine ou la demande invalide
+        int subscribe(uint8_t classes, AlertHandler handler, void *ctx = nullptr);
+        bool unsubscribe(int id);
+
+        /// Union des familles demandées par les abonnés
+        uint8_t subscribed() const;
+
+        /// Masque à écrire : bits hors MASKABLE repris de `base`, familles inutilisées masquées (1)
+        uint8_t mask(uint8_t base) const { return (base | MASKABLE) & ~(subscribed() | INTERNAL); }
+
+        /// Notifie les abonnés des familles présentes dans `alerts`
+        void dispatch(uint8_t alerts, const StatusSnapshot &snapshot) const;
+
+    private:
+        struct Entry
+        {
+            uint8_t classes = 0;
+            AlertHandler handler = nullptr;
+            void *ctx = nullptr;
+        };
+
+        std::array<Entry, CAPACITY> entries_{};
+        mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+} // namespace stusb4500
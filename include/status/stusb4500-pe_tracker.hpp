@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace stusb4500
+{
+    /**
+     * @brief Miroir logiciel du policy engine (PE_FSM, registre 0x29).
+     *
+     * Chaque valeur observée alimente un compteur de passages et de temps par
+     * état, un historique des dernières transitions et la détection des
+     * transitions inattendues ou des états d'attente bloqués. L'état n'étant
+     * lu que sur alerte, les sauts vers l'avant dans la séquence de
+     * négociation (0x12 à 0x19) sont admis.
+     */
+    class PETracker
+    {
+    public:
+        static constexpr std::size_t HISTORY = 16;
+        static constexpr int64_t DEFAULT_STUCK_US = 1000 * 1000;
+
+        // Codes nommés par StateStatusRegister::to_string()
+        static constexpr std::array<uint8_t, 16> STATES{
+            0x00, 0x01, 0x02, 0x03, 0x04,
+            0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+            0x3A, 0x3B, 0x40};
+        static constexpr uint8_t PE_SNK_READY = 0x18;
+
+        struct Transition
+        {
+            int64_t timestamp_us = 0;
+            uint8_t from = 0;
+            uint8_t to = 0;
+            bool legal = true;
+        };
+
+        struct StateStats
+        {
+            uint32_t entries = 0;
+            int64_t total_us = 0;
+            int64_t max_us = 0;
+        };
+
+        explicit PETracker(int64_t stuck_threshold_us = DEFAULT_STUCK_US)
+            : stuck_threshold_us_(stuck_threshold_us) {}
+
+        /// Nouvelle lecture de 0x29 ; retourne false si la transition est inattendue
+        bool observe(uint8_t state, int64_t now_us);
+
+        /// Retourne true (une seule fois par passage) si un état d'attente dépasse le seuil
+        bool check_stuck(int64_t now_us);
+
+        /// Délai avant que l'état d'attente courant soit jugé bloqué (µs), -1 si rien à surveiller
+        int64_t time_to_stuck(int64_t now_us) const;
+
+        static bool is_legal(uint8_t from, uint8_t to);
+        static bool is_wait_state(uint8_t state);
+
+        uint8_t current() const { return current_; }
+        int64_t time_in_current(int64_t now_us) const { return started_ ? now_us - entered_us_ : 0; }
+        uint32_t illegal_transitions() const { return illegal_; }
+        uint32_t stuck_events() const { return stuck_events_; }
+        uint32_t transitions() const { return transitions_; }
+
+        /// Statistiques de l'état (code 0x29), états inconnus regroupés
+        const StateStats &stats(uint8_t state) const { return stats_[index_of(state)]; }
+
+        /// Transition i, 0 étant la plus ancienne encore conservée
+        bool history(std::size_t index, Transition &out) const;
+
+        void reset();
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        static constexpr std::size_t UNKNOWN = STATES.size();
+        static std::size_t index_of(uint8_t state);
+
+        int64_t stuck_threshold_us_;
+        std::array<StateStats, STATES.size() + 1> stats_{};
+        std::array<Transition, HISTORY> history_{};
+        std::size_t history_head_ = 0;
+        std::size_t history_count_ = 0;
+
+        uint8_t current_ = 0;
+        int64_t entered_us_ = 0;
+        bool started_ = false;
+        bool stuck_reported_ = false;
+        uint32_t transitions_ = 0;
+        uint32_t illegal_ = 0;
+        uint32_t stuck_events_ = 0;
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace stusb4500
+{
+    /**
+     * @brief Bilan de puissance du contrat actif et de la session en cours.
+     *
+     * L'énergie est cumulée en mW·µs à chaque changement de contrat ; at(now)
+     * y ajoute la part du contrat en cours sans aucun accès au bus.
+     * Trivialement copiable pour être publiée dans StatusSnapshot.
+     */
+    struct PowerStats
+    {
+        static constexpr uint64_t MW_US_PER_MWH = 3600ull * 1000 * 1000;
+
+        uint16_t contract_voltage_mv = 0;
+        uint16_t contract_current_ma = 0;
+        uint32_t contract_power_mw = 0;
+        int64_t contract_start_us = 0;
+
+        int64_t session_start_us = 0;      // 0 si aucun chargeur attaché
+        uint32_t session_contracts = 0;    // Contrats négociés pendant la session
+        uint32_t sessions = 0;             // Attachements depuis le démarrage
+        uint32_t peak_power_mw = 0;
+        int64_t longest_contract_us = 0;
+
+        uint64_t session_energy_mw_us = 0; // Contrats clos de la session en cours
+        uint64_t total_energy_mw_us = 0;   // Contrats clos depuis le démarrage
+
+        /// Copie incluant l'énergie du contrat en cours jusqu'à now_us
+        PowerStats at(int64_t now_us) const;
+
+        uint32_t session_energy_mwh() const { return static_cast<uint32_t>(session_energy_mw_us / MW_US_PER_MWH); }
+        uint32_t total_energy_mwh() const { return static_cast<uint32_t>(total_energy_mw_us / MW_US_PER_MWH); }
+
+        void log() const;
+        std::string to_json() const;
+    };
+
+    /**
+     * @brief Met à jour PowerStats sur les seuls événements de contrat (RDO, détachement).
+     */
+    class PowerAccounting
+    {
+    public:
+        /// Nouveau contrat (0 mV / 0 mA si aucun), ignoré s'il est identique au contrat actif
+        void on_contract(uint16_t voltage_mv, uint16_t current_ma, int64_t now_us);
+
+        /// Fin de session : clôt le contrat actif
+        void on_detach(int64_t now_us);
+
+        const PowerStats &stats() const { return stats_; }
+
+    private:
+        void close_contract(int64_t now_us);
+
+        PowerStats stats_;
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "status/stusb4500-power_accounting.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Copie figée de l'état USB-C publiée par la tâche du driver.
+     *
+     * Structure trivialement copiable : les autres tâches la lisent via
+     * STUSB4500Manager::read_snapshot() sans accès I2C ni verrou.
+     */
+    struct StatusSnapshot
+    {
+        uint32_t sequence = 0;        // Nombre de publications depuis le démarrage
+        int64_t timestamp_us = 0;     // Horodatage de la dernière publication (esp_timer)
+        int64_t status_timestamp_us = 0;
+        int64_t rdo_timestamp_us = 0;
+
+        // Registres de statut bruts (voir status/stusb4500-status_types.hpp)
+        uint8_t alert_status_1 = 0;            // 0x0B
+        uint8_t port_status_0 = 0;             // 0x0D
+        uint8_t port_status_1 = 0;             // 0x0E
+        uint8_t typec_monitoring_status_0 = 0; // 0x0F
+        uint8_t typec_monitoring_status_1 = 0; // 0x10
+        uint8_t cc_status = 0;                 // 0x11
+        uint8_t cc_hw_fault_0 = 0;             // 0x12
+        uint8_t cc_hw_fault_1 = 0;             // 0x13
+        uint8_t pd_typec_status = 0;           // 0x14
+        uint8_t typec_status = 0;              // 0x15
+        uint8_t prt_status = 0;                // 0x16
+        uint8_t policy_engine_state = 0;       // 0x29
+
+        // Contrat actif
+        uint32_t rdo = 0;                      // 0x91, brut
+        uint8_t active_pdo = 0;                // Position d'objet du RDO, 0 si aucun contrat
+        uint16_t active_voltage_mv = 0;
+        uint16_t active_current_ma = 0;
+
+        // Bilan énergétique arrêté au dernier changement de contrat, voir PowerStats::at()
+        PowerStats power;
+    };
+
+    static_assert(std::is_trivially_copyable<StatusSnapshot>::value, "StatusSnapshot must be trivially copyable");
+
+    /**
+     * @brief Seqlock mono-écrivain / multi-lecteurs pour StatusSnapshot.
+     *
+     * L'écrivain (tâche du driver) rend le compteur impair pendant la copie ;
+     * un lecteur qui observe un compteur impair ou modifié recommence. Les
+     * données sont stockées en mots atomiques pour rester sans course de données.
+     */
+    class SnapshotPublisher
+    {
+    public:
+        void publish(const StatusSnapshot &snapshot);
+
+        /// Retourne false si aucune copie cohérente n'a pu être obtenue en max_attempts essais
+        bool read(StatusSnapshot &out, int max_attempts = 16) const;
+
+    private:
+        static constexpr std::size_t WORDS = (sizeof(StatusSnapshot) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        std::atomic<uint32_t> seq_{0};
+        std::atomic<uint32_t> words_[WORDS] = {};
+    };
+
+} // namespace stusb4500
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <cstdint>
 
 #include "esp_log.h"
+#include "stusb4500-fields.hpp"
 
 namespace stusb4500
 {
@@ -30,6 +32,14 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x0B;
 
+        static constexpr Field PORT_STATUS_AL{"port_status_al", 6};
+        static constexpr Field TYPEC_MONITORING_STATUS_AL{"typec_monitoring_status_al", 5};
+        static constexpr Field CC_HW_FAULT_STATUS_AL{"cc_hw_fault_status_al", 4};
+        static constexpr Field PD_TYPEC_STATUS_AL{"pd_typec_status_al", 3};
+        static constexpr Field PRT_STATUS_AL{"prt_status_al", 1};
+        static constexpr std::array<Field, 5> fields{PORT_STATUS_AL, TYPEC_MONITORING_STATUS_AL,
+                                                     CC_HW_FAULT_STATUS_AL, PD_TYPEC_STATUS_AL, PRT_STATUS_AL};
+
         struct AlertStatus1Reg
         {
             bool port_status_al = 0;
@@ -41,7 +51,11 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        AlertStatus1Reg get_values() const;
+        constexpr AlertStatus1Reg get_values() const
+        {
+            return {PORT_STATUS_AL.test(raw_), TYPEC_MONITORING_STATUS_AL.test(raw_),
+                    CC_HW_FAULT_STATUS_AL.test(raw_), PD_TYPEC_STATUS_AL.test(raw_), PRT_STATUS_AL.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -71,6 +85,11 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x0E;
 
+        static constexpr Field ATTACHED_DEVICE{"attached_device", 5, 3};
+        static constexpr Field POWER_MODE{"power_mode", 4};
+        static constexpr Field DATA_MODE{"data_mode", 3};
+        static constexpr Field ATTACHED{"attached", 0};
+
         struct PortStatus1Reg
         {
             uint8_t raw_attached_device = 0;
@@ -81,7 +100,11 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        PortStatus1Reg get_values() const;
+        constexpr PortStatus1Reg get_values() const
+        {
+            return {static_cast<uint8_t>(ATTACHED_DEVICE.decode(raw_)), POWER_MODE.test(raw_),
+                    DATA_MODE.test(raw_), ATTACHED.test(raw_)};
+        }
 
         static std::string to_string(uint8_t attached_device);
 
@@ -97,6 +120,14 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x0F;
 
+        static constexpr Field VBUS_HIGH_KO{"vbus_high_ko", 5};
+        static constexpr Field VBUS_LOW_KO{"vbus_low_ko", 4};
+        static constexpr Field VBUS_READY_TRANS{"vbus_ready_trans", 3};
+        static constexpr Field VBUS_VSAFE0V_TRANS{"vbus_vsafe0v_trans", 2};
+        static constexpr Field VBUS_VALID_SNK_TRANS{"vbus_valid_snk_trans", 1};
+        static constexpr std::array<Field, 5> fields{VBUS_HIGH_KO, VBUS_LOW_KO, VBUS_READY_TRANS,
+                                                     VBUS_VSAFE0V_TRANS, VBUS_VALID_SNK_TRANS};
+
         struct TypeCMonitoringStatus0Reg
         {
             bool vbus_high_ko = 0;
@@ -108,7 +139,11 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        TypeCMonitoringStatus0Reg get_values() const;
+        constexpr TypeCMonitoringStatus0Reg get_values() const
+        {
+            return {VBUS_HIGH_KO.test(raw_), VBUS_LOW_KO.test(raw_), VBUS_READY_TRANS.test(raw_),
+                    VBUS_VSAFE0V_TRANS.test(raw_), VBUS_VALID_SNK_TRANS.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -122,6 +157,11 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x10;
 
+        static constexpr Field VBUS_READY{"vbus_ready", 3};
+        static constexpr Field VBUS_VSAFE0V{"vbus_vsafe0v", 2};
+        static constexpr Field VBUS_VALID_SNK{"vbus_valid_snk", 1};
+        static constexpr std::array<Field, 3> fields{VBUS_READY, VBUS_VSAFE0V, VBUS_VALID_SNK};
+
         struct TypeCMonitoringStatus1Reg
         {
             bool vbus_ready;
@@ -131,7 +171,10 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        TypeCMonitoringStatus1Reg get_values() const;
+        constexpr TypeCMonitoringStatus1Reg get_values() const
+        {
+            return {VBUS_READY.test(raw_), VBUS_VSAFE0V.test(raw_), VBUS_VALID_SNK.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -144,6 +187,11 @@ namespace stusb4500
     {
         public:
         const uint8_t reg_addr = 0x11;
+        static constexpr Field LOOKING_FOR_CONNECTION{"looking_for_connection", 5};
+        static constexpr Field CONNECT_RESULT{"connect_result", 4};
+        static constexpr Field CC2_STATE{"cc2_state", 2, 2};
+        static constexpr Field CC1_STATE{"cc1_state", 0, 2};
+
         struct CCStatusReg
         {
             bool looking_for_connection;
@@ -154,7 +202,11 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        CCStatusReg get_values() const;
+        constexpr CCStatusReg get_values() const
+        {
+            return {LOOKING_FOR_CONNECTION.test(raw_), CONNECT_RESULT.test(raw_),
+                    static_cast<uint8_t>(CC2_STATE.decode(raw_)), static_cast<uint8_t>(CC1_STATE.decode(raw_))};
+        }
 
         static std::string to_string(uint8_t state);
 
@@ -169,6 +221,10 @@ namespace stusb4500
     {
         public:
         const uint8_t reg_addr = 0x12;
+        static constexpr Field VPU_OVP_FAULT_TRANS{"vpu_ovp_fault_trans", 5};
+        static constexpr Field VPU_VALID_TRANS{"vpu_valid_trans", 4};
+        static constexpr std::array<Field, 2> fields{VPU_OVP_FAULT_TRANS, VPU_VALID_TRANS};
+
         struct CCHwFaultStatus0Reg
         {
             bool vpu_ovp_fault_trans;
@@ -177,7 +233,10 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        CCHwFaultStatus0Reg get_values() const;
+        constexpr CCHwFaultStatus0Reg get_values() const
+        {
+            return {VPU_OVP_FAULT_TRANS.test(raw_), VPU_VALID_TRANS.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -191,6 +250,11 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x13;
 
+        static constexpr Field VPU_OVP_FAULT{"vpu_ovp_fault", 7};
+        static constexpr Field VPU_VALID{"vpu_valid", 6};
+        static constexpr Field VBUS_DISCH_FAULT{"vbus_disch_fault", 4};
+        static constexpr std::array<Field, 3> fields{VPU_OVP_FAULT, VPU_VALID, VBUS_DISCH_FAULT};
+
         struct CCHwFaultStatus1Reg
         {
         bool vpu_ovp_fault;
@@ -200,7 +264,10 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        CCHwFaultStatus1Reg get_values() const;
+        constexpr CCHwFaultStatus1Reg get_values() const
+        {
+            return {VPU_OVP_FAULT.test(raw_), VPU_VALID.test(raw_), VBUS_DISCH_FAULT.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -214,9 +281,11 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x14;
 
+        static constexpr Field PD_TYPEC_HAND_CHECK{"handshake", 0, 4};
+
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        uint8_t get_value() const { return raw_ & 0x0F;};
+        constexpr uint8_t get_value() const { return static_cast<uint8_t>(PD_TYPEC_HAND_CHECK.decode(raw_)); }
 
         static std::string to_string(uint8_t value);
 
@@ -232,6 +301,9 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x15;
 
+        static constexpr Field CC_REVERSE{"cc_reverse", 7};
+        static constexpr Field TYPEC_FSM_STATE{"fsm_state", 0, 5};
+
         struct TypeCStatusReg
         {
         bool cc_reverse;
@@ -240,7 +312,10 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        TypeCStatusReg get_values() const;
+        constexpr TypeCStatusReg get_values() const
+        {
+            return {CC_REVERSE.test(raw_), static_cast<uint8_t>(TYPEC_FSM_STATE.decode(raw_))};
+        }
 
 
         static std::string to_string(uint8_t value);
@@ -257,6 +332,11 @@ namespace stusb4500
         public:
         const uint8_t reg_addr = 0x16;
 
+        static constexpr Field PRT_IBIST_RECEIVED{"prt_ibist_received", 4};
+        static constexpr Field PRL_MSG_RECEIVED{"prl_msg_received", 2};
+        static constexpr Field PRL_HW_RST_RECEIVED{"prl_hw_rst_received", 0};
+        static constexpr std::array<Field, 3> fields{PRT_IBIST_RECEIVED, PRL_MSG_RECEIVED, PRL_HW_RST_RECEIVED};
+
         struct PRTStatusReg
         {
         bool prt_ibist_received;
@@ -266,7 +346,10 @@ namespace stusb4500
 
         void set_raw(uint8_t raw) { raw_ = raw; }
         uint8_t get_raw() const { return raw_; }
-        PRTStatusReg get_values() const;
+        constexpr PRTStatusReg get_values() const
+        {
+            return {PRT_IBIST_RECEIVED.test(raw_), PRL_MSG_RECEIVED.test(raw_), PRL_HW_RST_RECEIVED.test(raw_)};
+        }
 
         void log() const;
         std::string to_json() const;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if defined(CONFIG_STUSB4500_JOURNAL)
+#include "esp_partition.h"
+#endif
+
+namespace stusb4500
+{
+    /**
+     * @brief Zone de flash effaçable par secteurs (partition, fichier de test...).
+     *
+     * Les offsets sont relatifs au début de la zone. Comme sur une NOR, une
+     * écriture ne peut que faire passer des bits de 1 à 0 : erase() remet un
+     * secteur entier à 0xFF.
+     */
+    class FlashRegion
+    {
+    public:
+        virtual ~FlashRegion() = default;
+
+        virtual size_t size() const = 0;
+        virtual size_t sector_size() const = 0;
+
+        virtual esp_err_t read(size_t offset, void *data, size_t len) = 0;
+        virtual esp_err_t write(size_t offset, const void *data, size_t len) = 0;
+        virtual esp_err_t erase(size_t offset, size_t len) = 0;
+    };
+
+#if defined(CONFIG_STUSB4500_JOURNAL)
+    /**
+     * @brief FlashRegion sur une partition de données identifiée par son label.
+     */
+    class PartitionRegion : public FlashRegion
+    {
+    public:
+        /// Retourne ESP_ERR_NOT_FOUND si la partition n'existe pas dans la table
+        esp_err_t open(const char *label = CONFIG_STUSB4500_JOURNAL_PARTITION);
+
+        size_t size() const override;
+        size_t sector_size() const override;
+
+        esp_err_t read(size_t offset, void *data, size_t len) override;
+        esp_err_t write(size_t offset, const void *data, size_t len) override;
+        esp_err_t erase(size_t offset, size_t len) override;
+
+    private:
+        inline static const char *TAG = "STUSB4500-PARTITION";
+        const esp_partition_t *partition_ = nullptr;
+    };
+#endif
+
+} // namespace stusb4500
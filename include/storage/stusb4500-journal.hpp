@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+#include "storage/stusb4500-flash_region.hpp"
+
+#if defined(CONFIG_STUSB4500_JOURNAL_BUFFER)
+#define STUSB4500_JOURNAL_BUFFER CONFIG_STUSB4500_JOURNAL_BUFFER
+#else
+#define STUSB4500_JOURNAL_BUFFER 32
+#endif
+
+namespace stusb4500
+{
+    enum class JournalEvent : uint8_t
+    {
+        Boot = 1,
+        Attach,
+        Detach,
+        Contract,          // arg16 = position, arg32 = mV << 16 | mA / 10
+        SoftReset,
+        HardReset,
+        HardResetReceived,
+        CCFault,           // arg16 = CC_HW_FAULT_STATUS_1
+        Fallback,
+        NvmWrite,          // arg32 = esp_err_t
+        Overflow,          // arg32 = événements perdus faute de place dans le buffer RAM
+        BusRecovery,       // arg16 = 1 si état resynchronisé, arg32 = durée en µs
+    };
+
+    /**
+     * @brief Enregistrement de 16 octets, little-endian sur la flash :
+     * sequence(4) uptime_ms(4) event(1) crc8(1) arg16(2) arg32(4).
+     *
+     * sequence à 0xFFFFFFFF signale un emplacement effacé ; crc8 (polynôme
+     * 0x07, octet crc compté à zéro) écarte les écritures interrompues.
+     */
+    struct JournalRecord
+    {
+        uint32_t sequence = 0;
+        uint32_t uptime_ms = 0;
+        JournalEvent event = JournalEvent::Boot;
+        uint16_t arg16 = 0;
+        uint32_t arg32 = 0;
+
+        static constexpr size_t SIZE = 16;
+
+        void encode(uint8_t *out) const;
+        /// Retourne false si le CRC ne correspond pas
+        bool decode(const uint8_t *in);
+    };
+
+    /**
+     * @brief Journal binaire des événements significatifs, en anneau sur une FlashRegion.
+     *
+     * record() n'écrit qu'en RAM (copie de 16 octets sous section critique) ;
+     * flush() regroupe les enregistrements en une écriture par secteur et
+     * efface le plus ancien secteur quand l'anneau reboucle, ce qui répartit
+     * l'usure sur toute la zone. Le décodage sur PC se fait avec
+     * tools/stusb4500_journal.py.
+     */
+    class EventJournal
+    {
+    public:
+        static constexpr size_t BUFFER = STUSB4500_JOURNAL_BUFFER;
+
+        explicit EventJournal(FlashRegion &region) : region_(region) {}
+
+        /// Retrouve la position d'écriture (plus grand numéro de séquence valide)
+        esp_err_t mount();
+
+        void record(JournalEvent event, uint16_t arg16 = 0, uint32_t arg32 = 0);
+
+        /// Écrit les enregistrements en attente ; à appeler hors du chemin d'alerte
+        esp_err_t flush();
+
+        /// Vrai si la moitié du buffer est occupée ou si le plus ancien attend depuis max_age_ms
+        bool flush_due(uint32_t max_age_ms = 5000) const;
+
+        size_t pending() const;
+        uint32_t dropped() const { return dropped_; }
+        size_t write_offset() const { return write_offset_; }
+
+    private:
+        inline static const char *TAG = "STUSB4500-JOURNAL";
+
+        /// Enregistrements que le secteur courant peut encore recevoir
+        size_t sector_room() const;
+        /// Écrit count enregistrements (≤ sector_room()) ; landed reçoit ceux arrivés intacts, même en cas d'échec
+        esp_err_t append(const uint8_t *data, size_t count, size_t &landed);
+        bool is_erased(const uint8_t *data, size_t len) const;
+
+        FlashRegion &region_;
+        bool mounted_ = false;
+        size_t write_offset_ = 0;
+        uint32_t next_sequence_ = 1;
+
+        std::array<JournalRecord, BUFFER> buffer_{};
+        size_t buffered_ = 0;
+        uint32_t dropped_ = 0;
+        uint32_t dropped_reported_ = 0;
+        mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+} // namespace stusb4500
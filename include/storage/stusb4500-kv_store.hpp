@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+namespace stusb4500
+{
+    /**
+     * @brief Stockage clé/valeur persistant utilisé par le driver (cache chargeurs, profils...).
+     *
+     * Les clés suivent les contraintes NVS (15 caractères max). get() retourne
+     * ESP_ERR_NOT_FOUND si la clé est absente et ajuste len à la taille lue ;
+     * avec data == nullptr, len reçoit la taille de la valeur stockée.
+     */
+    class KeyValueStore
+    {
+    public:
+        virtual ~KeyValueStore() = default;
+
+        virtual esp_err_t get(const char *key, void *data, size_t &len) = 0;
+        virtual esp_err_t set(const char *key, const void *data, size_t len) = 0;
+        virtual esp_err_t erase(const char *key) = 0;
+    };
+
+#if defined(CONFIG_STUSB4500_NVS_STORAGE)
+    /**
+     * @brief KeyValueStore adossé à nvs_flash (blobs dans un namespace dédié).
+     *
+     * nvs_flash_init() reste à la charge de l'application.
+     */
+    class NvsStore : public KeyValueStore
+    {
+    public:
+        explicit NvsStore(const char *name_space = CONFIG_STUSB4500_NVS_NAMESPACE) : namespace_(name_space) {}
+
+        esp_err_t get(const char *key, void *data, size_t &len) override;
+        esp_err_t set(const char *key, const void *data, size_t len) override;
+        esp_err_t erase(const char *key) override;
+
+    private:
+        inline static const char *TAG = "STUSB4500-NVS";
+        const char *namespace_;
+    };
+#endif
+
+} // namespace stusb4500
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+#include "stusb4500-common_types.hpp"
+#include "storage/stusb4500-kv_store.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Profils de puissance nommés, conservés dans un KeyValueStore.
+     *
+     * Un profil est la table des PDO sink telle qu'écrite en registres
+     * volatiles (0x85-0x90 et 0x70) : il s'applique en quelques millisecondes
+     * par PDOTable et soft reset, sans effacer ni reprogrammer la NVM.
+     * Chaque profil occupe la clé "pf_<nom>" ; le nom du profil actif est
+     * conservé sous "pf_active" pour être réappliqué au démarrage.
+     */
+    class ProfileStore
+    {
+    public:
+        /// Longueur maximale d'un nom ("pf_" + nom tient dans les 15 caractères NVS)
+        static constexpr size_t NAME_LEN = 12;
+
+        explicit ProfileStore(KeyValueStore &store) : store_(store) {}
+
+        esp_err_t save(const char *name, const PowerProfile &power);
+        /// ESP_ERR_NOT_FOUND si le profil n'existe pas, ESP_ERR_INVALID_VERSION s'il est illisible
+        esp_err_t load(const char *name, PowerProfile &power);
+        esp_err_t remove(const char *name);
+
+        esp_err_t set_active(const char *name);
+        /// Nom du profil actif, terminé par '\0' ; name doit contenir NAME_LEN + 1 octets
+        esp_err_t active(char *name);
+
+    private:
+        inline static const char *TAG = "STUSB4500-PROFILES";
+        static constexpr const char *ACTIVE_KEY = "pf_active";
+        static constexpr uint8_t STORE_VERSION = 1;
+
+        static bool make_key(const char *name, char (&key)[16]);
+
+        KeyValueStore &store_;
+    };
+
+} // namespace stusb4500
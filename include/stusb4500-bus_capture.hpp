@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+
+#include "stusb4500-bus_tap.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Format de capture I2C commun à BusRecorder et BusReplayer.
+     *
+     * En-tête : magic "I2CR" (LE32), version, 3 octets réservés.
+     * Enregistrement : delta µs depuis le précédent (LE32), flags (bit0 écriture,
+     * bit1 erreur), registre, longueur, esp_err_t (LE32) si erreur, puis les
+     * octets écrits ou lus (aucun pour une lecture en échec).
+     * tools/stusb4500_i2c_capture.py décode une capture sur PC.
+     */
+    struct BusCapture
+    {
+        static constexpr uint32_t MAGIC = 0x52433249; // "I2CR"
+        static constexpr uint8_t VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 8;
+        static constexpr size_t RECORD_SIZE = 7; // hors esp_err_t et données
+        static constexpr uint8_t FLAG_WRITE = 0x01;
+        static constexpr uint8_t FLAG_ERROR = 0x02;
+    };
+
+    /**
+     * @brief Enregistre chaque transaction dans un buffer fourni par l'application.
+     *
+     * Copie sous section critique, sans allocation ; une fois le buffer plein,
+     * les transactions suivantes sont comptées dans dropped() et la capture
+     * reste cohérente jusqu'au dernier enregistrement complet.
+     */
+    class BusRecorder : public BusTap
+    {
+    public:
+        BusRecorder(uint8_t *buffer, size_t capacity);
+
+        void observe(bool write, uint8_t reg, const uint8_t *data, size_t len, esp_err_t result) override;
+
+        const uint8_t *data() const { return buffer_; }
+        size_t size() const;
+        uint32_t records() const { return records_; }
+        uint32_t dropped() const { return dropped_; }
+
+        /// Écrit la capture (en-tête compris) dans un fichier ouvert en binaire
+        esp_err_t save(FILE *file) const;
+
+    private:
+        inline static const char *TAG = "STUSB4500-BUS_REC";
+
+        uint8_t *buffer_;
+        size_t capacity_;
+        size_t used_ = 0;
+        int64_t last_us_ = 0;
+        uint32_t records_ = 0;
+        uint32_t dropped_ = 0;
+        mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+    /**
+     * @brief Rejoue une capture : sert les lectures enregistrées et vérifie la séquence demandée.
+     *
+     * Toute transaction qui ne correspond pas à l'enregistrement attendu
+     * (sens, registre, longueur, octets écrits) est comptée comme divergence
+     * et échoue avec ESP_ERR_INVALID_STATE ; au-delà de la fin de capture,
+     * ESP_ERR_NOT_FOUND. Le driver voit sinon exactement les réponses et
+     * erreurs du terrain, retries compris.
+     */
+    class BusReplayer : public BusTap
+    {
+    public:
+        BusReplayer(const uint8_t *capture, size_t len);
+
+        /// false si l'en-tête est absent ou d'une autre version
+        bool valid() const { return valid_; }
+
+        bool intercept_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result) override;
+        bool intercept_write(uint8_t reg, const uint8_t *data, size_t len, esp_err_t &result) override;
+
+        bool finished() const { return offset_ >= len_; }
+        uint32_t replayed() const { return replayed_; }
+        uint32_t divergences() const { return divergences_; }
+        /// Index de la première transaction divergente, -1 si aucune
+        int32_t first_divergence() const { return first_divergence_; }
+        /// Durée couverte par les enregistrements rejoués (horloge du terrain)
+        uint64_t recorded_us() const { return recorded_us_; }
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        inline static const char *TAG = "STUSB4500-BUS_REPLAY";
+
+        bool next(bool write, uint8_t reg, size_t len, const uint8_t *written, uint8_t *read, esp_err_t &result);
+        esp_err_t diverge(const char *why, uint8_t reg);
+
+        const uint8_t *capture_;
+        size_t len_;
+        size_t offset_ = 0;
+        bool valid_ = false;
+        uint32_t replayed_ = 0;
+        uint32_t divergences_ = 0;
+        int32_t first_divergence_ = -1;
+        uint64_t recorded_us_ = 0;
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+
+#include "stusb4500-bus_tap.hpp"
+
+namespace stusb4500
+{
+    enum class BusFault : uint8_t
+    {
+        Nack,    // ESP_FAIL immédiat, registre inchangé
+        Timeout, // ESP_ERR_TIMEOUT après timeout_us
+        BitFlip, // lecture réussie, un bit inversé
+    };
+
+    /**
+     * @brief Dérivation de test : injecte des défauts I2C aléatoires ou scriptés.
+     *
+     * Tirages par transaction (ppm) depuis une graine fixe, donc reproductibles ;
+     * fail_next() et stick() imposent des défauts ciblés (rafale, bus bloqué).
+     * Les inversions de bits ne portent que sur les lectures. Une dérivation
+     * aval (BusReplayer, BusRecorder) peut être chaînée : les transactions non
+     * injectées lui sont transmises, ce qui permet de bruiter un rejeu sur PC.
+     */
+    class BusFaultInjector : public BusTap
+    {
+    public:
+        struct Settings
+        {
+            uint32_t nack_ppm = 0;
+            uint32_t timeout_ppm = 0;
+            uint32_t bitflip_ppm = 0;
+            uint32_t timeout_us = 1000; // attente simulée par timeout ou transaction sur bus bloqué
+            uint8_t reg_min = 0x00;     // plage de registres visée
+            uint8_t reg_max = 0xFF;
+            uint32_t seed = 1;
+        };
+
+        struct Stats
+        {
+            uint32_t transactions = 0; // dans la plage visée
+            uint32_t nacks = 0;
+            uint32_t timeouts = 0;
+            uint32_t bitflips = 0;
+            uint32_t stuck = 0; // échecs dus à stick()
+
+            uint32_t injected() const { return nacks + timeouts + bitflips + stuck; }
+        };
+
+        explicit BusFaultInjector(const Settings &settings, BusTap *downstream = nullptr);
+
+        /// Les `count` prochaines transactions visées subissent `fault`
+        void fail_next(uint16_t count, BusFault fault);
+
+        /// Bus bloqué pendant `duration_us` : toute transaction visée échoue en timeout
+        void stick(int64_t duration_us);
+
+        bool intercept_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result) override;
+        bool intercept_write(uint8_t reg, const uint8_t *data, size_t len, esp_err_t &result) override;
+        void filter_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result) override;
+        void observe(bool write, uint8_t reg, const uint8_t *data, size_t len, esp_err_t result) override;
+
+        const Stats &stats() const { return stats_; }
+
+        void log() const;
+        std::string to_json() const;
+
+    private:
+        inline static const char *TAG = "STUSB4500-BUS_FAULT";
+
+        bool targeted(uint8_t reg) const { return reg >= settings_.reg_min && reg <= settings_.reg_max; }
+        bool inject(uint8_t reg, esp_err_t &result);
+        bool roll(uint32_t ppm);
+        uint32_t next_random();
+
+        Settings settings_;
+        BusTap *downstream_;
+        Stats stats_;
+        uint32_t state_;
+        uint16_t scripted_left_ = 0;
+        BusFault scripted_ = BusFault::Nack;
+        int64_t stuck_until_us_ = 0;
+        portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+} // namespace stusb4500
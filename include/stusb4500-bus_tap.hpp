@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+namespace stusb4500
+{
+    /**
+     * @brief Point d'interception de toutes les transactions I2C passant par INTERFACE.
+     *
+     * intercept_*() peut servir la transaction à la place du bus (rejeu, injection) ;
+     * filter_read() peut altérer une lecture (bit inversé) ; observe() voit chaque transaction une fois terminée, réelle ou servie.
+     * Pointeur global au processus, partagé par toutes les instances d'INTERFACE (pas un décorateur d'I2CDevices) :
+     * une seule dérivation installée à la fois ; nullptr pour revenir au bus seul.
+     */
+    class BusTap
+    {
+    public:
+        virtual ~BusTap() = default;
+
+        /// true si la lecture est servie sans le bus ; data et result sont alors renseignés
+        virtual bool intercept_read(uint8_t /*reg*/, uint8_t * /*data*/, size_t /*len*/, esp_err_t & /*result*/) { return false; }
+        virtual bool intercept_write(uint8_t /*reg*/, const uint8_t * /*data*/, size_t /*len*/, esp_err_t & /*result*/) { return false; }
+
+        /// Appelé après une lecture (réelle ou servie) : altération possible de data et result
+        virtual void filter_read(uint8_t /*reg*/, uint8_t * /*data*/, size_t /*len*/, esp_err_t & /*result*/) {}
+
+        virtual void observe(bool /*write*/, uint8_t /*reg*/, const uint8_t * /*data*/, size_t /*len*/, esp_err_t /*result*/) {}
+
+        static void install(BusTap *tap) { installed_.store(tap, std::memory_order_release); }
+        static BusTap *installed() { return installed_.load(std::memory_order_acquire); }
+
+    private:
+        inline static std::atomic<BusTap *> installed_{nullptr};
+    };
+
+} // namespace stusb4500
@@ -1,8 +1,10 @@
 #pragma once
-#include <vector>
+#include <array>
 #include <cstdint>
 #include <string>
 
+#include "stusb4500-fields.hpp"
+
 namespace stusb4500
 {
     enum class FastRoleSwap : uint8_t {
@@ -30,7 +32,19 @@ namespace stusb4500
     
     struct PowerProfile
     {
-        std::vector<PDObjectProfile> pdos{};
+        // Disposition d'un PDO sink "Fixed supply" (registres 0x85-0x90) ; les drapeaux
+        // (bits 29-23) n'existent que dans le PDO1, réservés à 0 dans PDO2/PDO3
+        static constexpr Field DUAL_ROLE_POWER{"dual_role_power", 29};
+        static constexpr Field HIGHER_CAPABILITY{"higher_capability", 28};
+        static constexpr Field UNCONSTRAINED_POWER{"unconstrained_power", 27};
+        static constexpr Field USB_COMM_CAPABLE{"usb_comm_capable", 26};
+        static constexpr Field FRS{"frs", 23, 2};
+        static constexpr Field VOLTAGE{"voltage_mv", 10, 10, 50};
+        static constexpr Field CURRENT{"current_ma", 0, 10, 10};
+        static constexpr uint32_t PDO1_FLAGS = DUAL_ROLE_POWER.mask() | HIGHER_CAPABILITY.mask() |
+                                               UNCONSTRAINED_POWER.mask() | USB_COMM_CAPABLE.mask() | FRS.mask();
+
+        std::array<PDObjectProfile, 3> pdos{};
         uint8_t pdo_number = 1;
         uint16_t flex_current_ma = 2200;
         bool usb_comm_capable = false;
@@ -39,7 +53,9 @@ namespace stusb4500
         bool unconstrained_power = false;
         FastRoleSwap frs = FastRoleSwap::NotSupported;
 
+        /// Tension et courant du PDO `index` ; les drapeaux ne sont lus que dans le PDO1 (index 0)
         void decode(uint32_t raw, size_t index);
+        /// Mot du PDO `index` ; les drapeaux ne sont écrits que dans le PDO1 (index 0)
         uint32_t encode(size_t index) const;
 
         void log() const;
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <string>
+
+#include "esp_log.h"
+#include "stusb4500-output.hpp"
+
+namespace stusb4500
+{
+    /**
+     * @brief Description déclarative d'un champ de bits.
+     *
+     * Un champ est défini par son nom, sa position, sa largeur et un facteur
+     * d'échelle (ex. 50 mV par pas). Les descripteurs sont des constantes
+     * `static constexpr` : decode()/encode() se réduisent à un masque et un
+     * décalage, sans branchement. Les mêmes descripteurs alimentent log() et
+     * to_json() via log_fields()/fields_to_json().
+     */
+    template <typename Raw>
+    struct BasicField
+    {
+        const char *name;
+        uint8_t offset;
+        uint8_t width = 1;
+        uint16_t scale = 1;
+
+        constexpr Raw mask() const
+        {
+            return static_cast<Raw>(((Raw{1} << width) - 1) << offset);
+        }
+
+        /// Valeur physique (pas × échelle)
+        constexpr uint32_t decode(Raw raw) const
+        {
+            return static_cast<uint32_t>((raw & mask()) >> offset) * scale;
+        }
+
+        /// Réinjecte une valeur physique dans raw sans toucher aux autres bits
+        constexpr Raw encode(Raw raw, uint32_t value) const
+        {
+            return static_cast<Raw>((raw & ~mask()) | ((static_cast<Raw>(value / scale) << offset) & mask()));
+        }
+
+        constexpr bool test(Raw raw) const { return (raw & mask()) != 0; }
+    };
+
+    /// Registres I2C et objets PD (≤ 32 bits)
+    using Field = BasicField<uint32_t>;
+    /// Secteurs NVM de 8 octets vus comme un mot 64 bits little-endian
+    using NvmField = BasicField<uint64_t>;
+
+    constexpr uint64_t load_le64(const uint8_t *buffer)
+    {
+        // Hors évaluation constante, un seul accès 64 bits (ESP32 et hôte sont little-endian)
+        if (std::endian::native == std::endian::little && !std::is_constant_evaluated())
+        {
+            uint64_t raw;
+            std::memcpy(&raw, buffer, sizeof(raw));
+            return raw;
+        }
+        uint64_t raw = 0;
+        for (std::size_t i = 0; i < 8; ++i)
+            raw |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+        return raw;
+    }
+
+    constexpr void store_le64(uint64_t raw, uint8_t *buffer)
+    {
+        if (std::endian::native == std::endian::little && !std::is_constant_evaluated())
+        {
+            std::memcpy(buffer, &raw, sizeof(raw));
+            return;
+        }
+        for (std::size_t i = 0; i < 8; ++i)
+            buffer[i] = static_cast<uint8_t>(raw >> (8 * i));
+    }
+
+    constexpr uint32_t load_le32(const uint8_t *buffer)
+    {
+        return static_cast<uint32_t>(buffer[0]) |
+               (static_cast<uint32_t>(buffer[1]) << 8) |
+               (static_cast<uint32_t>(buffer[2]) << 16) |
+               (static_cast<uint32_t>(buffer[3]) << 24);
+    }
+
+    constexpr void store_le32(uint32_t raw, uint8_t *buffer)
+    {
+        buffer[0] = raw & 0xFF;
+        buffer[1] = (raw >> 8) & 0xFF;
+        buffer[2] = (raw >> 16) & 0xFF;
+        buffer[3] = (raw >> 24) & 0xFF;
+    }
+
+    /// Une ligne de log "NAME: field=YES, other=3, ..." générée depuis les descripteurs
+    template <std::size_t N>
+    void log_fields(const char *tag, const char *reg_name, uint32_t raw,
+                    const std::array<Field, N> &fields,
+                    const char *set_label = "YES", const char *clear_label = "NO")
+    {
+#if STUSB4500_LOG_TEXT
+        char line[192];
+        int len = snprintf(line, sizeof(line), "%s:", reg_name);
+        for (std::size_t i = 0; i < N && len > 0 && static_cast<std::size_t>(len) < sizeof(line); ++i)
+        {
+            const Field &f = fields[i];
+            if (f.width == 1)
+                len += snprintf(line + len, sizeof(line) - len, "%s %s=%s", i ? "," : "", f.name,
+                                f.test(raw) ? set_label : clear_label);
+            else
+                len += snprintf(line + len, sizeof(line) - len, "%s %s=%u", i ? "," : "", f.name,
+                                static_cast<unsigned>(f.decode(raw)));
+        }
+        ESP_LOGI(tag, "%s", line);
+#endif
+    }
+
+    /// Objet JSON {"field": true, "other": 3, ...} généré depuis les descripteurs
+    template <std::size_t N>
+    std::string fields_to_json(uint32_t raw, const std::array<Field, N> &fields)
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const Field &f = fields[i];
+            if (i)
+                json += ",";
+            json += "\"" + std::string(f.name) + "\": ";
+            json += f.width == 1 ? (f.test(raw) ? "true" : "false") : std::to_string(f.decode(raw));
+        }
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -6,6 +6,8 @@
 #include "esp_log.h"
 
 #include "I2CDevices.hpp"
+#include "stusb4500-bus_tap.hpp"
+#include "stusb4500-metrics.hpp"
 
 namespace stusb4500
 {
@@ -26,15 +28,17 @@ namespace stusb4500
 
             for (int attempt = 0; attempt < max_attempts; ++attempt)
             {
-                err = i2c.read(reg, data, len);
+                err = bus_read(reg, data, len);
                 if (err == ESP_OK)
                 {
                     //ESP_LOGI(TAG, "I2C READ -> Reg: 0x%02X | Len: %d", reg, static_cast<int>(len));
                     //ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_INFO);
+                    Metrics::instance().on_read(reg, len, attempt + 1, true);
                     return ESP_OK;
                 }
                 vTaskDelay(pdMS_TO_TICKS(10));
             }
+            Metrics::instance().on_read(reg, len, max_attempts, false);
             ESP_LOGW(TAG, "Read failed at reg 0x%02X after %d attempts (err=0x%x)", reg, max_attempts, err);
             return err;
         }
@@ -42,15 +46,24 @@ namespace stusb4500
         esp_err_t write_register(uint8_t reg, const uint8_t *data, size_t len)
         {
             esp_err_t err = ESP_FAIL;
-            err = i2c.write(reg, data, len);
-            if (err == ESP_OK)
+            // Un timeout n'exclut pas que l'écriture ait eu lieu (ACK final perdu) : seules les écritures
+            // idempotentes sont retentées, une commande n'est envoyée qu'une fois et l'appelant décide de la suite
+            const int max_attempts = idempotent(reg, data, len) ? 3 : 1;
+
+            for (int attempt = 0; attempt < max_attempts; ++attempt)
             {
-                //ESP_LOGI(TAG, "I2C WRITE -> Reg: 0x%02X | Len: %d", reg, static_cast<int>(len));
-                //ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_INFO);
-                return ESP_OK;
+                err = bus_write(reg, data, len);
+                if (err == ESP_OK)
+                {
+                    //ESP_LOGI(TAG, "I2C WRITE -> Reg: 0x%02X | Len: %d", reg, static_cast<int>(len));
+                    //ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_INFO);
+                    Metrics::instance().on_write(reg, len, attempt + 1, true);
+                    return ESP_OK;
+                }
+                vTaskDelay(pdMS_TO_TICKS(10));
             }
-
-            ESP_LOGW(TAG, "Write failed at reg 0x%02X (err=0x%x)", reg, err);
+            Metrics::instance().on_write(reg, len, max_attempts, false);
+            ESP_LOGW(TAG, "Write failed at reg 0x%02X after %d attempts (err=0x%x)", reg, max_attempts, err);
             return err;
         }
 
@@ -59,11 +72,58 @@ namespace stusb4500
             return read_register(reg, &out, 1);
         }
 
+        /// false si la rafale touche un registre de commande : TX_HEADER_LOW, PD_COMMAND_CTRL ou FTP_CTRL_0 avec REQ
+        static constexpr bool idempotent(uint8_t reg, const uint8_t *data, size_t len)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                const uint8_t r = static_cast<uint8_t>(reg + i);
+                if (r == REG_TX_HEADER_LOW || r == REG_PD_COMMAND_CTRL ||
+                    (r == REG_FTP_CTRL_0 && (data[i] & FTP_CTRL_0_REQ) != 0))
+                    return false;
+            }
+            return true;
+        }
+
     protected:
         I2CDevices &i2c;
 
+        // Transaction unique, via la dérivation installée (enregistrement, rejeu, injection) s'il y en a une
+        esp_err_t bus_read(uint8_t reg, uint8_t *data, size_t len)
+        {
+            BusTap *tap = BusTap::installed();
+            if (tap == nullptr)
+                return i2c.read(reg, data, len);
+
+            esp_err_t err = ESP_FAIL;
+            if (!tap->intercept_read(reg, data, len, err))
+                err = i2c.read(reg, data, len);
+            tap->filter_read(reg, data, len, err);
+            tap->observe(false, reg, data, len, err);
+            return err;
+        }
+
+        esp_err_t bus_write(uint8_t reg, const uint8_t *data, size_t len)
+        {
+            BusTap *tap = BusTap::installed();
+            if (tap == nullptr)
+                return i2c.write(reg, data, len);
+
+            esp_err_t err = ESP_FAIL;
+            if (!tap->intercept_write(reg, data, len, err))
+                err = i2c.write(reg, data, len);
+            tap->observe(true, reg, data, len, err);
+            return err;
+        }
+
     private:
         inline static const char *TAG = "STUSB4500-INTERFACE";
+
+        // Registres dont l'écriture déclenche une action (soft reset, message PD, opération FTP)
+        static constexpr uint8_t REG_PD_COMMAND_CTRL = 0x1A;
+        static constexpr uint8_t REG_TX_HEADER_LOW = 0x51;
+        static constexpr uint8_t REG_FTP_CTRL_0 = 0x96;
+        static constexpr uint8_t FTP_CTRL_0_REQ = 1 << 4;
     };
 
 } // namespace stusb4500
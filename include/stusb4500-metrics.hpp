@@ -0,0 +1,273 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace stusb4500
+{
+    /// Familles de registres, pour ventiler le trafic I2C
+    enum class RegClass : uint8_t
+    {
+        Status, // 0x0B-0x16, 0x29
+        Ctrl,   // 0x1A, 0x2F, 0x51, 0x70
+        RX,     // 0x31-0x4E
+        NVM,    // 0x53-0x5A, 0x95-0x97
+        PDO,    // 0x85-0x90
+        RDO,    // 0x91-0x94
+        Other,
+        Count
+    };
+
+    enum class NvmOp : uint8_t
+    {
+        Read,
+        Write,
+        Count
+    };
+
+    /// Retours à un état sûr après une erreur bus
+    enum class RecoveryKind : uint8_t
+    {
+        Nvm,    // séquence FTP interrompue : sortie du mode test, clé reverrouillée
+        Status, // alerte perdue : relecture des registres d'état, masque réécrit
+        Count
+    };
+
+    /// Alertes de ALERT_STATUS_1 comptées séparément
+    enum class AlertKind : uint8_t
+    {
+        PortStatus,
+        TypeCMonitoring,
+        CCHwFault,
+        PDTypeC,
+        PRTStatus,
+        Count
+    };
+
+    constexpr RegClass reg_class(uint8_t reg)
+    {
+        if ((reg >= 0x0B && reg <= 0x16) || reg == 0x29)
+            return RegClass::Status;
+        if (reg == 0x1A || reg == 0x2F || reg == 0x51 || reg == 0x70)
+            return RegClass::Ctrl;
+        if (reg >= 0x31 && reg <= 0x4E)
+            return RegClass::RX;
+        if ((reg >= 0x53 && reg <= 0x5A) || (reg >= 0x95 && reg <= 0x97))
+            return RegClass::NVM;
+        if (reg >= 0x85 && reg <= 0x90)
+            return RegClass::PDO;
+        if (reg >= 0x91 && reg <= 0x94)
+            return RegClass::RDO;
+        return RegClass::Other;
+    }
+
+    /**
+     * @brief Copie figée des compteurs, lisible comme une simple structure.
+     */
+    struct MetricsSnapshot
+    {
+        // Histogramme de durées : < 100 µs, < 1 ms, < 10 ms, < 100 ms, < 1 s, >= 1 s
+        static constexpr std::size_t BUCKETS = 6;
+        using Histogram = std::array<uint32_t, BUCKETS>;
+
+        struct Bus
+        {
+            uint32_t reads = 0;
+            uint32_t writes = 0;
+            uint32_t read_bytes = 0;
+            uint32_t write_bytes = 0;
+            uint32_t retries = 0;
+            uint32_t failures = 0;
+        };
+
+        std::array<Bus, static_cast<std::size_t>(RegClass::Count)> bus{};
+        std::array<uint32_t, static_cast<std::size_t>(AlertKind::Count)> alerts{};
+        uint32_t alerts_total = 0;
+        Histogram alert_duration{};
+
+        std::array<uint32_t, static_cast<std::size_t>(NvmOp::Count)> nvm_ops{};
+        std::array<uint32_t, static_cast<std::size_t>(NvmOp::Count)> nvm_failures{};
+        std::array<Histogram, static_cast<std::size_t>(NvmOp::Count)> nvm_duration{};
+
+        std::array<uint32_t, static_cast<std::size_t>(RecoveryKind::Count)> recoveries{};
+        std::array<uint32_t, static_cast<std::size_t>(RecoveryKind::Count)> recovery_failures{};
+        std::array<Histogram, static_cast<std::size_t>(RecoveryKind::Count)> recovery_duration{};
+        std::array<uint32_t, static_cast<std::size_t>(RecoveryKind::Count)> recovery_max_us{};
+
+        uint32_t contract_changes = 0;
+        uint32_t contract_power_mw = 0; // jauge
+
+        // Attachement -> premier contrat sur la table définitive
+        uint32_t attach_contracts = 0;
+        Histogram attach_to_contract{};
+        uint32_t attach_to_contract_last_us = 0; // jauge
+        uint32_t attach_to_contract_max_us = 0;
+        uint32_t fast_path_hits = 0;   // table anticipée = table du chargeur reconnu
+        uint32_t fast_path_misses = 0; // autre chargeur : ajustement après les capacités
+        uint32_t rx_bytes_saved = 0;
+
+        static const char *to_string(RegClass cls);
+        static const char *to_string(AlertKind kind);
+        static const char *to_string(RecoveryKind kind);
+
+        void log() const;
+        std::string to_json() const;
+    };
+
+    /**
+     * @brief Registre global de compteurs atomiques du driver.
+     *
+     * Chaque mise à jour est un fetch_add relaxé ; snapshot() copie l'ensemble
+     * sans verrou (les compteurs sont cohérents individuellement).
+     */
+    class Metrics
+    {
+    public:
+        static Metrics &instance()
+        {
+            static Metrics registry;
+            return registry;
+        }
+
+        void on_read(uint8_t reg, size_t len, int attempts, bool ok)
+        {
+            BusCounters &bus = bus_[static_cast<std::size_t>(reg_class(reg))];
+            bus.reads.fetch_add(1, std::memory_order_relaxed);
+            if (attempts > 1)
+                bus.retries.fetch_add(attempts - 1, std::memory_order_relaxed);
+            if (ok)
+                bus.read_bytes.fetch_add(len, std::memory_order_relaxed);
+            else
+                bus.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_write(uint8_t reg, size_t len, int attempts, bool ok)
+        {
+            BusCounters &bus = bus_[static_cast<std::size_t>(reg_class(reg))];
+            bus.writes.fetch_add(1, std::memory_order_relaxed);
+            if (attempts > 1)
+                bus.retries.fetch_add(attempts - 1, std::memory_order_relaxed);
+            if (ok)
+                bus.write_bytes.fetch_add(len, std::memory_order_relaxed);
+            else
+                bus.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_alert(AlertKind kind)
+        {
+            alerts_[static_cast<std::size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_alert_handled(int64_t duration_us)
+        {
+            alerts_total_.fetch_add(1, std::memory_order_relaxed);
+            alert_duration_[bucket(duration_us)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_nvm(NvmOp op, int64_t duration_us, bool ok)
+        {
+            const std::size_t i = static_cast<std::size_t>(op);
+            nvm_ops_[i].fetch_add(1, std::memory_order_relaxed);
+            if (!ok)
+                nvm_failures_[i].fetch_add(1, std::memory_order_relaxed);
+            nvm_duration_[i][bucket(duration_us)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// Durée entre l'erreur et le retour à un état sûr (ok) ou l'abandon
+        void on_recovery(RecoveryKind kind, int64_t duration_us, bool ok)
+        {
+            const std::size_t i = static_cast<std::size_t>(kind);
+            recoveries_[i].fetch_add(1, std::memory_order_relaxed);
+            if (!ok)
+                recovery_failures_[i].fetch_add(1, std::memory_order_relaxed);
+            recovery_duration_[i][bucket(duration_us)].fetch_add(1, std::memory_order_relaxed);
+
+            raise_max(recovery_max_us_[i], clamp_us(duration_us));
+        }
+
+        void on_contract(uint32_t power_mw)
+        {
+            contract_changes_.fetch_add(1, std::memory_order_relaxed);
+            contract_power_mw_.store(power_mw, std::memory_order_relaxed);
+        }
+
+        void on_attach_contract(int64_t duration_us)
+        {
+            const uint32_t us = clamp_us(duration_us);
+            attach_contracts_.fetch_add(1, std::memory_order_relaxed);
+            attach_to_contract_[bucket(duration_us)].fetch_add(1, std::memory_order_relaxed);
+            attach_to_contract_last_us_.store(us, std::memory_order_relaxed);
+            raise_max(attach_to_contract_max_us_, us);
+        }
+
+        void on_fast_path(bool hit)
+        {
+            (hit ? fast_path_hits_ : fast_path_misses_).fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_rx_bytes_saved(uint32_t bytes) { rx_bytes_saved_.fetch_add(bytes, std::memory_order_relaxed); }
+        uint32_t rx_bytes_saved() const { return rx_bytes_saved_.load(std::memory_order_relaxed); }
+
+        MetricsSnapshot snapshot() const;
+        void reset();
+
+    private:
+        using AtomicHistogram = std::array<std::atomic<uint32_t>, MetricsSnapshot::BUCKETS>;
+
+        struct BusCounters
+        {
+            std::atomic<uint32_t> reads{0};
+            std::atomic<uint32_t> writes{0};
+            std::atomic<uint32_t> read_bytes{0};
+            std::atomic<uint32_t> write_bytes{0};
+            std::atomic<uint32_t> retries{0};
+            std::atomic<uint32_t> failures{0};
+        };
+
+        static constexpr uint32_t clamp_us(int64_t duration_us)
+        {
+            return duration_us < 0 ? 0 : duration_us > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(duration_us);
+        }
+
+        static void raise_max(std::atomic<uint32_t> &max, uint32_t value)
+        {
+            uint32_t current = max.load(std::memory_order_relaxed);
+            while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        static constexpr std::size_t bucket(int64_t duration_us)
+        {
+            std::size_t i = 0;
+            for (int64_t bound = 100; i + 1 < MetricsSnapshot::BUCKETS && duration_us >= bound; bound *= 10)
+                ++i;
+            return i;
+        }
+
+        std::array<BusCounters, static_cast<std::size_t>(RegClass::Count)> bus_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(AlertKind::Count)> alerts_{};
+        std::atomic<uint32_t> alerts_total_{0};
+        AtomicHistogram alert_duration_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(NvmOp::Count)> nvm_ops_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(NvmOp::Count)> nvm_failures_{};
+        std::array<AtomicHistogram, static_cast<std::size_t>(NvmOp::Count)> nvm_duration_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(RecoveryKind::Count)> recoveries_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(RecoveryKind::Count)> recovery_failures_{};
+        std::array<AtomicHistogram, static_cast<std::size_t>(RecoveryKind::Count)> recovery_duration_{};
+        std::array<std::atomic<uint32_t>, static_cast<std::size_t>(RecoveryKind::Count)> recovery_max_us_{};
+        std::atomic<uint32_t> contract_changes_{0};
+        std::atomic<uint32_t> contract_power_mw_{0};
+        std::atomic<uint32_t> attach_contracts_{0};
+        AtomicHistogram attach_to_contract_{};
+        std::atomic<uint32_t> attach_to_contract_last_us_{0};
+        std::atomic<uint32_t> attach_to_contract_max_us_{0};
+        std::atomic<uint32_t> fast_path_hits_{0};
+        std::atomic<uint32_t> fast_path_misses_{0};
+        std::atomic<uint32_t> rx_bytes_saved_{0};
+    };
+
+} // namespace stusb4500
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+// Sélection à la compilation des sorties texte/JSON (menu "Diagnostics output").
+// Les accesseurs bruts (get_raw(), get_values(), encode/decode) restent toujours disponibles.
+
+#if defined(CONFIG_STUSB4500_LOG_TEXT)
+#define STUSB4500_LOG_TEXT 1
+#else
+#define STUSB4500_LOG_TEXT 0
+#endif
+
+#if defined(CONFIG_STUSB4500_JSON_OUTPUT)
+#define STUSB4500_JSON_OUTPUT 1
+#else
+#define STUSB4500_JSON_OUTPUT 0
+#endif
+
+// Profondeur du journal des messages PD reçus, 0 pour le désactiver
+#if defined(CONFIG_STUSB4500_TRACE_DEPTH)
+#define STUSB4500_TRACE_DEPTH CONFIG_STUSB4500_TRACE_DEPTH
+#else
+#define STUSB4500_TRACE_DEPTH 0
+#endif
@@ -1,21 +1,41 @@
 #pragma once
 
+#include <atomic>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "sdkconfig.h"
 
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_intr_alloc.h"
+#include "esp_timer.h"
+
+#include "stusb4500-metrics.hpp"
 
 #include "config/stusb4500-config.hpp"
+#include "config/stusb4500-config_patch.hpp"
+#include "ctrl/stusb4500-alert_poller.hpp"
 #include "ctrl/stusb4500-ctrl.hpp"
+#include "ctrl/stusb4500-negotiation_bench.hpp"
+#include "ctrl/stusb4500-watchdog.hpp"
 #include "nvm/stusb4500-nvm.hpp"
 #include "pd/stusb4500-pdo.hpp"
+#include "pd/stusb4500-charger_cache.hpp"
+#include "pd/stusb4500-policy.hpp"
 #include "pd/stusb4500-rdo.hpp"
 #include "pd/stusb4500-rx_datas.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+#include "pd/stusb4500-trace.hpp"
+#include "status/stusb4500-alert_subscriptions.hpp"
 #include "status/stusb4500-status.hpp"
+#include "status/stusb4500-pe_tracker.hpp"
+#include "status/stusb4500-snapshot.hpp"
+#include "storage/stusb4500-journal.hpp"
+#include "storage/stusb4500-kv_store.hpp"
+#include "storage/stusb4500-profile_store.hpp"
 
 namespace stusb4500
 {
@@ -26,10 +46,14 @@ namespace stusb4500
         JSON
     };
 
+    /// Les méthodes publiques qui lisent le bus ou modifient l'état du driver prennent le verrou du composant :
+    /// elles sont appelables depuis toute tâche et s'exécutent entre deux réveils de la tâche du driver
     class STUSB4500Manager
     {
     public:
         STUSB4500Manager(I2CDevices &i2c);
+        STUSB4500Manager(const STUSB4500Manager &) = delete;
+        STUSB4500Manager &operator=(const STUSB4500Manager &) = delete;
 
         // === API PUBLIQUE ===
 
@@ -44,17 +68,81 @@ namespace stusb4500
 
         esp_err_t check_nvm_config(ConfigParams &cfg);
 
+        /// Applique `target` par le minimum d'écritures volatiles ; la NVM n'est programmée que si nécessaire et autorisé
+        esp_err_t apply_config(const ConfigParams &target, bool program_nvm = false,
+                               OutputFormat format = OutputFormat::None);
+
         esp_err_t handle_alert();
+
+        /// S'abonne à des familles d'alertes (AlertClass combinées par |) ; -1 si refusé.
+        /// Sans accès I2C : la tâche du driver démasque ces familles à son réveil
+        int subscribe(uint8_t classes, AlertHandler handler, void *ctx = nullptr);
+
+        /// Retire un abonnement ; la tâche du driver remasque les familles devenues inutiles
+        esp_err_t unsubscribe(int id);
         
-        /// Réécrit le PDO avec la configuration par défaut et force une renégociation
+        /// Réécrit le PDO `index` (1 à 3) avec la configuration par défaut et force une renégociation
         esp_err_t reconfigure(uint8_t index, Config &cfg);
 
+        /// Écrit la table complète des PDO sink en une rafale, relecture optionnelle, puis renégocie
+        esp_err_t write_pdo_table(const PowerProfile &power, bool verify = false);
+
         /// Lit et retourne l’état courant de la connexion USB-C
         esp_err_t get_status(OutputFormat format = OutputFormat::None);
         esp_err_t get_connection_status(OutputFormat format = OutputFormat::None);
 
         esp_err_t get_active_pdo(OutputFormat format = OutputFormat::None);
 
+        /// Copie cohérente du dernier état publié par la tâche, sans accès I2C (appelable depuis toute tâche)
+        bool read_snapshot(StatusSnapshot &out) const { return snapshot_.read(out); }
+
+        /// Bilan de puissance extrapolé à l'instant présent, sans accès I2C (appelable depuis toute tâche)
+        bool read_power_stats(PowerStats &out) const;
+
+        /// Stockage persistant (NvsStore ou autre) ; recharge le cache des chargeurs connus
+        esp_err_t set_store(KeyValueStore *store);
+
+        /// Enregistre un profil de puissance nommé dans le stockage persistant
+        esp_err_t save_profile(const char *name, const PowerProfile &power);
+
+        /// Applique un profil enregistré aux registres volatils (NVM intacte), renégocie et le retient pour le démarrage
+        esp_err_t switch_profile(const char *name);
+
+        /// Journal flash des événements (avant init()) ; les écritures flash se font depuis la tâche du driver
+        esp_err_t set_journal(EventJournal *journal);
+
+        /// Chargeurs reconnus par l'empreinte de leurs Source_Capabilities
+        const ChargerCache &known_chargers() const { return chargers_; }
+
+        /// Historique et temps passé par état du policy engine (à lire depuis la tâche du driver)
+        const PETracker &pe_tracker() const { return pe_; }
+
+        /// Cadence, latence de détection et occupation bus du polling d'ALERT_STATUS_1 (mode sans broche ALERT)
+        const AlertPoller::Stats &poll_stats() const { return poller_.stats(); }
+
+        /// Compteurs de l'échelle de reprise (soft reset, hard reset, repli 5 V)
+        const NegotiationWatchdog &watchdog() const { return watchdog_; }
+
+        /// Compteurs du driver (trafic I2C par famille de registres, alertes, NVM, contrats)
+        static MetricsSnapshot metrics() { return Metrics::instance().snapshot(); }
+
+        /// Journal des derniers messages PD reçus (log(), to_json(), dump())
+        const MessageTrace &message_trace() const { return trace_; }
+
+        /// Dernier Source_Capabilities reçu (à lire depuis la tâche du driver)
+        const SourceCapabilities &source_capabilities() const { return source_caps_; }
+
+        /// Mesure la latence de renégociation (soft reset -> PE_SNK_READY -> RDO) sur `iterations` cycles
+        esp_err_t benchmark_negotiation(uint16_t iterations, NegotiationResult &result,
+                                        OutputFormat format = OutputFormat::None);
+
+        /// Active la sélection automatique des PDO sink, appliquée une fois par attachement ; oublie les chargeurs connus
+        /// si le profil change
+        void set_load_profile(const LoadProfile &load);
+
+        /// Calcule le meilleur jeu de PDO pour les capacités reçues, l'écrit et renégocie si besoin
+        esp_err_t apply_policy(OutputFormat format = OutputFormat::None);
+
     private:
         I2CDevices &i2c_;
         Config cfg_;
@@ -63,14 +151,76 @@ namespace stusb4500
         CTRL ctrl_;
 
         TaskHandle_t task_handle_ = nullptr;
+        // Mutex récursif : les appels publics imbriqués (switch_profile -> write_pdo_table) le reprennent
+        StaticSemaphore_t device_lock_buffer_;
+        SemaphoreHandle_t device_lock_;
+
+        StatusSnapshot shadow_ = {};
+        SnapshotPublisher snapshot_;
+        SourceCapabilities source_caps_;
+        PowerAccounting power_;
+        MessageTrace trace_;
+        PETracker pe_;
+        NegotiationWatchdog watchdog_;
+        AlertSubscriptions subscriptions_;
+        std::atomic<bool> mask_pending_{false}; // abonnements modifiés : masque à réécrire depuis la tâche
+        AlertPoller poller_;
+        PowerProfile configured_sink_; // table Kconfig/NVM, profil ou table imposée : restaurée au détachement
+        bool fallback_active_ = false;
+        ChargerCache chargers_;
+        KeyValueStore *store_ = nullptr;
+        EventJournal *journal_ = nullptr;
+        uint32_t charger_fingerprint_ = 0;
+        LoadProfile load_;
+        bool policy_enabled_ = false;
+        bool table_adjusted_ = false;
+        int64_t attach_us_ = 0;             // attachement en attente de son contrat définitif, 0 sinon
+        uint32_t fast_path_fingerprint_ = 0; // chargeur dont la table a été anticipée à l'attachement, 0 une fois la table choisie
+        bool fast_path_late_ = false;       // table écrite après la négociation : ne vaut qu'à la suivante
+        bool renegotiating_ = false;        // soft reset envoyé pour ajuster la table
+        int64_t bus_fault_since_us_ = 0; // début du traitement en échec, 0 si l'état est synchronisé
+        void publish_snapshot();
+        esp_err_t apply_active_profile();
+        esp_err_t refresh_contract(OutputFormat format, bool message_received);
+        esp_err_t apply_known_charger(const ChargerEntry &entry, bool force = false);
+        esp_err_t apply_attach_fast_path();
+        esp_err_t renegotiate();
+        void remember_charger(uint32_t rdo);
+        void forget_charger();
+        void update_charger_context();
+        void flush_chargers();
+        void track_policy_engine();
+        void count_alerts();
+        void on_attach_change(bool attached);
+        esp_err_t resync();
+        void recover_status(int64_t start);
+        esp_err_t run_watchdog();
+        esp_err_t enter_fallback();
+        esp_err_t restore_configured_sink();
+        void journal(JournalEvent event, uint16_t arg16 = 0, uint32_t arg32 = 0);
+
+        // Resynchronisation après erreur bus : nouvel essai toutes les RESYNC_RETRY_MS, abandon compté au-delà du délai, puis attente de la prochaine alerte
+        static constexpr uint32_t RESYNC_RETRY_MS = 50;
+        static constexpr int64_t RESYNC_DEADLINE_US = 1000000;
 
         inline static const char *TAG = "STUSB4500_MANAGER";
         bool ready_ = false;
         esp_err_t is_ready();
+        esp_err_t process_alert(int64_t start);
+        uint8_t consumed_alerts() const;
+        esp_err_t update_alert_mask(bool force = false);
+        esp_err_t apply_pending_mask();
+        esp_err_t poll_alert();
 
         static void task_wrapper(void *arg);
         static void IRAM_ATTR gpio_isr_handler(void *arg);
         void setup_interrupt(gpio_num_t gpio);
+        /// Compare la NVM à `image` et la programme si elle diffère (`cfg` : valeurs décodées, pour le log)
+        esp_err_t apply_nvm_image(const std::array<uint8_t, 40> &image, const ConfigParams &cfg);
+        esp_err_t check_nvm_image(const std::array<uint8_t, 40> &image, const ConfigParams &cfg);
+
+        /// Délai d'attente du prochain réveil (watchdog, PE bloqué, écritures flash, resynchronisation)
+        TickType_t wait_timeout();
         void task_main();
     };
 
@@ -1,9 +1,11 @@
 #include "config/stusb4500-config_macro.hpp"
+#include "nvm/stusb4500-nvm_data.hpp"
 #include "sdkconfig.h"
 
 namespace stusb4500
 {
-    ConfigParams load_config_from_kconfig()
+    // Conversion entièrement évaluée à la compilation : aucune arithmétique au boot
+    static constexpr ConfigParams make_kconfig_params()
     {
         ConfigParams cfg;
         
@@ -222,4 +224,48 @@ namespace stusb4500
 
         return cfg;
     }
+
+    static constexpr ConfigParams KCONFIG_PARAMS = make_kconfig_params();
+    static constexpr std::array<uint8_t, 40> KCONFIG_NVM_IMAGE = NVMData::encode_image(KCONFIG_PARAMS);
+
+    // Une valeur non représentable serait tronquée ou remplacée en silence dans la NVM
+    static_assert(is_voltage_step(CONFIG_STUSB4500_PDO2_VOLTAGE), "CONFIG_STUSB4500_PDO2_VOLTAGE must be a multiple of 50 mV");
+    static_assert(is_voltage_step(CONFIG_STUSB4500_PDO3_VOLTAGE), "CONFIG_STUSB4500_PDO3_VOLTAGE must be a multiple of 50 mV");
+    static_assert(CONFIG_STUSB4500_FLEX_CURRENT % 10 == 0, "CONFIG_STUSB4500_FLEX_CURRENT must be a multiple of 10 mA");
+    static_assert(CONFIG_STUSB4500_ALERT_MASK >= 0 && CONFIG_STUSB4500_ALERT_MASK <= 0xFF, "CONFIG_STUSB4500_ALERT_MASK must fit ALERT_STATUS_1_MASK (8 bits)");
+    static_assert(is_lup_current(KCONFIG_PARAMS.power_.pdos[0].current_ma) &&
+                  is_lup_current(KCONFIG_PARAMS.power_.pdos[1].current_ma) &&
+                  is_lup_current(KCONFIG_PARAMS.power_.pdos[2].current_ma),
+                  "PDO currents must be one of the 16 NVM lookup values");
+    static_assert(CONFIG_STUSB4500_PDO2_VOLTAGE <= CONFIG_STUSB4500_PDO3_VOLTAGE || !KCONFIG_PARAMS.power_.pdos[2].defined,
+                  "PDO3 voltage must not be lower than PDO2 (sink PDOs are ordered by voltage)");
+
+    // L'image relue doit redonner exactement les valeurs demandées
+    static_assert([] {
+        ConfigParams programmed;
+        NVMLayout::decode(programmed, KCONFIG_NVM_IMAGE.data());
+        const auto &want = KCONFIG_PARAMS.power_;
+        const auto &got = programmed.power_;
+        for (size_t i = 0; i < want.pdos.size(); ++i)
+        {
+            if (got.pdos[i].current_ma != want.pdos[i].current_ma ||
+                got.pdos[i].vbus_monitor.lower_percent != want.pdos[i].vbus_monitor.lower_percent ||
+                got.pdos[i].vbus_monitor.upper_percent != want.pdos[i].vbus_monitor.upper_percent)
+                return false;
+        }
+        return got.pdos[1].voltage_mv == want.pdos[1].voltage_mv && got.pdos[2].voltage_mv == want.pdos[2].voltage_mv &&
+               got.flex_current_ma == want.flex_current_ma && got.pdo_number == want.pdo_number &&
+               programmed.discharge_.time_to_0v == KCONFIG_PARAMS.discharge_.time_to_0v &&
+               programmed.discharge_.time_to_pdo == KCONFIG_PARAMS.discharge_.time_to_pdo;
+    }(), "Kconfig values do not survive NVM quantization");
+
+    ConfigParams load_config_from_kconfig()
+    {
+        return KCONFIG_PARAMS;
+    }
+
+    const std::array<uint8_t, 40> &kconfig_nvm_image()
+    {
+        return KCONFIG_NVM_IMAGE;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "config/stusb4500-config_patch.hpp"
+#include "nvm/stusb4500-nvm_data.hpp"
+#include "pd/stusb4500-pdo.hpp"
+#include "stusb4500-output.hpp"
+
+#include <cstring>
+
+#include "esp_log.h"
+
+#define RETURN_IF_ERROR(x)         \
+    do {                           \
+        esp_err_t __err_rc = (x);  \
+        if (__err_rc != ESP_OK) {  \
+            return __err_rc;       \
+        }                          \
+    } while (0)
+
+namespace stusb4500
+{
+    esp_err_t ConfigPatch::read_current(ConfigParams &current)
+    {
+        PDOTable table(i2c, current.power_);
+        RETURN_IF_ERROR(table.read());
+        current.power_ = table.power();
+
+        uint8_t mask = 0;
+        RETURN_IF_ERROR(read_u8(current.alert_mask.reg_addr, mask));
+        current.alert_mask.set_raw(mask);
+        return ESP_OK;
+    }
+
+    void ConfigPatch::add(uint8_t reg, const uint8_t *data, uint8_t len)
+    {
+        RegisterWrite &w = writes_[count_++];
+        w.reg = reg;
+        w.len = len;
+        std::memcpy(w.data.data(), data, len);
+    }
+
+    void ConfigPatch::compute(const ConfigParams &current, const ConfigParams &target)
+    {
+        count_ = 0;
+        renegotiate_ = false;
+        valid_ = target.power_.pdo_number >= 1 && target.power_.pdo_number <= target.power_.pdos.size();
+
+        // Masque d'alerte en premier : les alertes de la renégociation suivent le nouveau masque
+        if (current.alert_mask.get_raw() != target.alert_mask.get_raw())
+        {
+            uint8_t mask = target.alert_mask.get_raw();
+            add(target.alert_mask.reg_addr, &mask, 1);
+        }
+
+        // Une seule rafale du premier au dernier PDO modifié (un drapeau ne modifie que le PDO1)
+        int first = -1;
+        int last = -1;
+        uint8_t table[PDOTable::table_len];
+        for (size_t i = 0; i < target.power_.pdos.size(); ++i)
+        {
+            const uint32_t raw = target.power_.encode(i);
+            store_le32(raw, table + i * PDOTable::pdo_len);
+            if (raw != current.power_.encode(i))
+            {
+                if (first < 0)
+                    first = static_cast<int>(i);
+                last = static_cast<int>(i);
+            }
+        }
+        if (first >= 0)
+        {
+            add(PDOTable::base_reg_addr + first * PDOTable::pdo_len, table + first * PDOTable::pdo_len,
+                (last - first + 1) * PDOTable::pdo_len);
+            renegotiate_ = true;
+        }
+
+        if (current.power_.pdo_number != target.power_.pdo_number)
+        {
+            uint8_t count = target.power_.pdo_number;
+            add(PDOTable::pdo_number_reg, &count, 1);
+            renegotiate_ = true;
+        }
+
+        // Tout ce que les registres volatils n'atteignent pas relève de la NVM
+        nvm_ = NVMData::encode_image(reachable(current, target)) != NVMData::encode_image(target);
+    }
+
+    ConfigParams ConfigPatch::reachable(const ConfigParams &current, const ConfigParams &target)
+    {
+        ConfigParams result = current;
+        for (size_t i = 0; i < result.power_.pdos.size(); ++i)
+        {
+            result.power_.pdos[i].voltage_mv = target.power_.pdos[i].voltage_mv;
+            result.power_.pdos[i].current_ma = target.power_.pdos[i].current_ma;
+        }
+        result.power_.pdo_number = target.power_.pdo_number;
+        result.power_.usb_comm_capable = target.power_.usb_comm_capable;
+        result.power_.dual_role_power = target.power_.dual_role_power;
+        result.power_.higher_capability = target.power_.higher_capability;
+        result.power_.unconstrained_power = target.power_.unconstrained_power;
+        result.power_.frs = target.power_.frs;
+        result.alert_mask = target.alert_mask;
+        return result;
+    }
+
+    esp_err_t ConfigPatch::apply()
+    {
+        if (!valid_)
+        {
+            ESP_LOGE(TAG, "Invalid target PDO count");
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (size_t i = 0; i < count_; ++i)
+        {
+            const RegisterWrite &w = writes_[i];
+            esp_err_t err = write_register(w.reg, w.data.data(), w.len);
+            if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Write of %u bytes at reg 0x%02X failed (err=0x%x)", w.len, w.reg, err);
+                return err;
+            }
+        }
+        return ESP_OK;
+    }
+
+    void ConfigPatch::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Config patch : %u écriture(s) ---", static_cast<unsigned>(count_));
+        for (size_t i = 0; i < count_; ++i)
+            ESP_LOGI(TAG, " reg 0x%02X  %2u octet(s)", writes_[i].reg, writes_[i].len);
+        ESP_LOGI(TAG, "Renégociation : %s", renegotiate_ ? "oui" : "non");
+        ESP_LOGI(TAG, "NVM           : %s", nvm_ ? "à reprogrammer" : "inchangée");
+#endif
+    }
+
+    std::string ConfigPatch::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{\"writes\": [";
+        for (size_t i = 0; i < count_; ++i)
+        {
+            if (i)
+                json += ",";
+            json += "{\"reg\": " + std::to_string(writes_[i].reg) + ", \"len\": " + std::to_string(writes_[i].len) + "}";
+        }
+        json += "],";
+        json += "\"renegotiate\": " + std::string(renegotiate_ ? "true" : "false") + ",";
+        json += "\"needs_nvm\": " + std::string(nvm_ ? "true" : "false");
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -1,51 +1,24 @@
 #include "config/stusb4500-config_types.hpp"
+#include "stusb4500-output.hpp"
+#if STUSB4500_JSON_OUTPUT
 #include "cJSON.h"
+#endif
 #include "esp_log.h"
 
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-CONFIG";
-    inline std::string json_bool(const char *key, bool value)
-    {
-        return "\"" + std::string(key) + "\": " + (value ? "true" : "false");
-    }
-    
-    AlertStatus1MaskRegister::AlertStatus1MaskReg AlertStatus1MaskRegister::get_values() const
-    {
-        AlertStatus1MaskReg values = {};
-        values.port_status_al_mask = raw_ & (1 << 6);
-        values.typec_monitoring_status_al_mask = raw_ & (1 << 5);
-        values.cc_hw_fault_status_al_mask = raw_ & (1 << 4);
-        values.prt_status_al_mask = raw_ & (1 << 1);
-        return values;
-    }
+    [[maybe_unused]] static const char *TAG = "STUSB4500-CONFIG";
 
     void AlertStatus1MaskRegister::log() const
     {
-        AlertStatus1MaskReg values = get_values();
-        ESP_LOGI(TAG, "ALERT_STATUS_1_MASK: PORT_STATUS_AL_MASK=%s, TYPEC_MONITORING_STATUS_AL_MASK=%s, CC_HW_FAULT_STATUS_AL_MASK=%s, PRT_STATUS_AL_MASK=%s",
-                 values.port_status_al_mask ? "MASKED" : "UNMASKED",
-                 values.typec_monitoring_status_al_mask ? "MASKED" : "UNMASKED",
-                 values.cc_hw_fault_status_al_mask ? "MASKED" : "UNMASKED",
-                 values.prt_status_al_mask ? "MASKED" : "UNMASKED");
+        log_fields(TAG, "ALERT_STATUS_1_MASK", raw_, fields, "MASKED", "UNMASKED");
     }
 
     std::string AlertStatus1MaskRegister::to_json() const
     {
-        AlertStatus1MaskReg values = get_values();
-        return std::string("{") +
-               json_bool("port_status_al_mask", values.port_status_al_mask) + "," +
-               json_bool("typec_monitoring_status_al_mask", values.typec_monitoring_status_al_mask) + "," +
-               json_bool("cc_hw_fault_status_al_mask", values.cc_hw_fault_status_al_mask) + "," +
-               json_bool("prt_status_al_mask", values.prt_status_al_mask) +
-               "}";
+        return fields_to_json(raw_, fields);
     }
 
-    ConfigParams::ConfigParams()
-    {
-        power_.pdos.resize(3);
-    };
-
     std::string  ConfigParams::to_string(GPIOFunction func)
     {
         switch (func)
@@ -73,6 +46,7 @@ namespace stusb4500
 
     void ConfigParams::log() const
     {
+#if STUSB4500_LOG_TEXT
         ESP_LOGI(TAG, "========== Configuration STUSB4500 ==========");
 
         // GPIO Function
@@ -103,7 +77,7 @@ namespace stusb4500
                  power_.flex_current_ma);
 
         // PDOs détaillés
-        for (size_t i = 0; i < power_.pdo_number; ++i)
+        for (size_t i = 0; i < power_.pdo_number && i < power_.pdos.size(); ++i)
         {
             const auto &pdo = power_.pdos[i];
             ESP_LOGI(TAG, "--- PDO #%d ---", static_cast<int>(i + 1));
@@ -117,12 +91,14 @@ namespace stusb4500
         // Autres
         ESP_LOGI(TAG, "Power only 5V       : %s", power_only_5v ? "true" : "false");
         ESP_LOGI(TAG, "Request Src Current : %s", req_src_current ? "true" : "false");
-        ESP_LOGI(TAG, "Alert mask          : 0x%02X", alert_mask);
+        ESP_LOGI(TAG, "Alert mask          : 0x%02X", alert_mask.get_raw());
         ESP_LOGI(TAG, "=============================================");
+#endif
     }
 
     std::string ConfigParams::to_json() const
     {
+#if STUSB4500_JSON_OUTPUT
         cJSON *root = cJSON_CreateObject();
     
         // GPIO function
@@ -149,7 +125,7 @@ namespace stusb4500
         cJSON_AddNumberToObject(profile, "flex_current_ma", power_.flex_current_ma);
     
         cJSON *pdos_array = cJSON_CreateArray();
-        for (size_t i = 0; i < power_.pdo_number; ++i)
+        for (size_t i = 0; i < power_.pdo_number && i < power_.pdos.size(); ++i)
         {
             const auto& pdo = power_.pdos[i];
             cJSON *pdo_obj = cJSON_CreateObject();
@@ -179,6 +155,9 @@ namespace stusb4500
         free(json_str);
     
         return result;
+#else
+        return {};
+#endif
     }
     
 };
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "ctrl/stusb4500-alert_poller.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    // Lecture d'un registre : START, adresse+W, registre, RESTART, adresse+R, donnée, STOP
+    static constexpr uint32_t BITS_PER_POLL = 4 * 9 + 3;
+
+    void AlertPoller::keep_fast(int64_t now_us)
+    {
+        fast_until_us_ = now_us + static_cast<int64_t>(settings_.hold_ms) * 1000;
+        interval_ms_ = settings_.fast_ms;
+    }
+
+    void AlertPoller::on_poll(int64_t now_us, bool alert)
+    {
+        if (stats_.polls++ == 0)
+            stats_.started_us = now_us;
+
+        if (alert)
+        {
+            const uint32_t window_ms = stats_.last_us ? static_cast<uint32_t>((now_us - stats_.last_us) / 1000) : 0;
+            ++stats_.alerts;
+            stats_.latency_sum_ms += window_ms;
+            if (window_ms > stats_.latency_max_ms)
+                stats_.latency_max_ms = window_ms;
+            keep_fast(now_us);
+        }
+        else if (now_us >= fast_until_us_)
+        {
+            interval_ms_ = interval_ms_ * 2 < settings_.slow_ms ? interval_ms_ * 2 : settings_.slow_ms;
+        }
+        stats_.last_us = now_us;
+    }
+
+    uint32_t AlertPoller::Stats::bus_utilization_ppm(uint32_t bus_hz) const
+    {
+        const int64_t elapsed_us = last_us - started_us;
+        if (elapsed_us <= 0 || bus_hz == 0)
+            return 0;
+        const uint64_t busy_us = static_cast<uint64_t>(polls) * BITS_PER_POLL * 1000000u / bus_hz;
+        return static_cast<uint32_t>(busy_us * 1000000u / static_cast<uint64_t>(elapsed_us));
+    }
+
+    void AlertPoller::Stats::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Polling ALERT_STATUS_1 ---");
+        ESP_LOGI(TAG, "Lectures         : %lu (%lu alertes)", static_cast<unsigned long>(polls),
+                 static_cast<unsigned long>(alerts));
+        ESP_LOGI(TAG, "Latence détection: ~%lu ms moy., <= %lu ms max",
+                 static_cast<unsigned long>(latency_mean_ms()), static_cast<unsigned long>(latency_max_ms));
+#if defined(CONFIG_STUSB4500_I2C_MASTER_FREQUENCY)
+        ESP_LOGI(TAG, "Occupation bus   : %lu ppm",
+                 static_cast<unsigned long>(bus_utilization_ppm(CONFIG_STUSB4500_I2C_MASTER_FREQUENCY)));
+#endif
+#endif
+    }
+
+    std::string AlertPoller::Stats::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"polls\": " + std::to_string(polls) + ",";
+        json += "\"alerts\": " + std::to_string(alerts) + ",";
+        json += "\"latency_mean_ms\": " + std::to_string(latency_mean_ms()) + ",";
+        json += "\"latency_max_ms\": " + std::to_string(latency_max_ms);
+#if defined(CONFIG_STUSB4500_I2C_MASTER_FREQUENCY)
+        json += ",\"bus_utilization_ppm\": " + std::to_string(bus_utilization_ppm(CONFIG_STUSB4500_I2C_MASTER_FREQUENCY));
+#endif
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -14,8 +14,6 @@
 
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-CTRL";
-
     esp_err_t CTRL::ready()
     {
         uint8_t value;
@@ -0,0 +1,182 @@
+#include "ctrl/stusb4500-negotiation_bench.hpp"
+#include "ctrl/stusb4500-ctrl.hpp"
+#include "pd/stusb4500-rdo.hpp"
+#include "status/stusb4500-status.hpp"
+#include "stusb4500-output.hpp"
+
+#include <algorithm>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-BENCH";
+
+    uint32_t LatencySamples::percentile(uint8_t p) const
+    {
+        if (count == 0)
+            return 0;
+
+        uint32_t sorted[MAX_SAMPLES];
+        std::copy(samples_us, samples_us + count, sorted);
+        std::sort(sorted, sorted + count);
+
+        size_t rank = (static_cast<size_t>(p > 100 ? 100 : p) * count + 99) / 100;
+        return sorted[rank == 0 ? 0 : rank - 1];
+    }
+
+    uint32_t LatencySamples::mean() const
+    {
+        if (count == 0)
+            return 0;
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += samples_us[i];
+        return static_cast<uint32_t>(sum / count);
+    }
+
+    void LatencySamples::log(const char *name) const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "%-10s n=%u min=%u p50=%u p90=%u p99=%u max=%u mean=%u (us)",
+                 name, static_cast<unsigned>(count),
+                 static_cast<unsigned>(min()), static_cast<unsigned>(percentile(50)),
+                 static_cast<unsigned>(percentile(90)), static_cast<unsigned>(percentile(99)),
+                 static_cast<unsigned>(max()), static_cast<unsigned>(mean()));
+        if (dropped)
+            ESP_LOGW(TAG, "%-10s %u mesures ignorées (limite %u)", name, static_cast<unsigned>(dropped),
+                     static_cast<unsigned>(MAX_SAMPLES));
+#endif
+    }
+
+    std::string LatencySamples::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"count\": " + std::to_string(count) + ",";
+        json += "\"dropped\": " + std::to_string(dropped) + ",";
+        json += "\"min_us\": " + std::to_string(min()) + ",";
+        json += "\"p50_us\": " + std::to_string(percentile(50)) + ",";
+        json += "\"p90_us\": " + std::to_string(percentile(90)) + ",";
+        json += "\"p99_us\": " + std::to_string(percentile(99)) + ",";
+        json += "\"max_us\": " + std::to_string(max()) + ",";
+        json += "\"mean_us\": " + std::to_string(mean());
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+    void NegotiationResult::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Negotiation timing ---");
+        ESP_LOGI(TAG, "Iterations : %u (timeouts=%u, errors=%u, rdo_unchanged=%u)", iterations, timeouts, errors,
+                 rdo_unchanged);
+        to_ready.log("PE ready");
+        to_rdo.log("RDO");
+#endif
+    }
+
+    std::string NegotiationResult::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"iterations\": " + std::to_string(iterations) + ",";
+        json += "\"timeouts\": " + std::to_string(timeouts) + ",";
+        json += "\"errors\": " + std::to_string(errors) + ",";
+        json += "\"rdo_unchanged\": " + std::to_string(rdo_unchanged) + ",";
+        json += "\"to_ready\": " + to_ready.to_json() + ",";
+        json += "\"to_rdo\": " + to_rdo.to_json();
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+    esp_err_t NegotiationBench::run(uint16_t iterations,
+                                    NegotiationResult &result,
+                                    const Trigger &trigger,
+                                    uint32_t timeout_ms,
+                                    uint32_t poll_ms)
+    {
+        result = {};
+        STATUS status(dev_);
+        CTRL ctrl(dev_);
+        RDO rdo(dev_);
+
+        const int64_t timeout_us = static_cast<int64_t>(timeout_ms) * 1000;
+        const TickType_t poll_ticks = std::max<TickType_t>(1, pdMS_TO_TICKS(poll_ms));
+        if (iterations > LatencySamples::MAX_SAMPLES)
+            ESP_LOGW(TAG, "%u iterations, seules les %u premières mesures sont conservées", iterations,
+                     static_cast<unsigned>(LatencySamples::MAX_SAMPLES));
+
+        for (uint16_t i = 0; i < iterations; ++i)
+        {
+            result.iterations++;
+
+            // RDO du contrat en cours : seul un RDO différent date la nouvelle requête
+            const uint32_t previous_rdo = rdo.read() == ESP_OK ? rdo.encode() : 0;
+
+            const int64_t start = esp_timer_get_time();
+            esp_err_t err = trigger ? trigger() : ctrl.send_soft_reset();
+            if (err != ESP_OK)
+            {
+                result.errors++;
+                continue;
+            }
+
+            // PE_SNK_READY n'est pris en compte qu'après avoir vu le policy engine le quitter ;
+            // le RDO est scruté dans la même boucle, la requête précédant PS_RDY
+            bool left_ready = false;
+            bool ready = false;
+            int64_t rdo_us = 0;
+            while (esp_timer_get_time() - start < timeout_us)
+            {
+                const int64_t now = esp_timer_get_time();
+                if (rdo_us == 0 && rdo.read() == ESP_OK && rdo.encode() != previous_rdo && rdo.obj_position() != 0)
+                    rdo_us = now;
+                if (status.read_policy_engine_state() == ESP_OK)
+                {
+                    const bool is_ready = status.policy_engine_state.get_raw() == PE_SNK_READY;
+                    if (!is_ready)
+                        left_ready = true;
+                    else if (left_ready)
+                    {
+                        ready = true;
+                        break;
+                    }
+                }
+                vTaskDelay(poll_ticks);
+            }
+
+            if (!ready)
+            {
+                result.timeouts++;
+                ESP_LOGW(TAG, "Iteration %u: PE_SNK_READY not reached within %u ms", i, static_cast<unsigned>(timeout_ms));
+                continue;
+            }
+            const int64_t ready_us = esp_timer_get_time();
+            result.to_ready.add(static_cast<uint32_t>(ready_us - start));
+
+            // Requête écrite juste avant PS_RDY : dernière relecture une fois le contrat établi
+            if (rdo_us == 0 && rdo.read() == ESP_OK && rdo.encode() != previous_rdo && rdo.obj_position() != 0)
+                rdo_us = ready_us;
+            if (rdo_us == 0)
+            {
+                result.rdo_unchanged++;
+                continue;
+            }
+            result.to_rdo.add(static_cast<uint32_t>(rdo_us - start));
+        }
+
+        return result.timeouts == 0 && result.errors == 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+    }
+
+} // namespace stusb4500
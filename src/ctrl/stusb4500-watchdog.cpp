@@ -0,0 +1,217 @@
+#include "ctrl/stusb4500-watchdog.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-WATCHDOG";
+
+    void NegotiationWatchdog::reset_ladder()
+    {
+        armed_ = false;
+        level_ = 0;
+        attempts_ = 0;
+        deadline_us_ = 0;
+        hard_reset_window_start_us_ = 0;
+        hard_resets_in_window_ = 0;
+    }
+
+    void NegotiationWatchdog::on_attach(int64_t now_us)
+    {
+        // Même attachement signalé deux fois (démarrage puis alerte PORT_STATUS) : l'échelle en cours continue
+        if (attached_)
+            return;
+
+        reset_ladder();
+        attached_ = true;
+        armed_ = true;
+        deadline_us_ = now_us + settings_.contract_deadline_us;
+    }
+
+    void NegotiationWatchdog::on_detach()
+    {
+        attached_ = false;
+        reset_ladder();
+    }
+
+    void NegotiationWatchdog::on_contract()
+    {
+        if (!attached_)
+            attached_ = true;
+
+        if (level_ > 0)
+            counters_.recoveries++;
+        armed_ = false;
+        level_ = 0;
+        attempts_ = 0;
+    }
+
+    void NegotiationWatchdog::escalate_now(int64_t now_us)
+    {
+        armed_ = true;
+        deadline_us_ = now_us;
+    }
+
+    void NegotiationWatchdog::on_hard_reset_received(int64_t now_us)
+    {
+        counters_.hard_resets_received++;
+        if (!attached_)
+            return;
+
+        if (hard_resets_in_window_ == 0 || now_us - hard_reset_window_start_us_ > settings_.hard_reset_window_us)
+        {
+            hard_reset_window_start_us_ = now_us;
+            hard_resets_in_window_ = 0;
+        }
+
+        // Un hard reset isolé fait partie du protocole ; une rafale signale un chargeur en boucle
+        if (++hard_resets_in_window_ >= settings_.hard_reset_limit)
+        {
+            hard_resets_in_window_ = 0;
+            if (level_ < static_cast<uint8_t>(Action::FallbackPdo) - 1)
+                level_ = static_cast<uint8_t>(Action::FallbackPdo) - 1;
+            escalate_now(now_us);
+        }
+        else if (!armed_)
+        {
+            armed_ = true;
+            deadline_us_ = now_us + settings_.contract_deadline_us;
+        }
+    }
+
+    void NegotiationWatchdog::on_cc_fault(int64_t now_us)
+    {
+        counters_.cc_faults++;
+        // Port vide : VBUS_DISCH_FAULT accompagne souvent le détachement, rien à reprendre
+        if (!attached_)
+            return;
+        escalate_now(now_us);
+    }
+
+    NegotiationWatchdog::Action NegotiationWatchdog::poll(int64_t now_us)
+    {
+        if (!armed_ || now_us < deadline_us_)
+            return Action::None;
+
+        counters_.deadlines_missed++;
+
+        // Échelle : soft reset -> hard reset -> repli 5 V, puis on reste au repli
+        const Action action = static_cast<Action>(level_ + 1);
+        if (level_ + 1 < static_cast<uint8_t>(Action::FallbackPdo))
+            level_++;
+        else
+            level_ = static_cast<uint8_t>(Action::FallbackPdo) - 1;
+
+        switch (action)
+        {
+        case Action::SoftReset:
+            counters_.soft_resets++;
+            break;
+        case Action::HardReset:
+            counters_.hard_resets++;
+            break;
+        case Action::FallbackPdo:
+            counters_.fallbacks++;
+            break;
+        default:
+            break;
+        }
+
+        // Attente exponentielle : deadline x 2^(nombre d'actions consécutives)
+        if (attempts_ < UINT8_MAX)
+            attempts_++;
+        int64_t backoff = settings_.contract_deadline_us;
+        for (uint8_t i = 1; i < attempts_ && backoff < settings_.backoff_max_us; ++i)
+            backoff *= 2;
+        if (backoff > settings_.backoff_max_us)
+            backoff = settings_.backoff_max_us;
+        deadline_us_ = now_us + backoff;
+
+        ESP_LOGW(TAG, "No contract: %s (next check in %lld ms)", to_string(action),
+                 static_cast<long long>(backoff / 1000));
+        return action;
+    }
+
+    void NegotiationWatchdog::on_action_failed(Action action, int64_t now_us)
+    {
+        if (action == Action::None || !armed_)
+            return;
+
+        // L'action n'a pas eu lieu : ni compteur, ni marche, ni doublement du délai
+        switch (action)
+        {
+        case Action::SoftReset:
+            counters_.soft_resets--;
+            break;
+        case Action::HardReset:
+            counters_.hard_resets--;
+            break;
+        case Action::FallbackPdo:
+            counters_.fallbacks--;
+            break;
+        default:
+            break;
+        }
+        counters_.failed_actions++;
+        level_ = static_cast<uint8_t>(action) - 1;
+        if (attempts_ > 0)
+            attempts_--;
+        deadline_us_ = now_us + settings_.failed_action_retry_us;
+    }
+
+    int64_t NegotiationWatchdog::time_to_deadline(int64_t now_us) const
+    {
+        if (!armed_)
+            return -1;
+        return deadline_us_ > now_us ? deadline_us_ - now_us : 0;
+    }
+
+    const char *NegotiationWatchdog::to_string(Action action)
+    {
+        switch (action)
+        {
+        case Action::SoftReset:   return "SOFT_RESET";
+        case Action::HardReset:   return "HARD_RESET";
+        case Action::FallbackPdo: return "FALLBACK_PDO";
+        default:                  return "NONE";
+        }
+    }
+
+    void NegotiationWatchdog::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Negotiation watchdog ---");
+        ESP_LOGI(TAG, "Armed            : %s (level %u)", armed_ ? "YES" : "NO", level_);
+        ESP_LOGI(TAG, "Soft/Hard resets : %u / %u", static_cast<unsigned>(counters_.soft_resets),
+                 static_cast<unsigned>(counters_.hard_resets));
+        ESP_LOGI(TAG, "Fallbacks        : %u", static_cast<unsigned>(counters_.fallbacks));
+        ESP_LOGI(TAG, "HR received      : %u", static_cast<unsigned>(counters_.hard_resets_received));
+        ESP_LOGI(TAG, "CC faults        : %u", static_cast<unsigned>(counters_.cc_faults));
+        ESP_LOGI(TAG, "Recoveries       : %u", static_cast<unsigned>(counters_.recoveries));
+        ESP_LOGI(TAG, "Failed actions   : %u", static_cast<unsigned>(counters_.failed_actions));
+#endif
+    }
+
+    std::string NegotiationWatchdog::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"armed\": " + std::string(armed_ ? "true" : "false") + ",";
+        json += "\"level\": " + std::to_string(level_) + ",";
+        json += "\"soft_resets\": " + std::to_string(counters_.soft_resets) + ",";
+        json += "\"hard_resets\": " + std::to_string(counters_.hard_resets) + ",";
+        json += "\"fallbacks\": " + std::to_string(counters_.fallbacks) + ",";
+        json += "\"hard_resets_received\": " + std::to_string(counters_.hard_resets_received) + ",";
+        json += "\"cc_faults\": " + std::to_string(counters_.cc_faults) + ",";
+        json += "\"deadlines_missed\": " + std::to_string(counters_.deadlines_missed) + ",";
+        json += "\"recoveries\": " + std::to_string(counters_.recoveries) + ",";
+        json += "\"failed_actions\": " + std::to_string(counters_.failed_actions);
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -1,4 +1,7 @@
 #include "nvm/stusb4500-nvm.hpp"
+#include "stusb4500-metrics.hpp"
+
+#include "esp_timer.h"
 
 #define RETURN_IF_ERROR(x)         \
     do {                           \
@@ -10,7 +13,19 @@
 
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-NVM";
+    /// Durée et issue d'une opération NVM, comptées en sortie de portée (échec par défaut)
+    class NvmOpTimer
+    {
+    public:
+        explicit NvmOpTimer(NvmOp op) : op_(op), start_(esp_timer_get_time()) {}
+        ~NvmOpTimer() { Metrics::instance().on_nvm(op_, esp_timer_get_time() - start_, ok_); }
+        void success() { ok_ = true; }
+
+    private:
+        NvmOp op_;
+        int64_t start_;
+        bool ok_ = false;
+    };
 
 
     esp_err_t NVM::write_ctrl0(uint8_t flags)
@@ -37,8 +52,26 @@ namespace stusb4500
 
     esp_err_t NVM::read(NVMData &nvm)
     {
+        NvmOpTimer timer(NvmOp::Read);
         std::array<uint8_t, NVM_TOTAL_SIZE> full_buffer;
 
+        esp_err_t err = read_sectors(full_buffer.data());
+        if (err == ESP_OK)
+            err = leave_ftp();
+        if (err != ESP_OK)
+        {
+            recover();
+            return err;
+        }
+
+        /** Décodage vers structure utilisateur */
+        nvm.decode(full_buffer.data());
+        timer.success();
+        return ESP_OK;
+    }
+
+    esp_err_t NVM::read_sectors(uint8_t *full_buffer)
+    {
         /** 2.2.1.1 – NVM Accessibility */
         uint8_t password = FTP_CUST_PASSWORD;
         RETURN_IF_ERROR(write_register(REG_FTP_KEY, &password, 1));
@@ -58,26 +91,53 @@ namespace stusb4500
             RETURN_IF_ERROR(read_register(REG_RW_BUFFER, &full_buffer[sector * NVM_SECTOR_SIZE], NVM_SECTOR_SIZE));
 
         }
+        return ESP_OK;
+    }
 
-        uint8_t ctrl_reset[] = {FTP_CUST_PWR, 0x00}; // 0x40, 0x00
-        RETURN_IF_ERROR(write_register(REG_FTP_CTRL_0, ctrl_reset, 2)); // écrit dans 0x96 et 0x97
+    esp_err_t NVM::write(const NVMData &nvm)
+    {
+        nvm.log();
+        return write(nvm.to_array());
+    }
 
-        uint8_t lock = 0x00;
-        RETURN_IF_ERROR(write_register(REG_FTP_KEY, &lock, 1));
+    esp_err_t NVM::write(const std::array<uint8_t, 40> &image)
+    {
+        NvmOpTimer timer(NvmOp::Write);
+        esp_err_t err;
 
-        /** Décodage vers structure utilisateur */
-        nvm.decode(full_buffer.data());
+        err = program(image.data());
+        if (err == ESP_OK)
+            err = leave_ftp();
+        if (err != ESP_OK)
+        {
+            recover();
+            return err;
+        }
+
+        // Post-vérification
+        ConfigParams cfg_data;
+        NVMData readback(cfg_data);
+        err = read(readback);
+        readback.log();
+        if (err != ESP_OK)
+            return err;
+
+        if (!readback.equals(image))
+        {
+            ESP_LOGW(TAG, "Échec de vérification post-écriture : contenu NVM différent !");
+            readback.print_diff(image);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+
+        timer.success();
         return ESP_OK;
     }
 
-    esp_err_t NVM::write(const NVMData &nvm)
+    esp_err_t NVM::program(const uint8_t *raw_nvm)
     {
-        esp_err_t err;
-        std::array<uint8_t, NVM_TOTAL_SIZE> raw_nvm = nvm.to_array();
         // 1. NVM Accessibility
-         uint8_t password = FTP_CUST_PASSWORD;
-         RETURN_IF_ERROR(write_register(REG_FTP_KEY, &password, 1));
- 
+        uint8_t password = FTP_CUST_PASSWORD;
+        RETURN_IF_ERROR(write_register(REG_FTP_KEY, &password, 1));
 
         // 2. NVM Power-up Sequence
         uint8_t data = 0x00;
@@ -123,34 +183,34 @@ namespace stusb4500
             RETURN_IF_ERROR(write_ctrl0(FTP_CUST_RST_N | FTP_CUST_REQ | (sector & 0x07)));  
             esp_rom_delay_us(2000);
         }
+        return ESP_OK;
+    }
 
-        // Sortie du mode test
+    esp_err_t NVM::leave_ftp()
+    {
+        // Sortie du mode test, puis clé effacée : tentée même si la première écriture échoue
         uint8_t ctrl_reset[] = {FTP_CUST_PWR, 0x00}; // 0x40, 0x00
-        RETURN_IF_ERROR(write_register(REG_FTP_CTRL_0, ctrl_reset, 2)); // écrit dans 0x96 et 0x97
-
-        uint8_t lock = FTP_CUST_PASSWORD;
-        RETURN_IF_ERROR(write_register(REG_FTP_KEY, &lock, 1));
-
+        esp_err_t err = write_register(REG_FTP_CTRL_0, ctrl_reset, 2); // écrit dans 0x96 et 0x97
 
-        // Post-vérification
-        ConfigParams cfg_data;
-        NVMData readback(cfg_data);
-        err = read(readback);
-        readback.log();
-        nvm.log();
-        if (err != ESP_OK)
-            return err;
-
-        std::array<uint8_t, 40> reread = readback.to_array();
-
-        if (!nvm.equals(reread))
-        {
-            ESP_LOGW(TAG, "Échec de vérification post-écriture : contenu NVM différent !");
-            nvm.print_diff(reread);
-            return ESP_ERR_INVALID_RESPONSE;
-        }
+        uint8_t lock = FTP_KEY_LOCK;
+        esp_err_t lock_err = write_register(REG_FTP_KEY, &lock, 1);
+        return err != ESP_OK ? err : lock_err;
+    }
 
-        return ESP_OK;
+    void NVM::recover()
+    {
+        const int64_t start = esp_timer_get_time();
+        esp_err_t err = ESP_FAIL;
+        for (int attempt = 0; attempt < RECOVERY_ATTEMPTS && err != ESP_OK; ++attempt)
+            err = leave_ftp();
+
+        const int64_t duration_us = esp_timer_get_time() - start;
+        Metrics::instance().on_recovery(RecoveryKind::Nvm, duration_us, err == ESP_OK);
+        if (err == ESP_OK)
+            ESP_LOGW(TAG, "Séquence NVM interrompue : FTP reverrouillé en %lld us", static_cast<long long>(duration_us));
+        else
+            ESP_LOGE(TAG, "Séquence NVM interrompue : FTP non reverrouillé après %d tentatives (err=0x%x)",
+                     RECOVERY_ATTEMPTS, err);
     }
 
 } // namespace stusb4500
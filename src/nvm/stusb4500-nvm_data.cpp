@@ -3,37 +3,17 @@
 #include "esp_log.h"
 
 #include "nvm/stusb4500-nvm_data.hpp"
+#include "stusb4500-output.hpp"
 
 namespace stusb4500
 {
 
-    void NVMData::decode(const uint8_t *buffer)
-    {
-        bank1.decode(&buffer[8]);
-        bank3.decode(&buffer[24]);
-        bank4.decode(&buffer[32]);
-    }
-
-    void NVMData::encode(uint8_t *buffer) const
-    {
-        bank1.encode(&buffer[8]);
-        bank3.encode(&buffer[24]);
-        bank4.encode(&buffer[32]);
-    }
-
-    const std::array<uint8_t, 40> NVMData::default_nvm_map = {
-        0x00, 0x00, 0xB0, 0xAA, 0x00, 0x45, 0x00, 0x00,
-        0x10, 0x40, 0x9C, 0x1C, 0xFF, 0x01, 0x3C, 0xDF,
-        0x02, 0x40, 0x0F, 0x00, 0x32, 0x00, 0xFC, 0xF1,
-        0x00, 0x19, 0x56, 0xAF, 0xF5, 0x35, 0x5F, 0x00,
-        0x00, 0x4B, 0x90, 0x21, 0x43, 0x00, 0x40, 0xFB};
-
-    std::array<uint8_t, 40> NVMData::to_array() const
-    {
-        std::array<uint8_t, 40> result = default_nvm_map;
-        encode(result.data());
-        return result;
-    }
+    // Décoder puis ré-encoder l'image d'usine doit la restituer à l'identique
+    static_assert([] {
+        ConfigParams cfg;
+        NVMLayout::decode(cfg, NVMData::default_nvm_map.data());
+        return NVMData::encode_image(cfg) == NVMData::default_nvm_map;
+    }(), "NVM bank codec does not round-trip the default image");
 
     bool NVMData::equals(const std::array<uint8_t, 40> &other) const
     {
@@ -57,6 +37,7 @@ namespace stusb4500
 
     void NVMData::print_diff(const std::array<uint8_t, 40> &other) const
     {
+#if STUSB4500_LOG_TEXT
         auto diffs = diff(other);
         for (const auto &[i, before, after] : diffs)
         {
@@ -69,10 +50,12 @@ namespace stusb4500
         {
             ESP_LOGW(TAG, "Aucune différence détectée dans la NVM.");
         }
+#endif
     }
 
     void NVMData::log() const
     {
+#if STUSB4500_LOG_TEXT
         auto buffer = to_array();
 
         ESP_LOGI(TAG, "Contenu brut NVM :");
@@ -86,6 +69,7 @@ namespace stusb4500
             }
             ESP_LOGI(TAG, "%s", line);
         }
+#endif
     }
 
 } // namespace stusb4500
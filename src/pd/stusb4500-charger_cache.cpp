@@ -0,0 +1,306 @@
+#include "pd/stusb4500-charger_cache.hpp"
+#include "storage/stusb4500-kv_store.hpp"
+#include "stusb4500-fields.hpp"
+#include "stusb4500-output.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-CHG_CACHE";
+
+    // Sérialisation : version, nombre d'entrées, contexte, puis ENTRY_SIZE octets par entrée
+    static constexpr std::size_t HEADER_SIZE = 1 + 1 + 4;
+    static constexpr std::size_t ENTRY_SIZE = 4 + 4 + 3 * 4 + 1 + 4;
+
+    void ChargerEntry::to_profile(PowerProfile &power) const
+    {
+        for (std::size_t i = 0; i < sink_pdos.size(); ++i)
+            power.decode(sink_pdos[i], i);
+        power.pdo_number = pdo_number;
+    }
+
+    uint32_t ChargerCache::fingerprint(const uint32_t *objects, std::size_t count)
+    {
+        uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; objects != nullptr && i < count; ++i)
+        {
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                hash ^= (objects[i] >> shift) & 0xFF;
+                hash *= 16777619u;
+            }
+        }
+        return hash ? hash : 1;
+    }
+
+    uint32_t ChargerCache::fingerprint(const SourceCapabilities &caps)
+    {
+        uint32_t objects[SourceCapabilities::MAX_OBJECTS] = {0};
+        for (std::size_t i = 0; i < caps.size(); ++i)
+            objects[i] = caps[i].raw;
+        return fingerprint(objects, caps.size());
+    }
+
+    uint32_t ChargerCache::context_of(const PowerProfile &configured, const LoadProfile *load)
+    {
+        uint32_t words[8] = {0};
+        for (std::size_t i = 0; i < configured.pdos.size(); ++i)
+            words[i] = configured.encode(i);
+        words[3] = configured.pdo_number;
+        if (load == nullptr)
+            return fingerprint(words, 4);
+
+        // Tables choisies par la politique : elles dépendent aussi des besoins déclarés
+        words[4] = static_cast<uint32_t>(load->max_voltage_mv) << 16 | load->min_voltage_mv;
+        words[5] = load->required_power_mw;
+        words[6] = load->max_current_ma;
+        words[7] = static_cast<uint32_t>(load->preference) | 1u << 8;
+        return fingerprint(words, 8);
+    }
+
+    const ChargerEntry *ChargerCache::find(uint32_t fingerprint)
+    {
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            if (entries_[i].used() && entries_[i].fingerprint == fingerprint)
+            {
+                entries_[i].last_used = ++clock_;
+                return &entries_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const ChargerEntry *ChargerCache::most_recent() const
+    {
+        const ChargerEntry *latest = nullptr;
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            if (entries_[i].used() && (latest == nullptr || entries_[i].last_used > latest->last_used))
+                latest = &entries_[i];
+        }
+        return latest;
+    }
+
+    bool ChargerCache::remember(uint32_t fingerprint, const PowerProfile &power, uint32_t rdo)
+    {
+        if (CAPACITY == 0)
+            return false;
+
+        ChargerEntry entry;
+        entry.fingerprint = fingerprint;
+        entry.last_used = ++clock_;
+        for (std::size_t i = 0; i < entry.sink_pdos.size(); ++i)
+            entry.sink_pdos[i] = power.encode(i);
+        entry.pdo_number = power.pdo_number;
+        entry.rdo = rdo;
+
+        // Entrée existante, sinon slot libre, sinon la moins récemment utilisée
+        std::size_t slot = CAPACITY;
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            if (entries_[i].fingerprint == fingerprint)
+            {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == CAPACITY)
+        {
+            slot = 0;
+            for (std::size_t i = 0; i < CAPACITY; ++i)
+            {
+                if (!entries_[i].used())
+                {
+                    slot = i;
+                    break;
+                }
+                if (entries_[i].last_used < entries_[slot].last_used)
+                    slot = i;
+            }
+        }
+
+        ChargerEntry &target = entries_[slot];
+        const bool changed = target.fingerprint != entry.fingerprint || target.sink_pdos != entry.sink_pdos ||
+                             target.pdo_number != entry.pdo_number || target.rdo != entry.rdo;
+        target = entry;
+        dirty_ |= changed;
+        return changed;
+    }
+
+    bool ChargerCache::forget(uint32_t fingerprint)
+    {
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            if (entries_[i].used() && entries_[i].fingerprint == fingerprint)
+            {
+                entries_[i] = {};
+                dirty_ = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ChargerCache::set_context(uint32_t context)
+    {
+        if (context == context_)
+            return false;
+
+        // Le contexte est sauvegardé avec les entrées, même si le cache est vide
+        context_ = context;
+        dirty_ = true;
+        if (size() == 0)
+            return false;
+        ESP_LOGI(TAG, "Configuration changed: forgetting %u known chargers", static_cast<unsigned>(size()));
+        entries_ = {};
+        clock_ = 0;
+        return true;
+    }
+
+    void ChargerCache::clear()
+    {
+        entries_ = {};
+        clock_ = 0;
+        dirty_ = true;
+    }
+
+    std::size_t ChargerCache::size() const
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+            count += entries_[i].used() ? 1 : 0;
+        return count;
+    }
+
+    esp_err_t ChargerCache::load(KeyValueStore &store)
+    {
+        uint8_t buffer[HEADER_SIZE + STORAGE * ENTRY_SIZE] = {0};
+
+        // Taille du blob d'abord : un cache écrit avec un CONFIG_STUSB4500_CHARGER_CACHE_SIZE plus grand
+        // ferait échouer la lecture (ESP_ERR_NVS_INVALID_LENGTH)
+        size_t len = 0;
+        esp_err_t err = store.get(STORE_KEY, nullptr, len);
+        if (err != ESP_OK)
+            return err;
+        if (len > sizeof(buffer))
+        {
+            ESP_LOGW(TAG, "Ignoring oversized charger cache (%u bytes, %u max)", static_cast<unsigned>(len),
+                     static_cast<unsigned>(sizeof(buffer)));
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        err = store.get(STORE_KEY, buffer, len);
+        if (err != ESP_OK)
+            return err;
+
+        if (len < HEADER_SIZE || buffer[0] != STORE_VERSION || len < HEADER_SIZE + buffer[1] * ENTRY_SIZE)
+        {
+            ESP_LOGW(TAG, "Ignoring incompatible charger cache (%u bytes)", static_cast<unsigned>(len));
+            return ESP_ERR_INVALID_VERSION;
+        }
+
+        entries_ = {};
+        clock_ = 0;
+        const uint32_t stored_context = load_le32(buffer + 2);
+        if (context_ != 0 && stored_context != context_)
+        {
+            // Tables choisies sous une autre configuration : rien à restaurer
+            ESP_LOGI(TAG, "Ignoring charger cache saved under another configuration");
+            dirty_ = true;
+            return ESP_OK;
+        }
+        context_ = stored_context;
+
+        const std::size_t count = buffer[1] < CAPACITY ? buffer[1] : CAPACITY;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const uint8_t *p = buffer + HEADER_SIZE + i * ENTRY_SIZE;
+            ChargerEntry &entry = entries_[i];
+            entry.fingerprint = load_le32(p);
+            entry.last_used = load_le32(p + 4);
+            for (std::size_t j = 0; j < entry.sink_pdos.size(); ++j)
+                entry.sink_pdos[j] = load_le32(p + 8 + j * 4);
+            entry.pdo_number = p[20];
+            entry.rdo = load_le32(p + 21);
+            if (entry.last_used > clock_)
+                clock_ = entry.last_used;
+        }
+        dirty_ = false;
+        return ESP_OK;
+    }
+
+    esp_err_t ChargerCache::save(KeyValueStore &store)
+    {
+        uint8_t buffer[HEADER_SIZE + STORAGE * ENTRY_SIZE] = {0};
+        buffer[0] = STORE_VERSION;
+        store_le32(context_, buffer + 2);
+
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            const ChargerEntry &entry = entries_[i];
+            if (!entry.used())
+                continue;
+
+            uint8_t *p = buffer + HEADER_SIZE + count * ENTRY_SIZE;
+            store_le32(entry.fingerprint, p);
+            store_le32(entry.last_used, p + 4);
+            for (std::size_t j = 0; j < entry.sink_pdos.size(); ++j)
+                store_le32(entry.sink_pdos[j], p + 8 + j * 4);
+            p[20] = entry.pdo_number;
+            store_le32(entry.rdo, p + 21);
+            count++;
+        }
+        buffer[1] = static_cast<uint8_t>(count);
+
+        esp_err_t err = store.set(STORE_KEY, buffer, HEADER_SIZE + count * ENTRY_SIZE);
+        if (err == ESP_OK)
+            dirty_ = false;
+        return err;
+    }
+
+    void ChargerCache::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Known chargers (%u/%u) ---", static_cast<unsigned>(size()), static_cast<unsigned>(CAPACITY));
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            const ChargerEntry &entry = entries_[i];
+            if (!entry.used())
+                continue;
+            ESP_LOGI(TAG, " 0x%08" PRIX32 "  PDOs=%u  RDO=0x%08" PRIX32 "  lru=%" PRIu32,
+                     entry.fingerprint, entry.pdo_number, entry.rdo, entry.last_used);
+        }
+#endif
+    }
+
+    std::string ChargerCache::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "[";
+        bool first = true;
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            const ChargerEntry &entry = entries_[i];
+            if (!entry.used())
+                continue;
+            if (!first)
+                json += ",";
+            first = false;
+            json += "{\"fingerprint\": " + std::to_string(entry.fingerprint) + ",";
+            json += "\"pdo_number\": " + std::to_string(entry.pdo_number) + ",";
+            json += "\"rdo\": " + std::to_string(entry.rdo) + ",";
+            json += "\"last_used\": " + std::to_string(entry.last_used) + "}";
+        }
+        json += "]";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -2,18 +2,17 @@
 
 #include "esp_log.h"
 
+#include <cstring>
+
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-PDO";
-
     PDO::PDO(I2CDevices &dev,
             const size_t index,
             const PDObjectProfile& pdo_profile)
         : INTERFACE(dev),
         index_(index)
         {
-        power_.pdos.clear();
-        power_.pdos.push_back(pdo_profile);
+        power_.pdos[0] = pdo_profile;
         power_.pdo_number = 1;
         };
 
@@ -21,7 +20,7 @@ namespace stusb4500
     {
         if (index_ < 1 || index_ > 3)
         {
-            ESP_LOGE(TAG, "Invalid PDO index %u (must be 1, 2 or 3)", index_);
+            ESP_LOGE(TAG, "Invalid PDO index %u (must be 1, 2 or 3)", static_cast<unsigned>(index_));
             return ESP_ERR_INVALID_ARG;
         }
 
@@ -31,13 +30,17 @@ namespace stusb4500
         esp_err_t err = read_register(reg, buffer, sizeof(buffer));
         if (err != ESP_OK)
         {
-            ESP_LOGE(TAG, "Failed to read PDO[%u] at reg 0x%02X (err=0x%x)", index_, reg, err);
+            ESP_LOGE(TAG, "Failed to read PDO[%u] at reg 0x%02X (err=0x%x)", static_cast<unsigned>(index_), reg, err);
             return err;
         }
 
-        uint32_t raw = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (buffer[3] << 24);
+        uint32_t raw = static_cast<uint32_t>(buffer[0]) |
+                       (static_cast<uint32_t>(buffer[1]) << 8) |
+                       (static_cast<uint32_t>(buffer[2]) << 16) |
+                       (static_cast<uint32_t>(buffer[3]) << 24);
 
-        power_.decode(raw,0);
+        // PDO2/PDO3 : bits de drapeaux réservés, ignorés
+        power_.decode(index_ == 1 ? raw : raw & ~PowerProfile::PDO1_FLAGS, 0);
 
         return ESP_OK;
     }
@@ -46,11 +49,13 @@ namespace stusb4500
     {
         if (index_ < 1 || index_ > 3)
         {
-            ESP_LOGE(TAG, "Invalid PDO index %u (must be 1, 2 or 3)", index_);
+            ESP_LOGE(TAG, "Invalid PDO index %u (must be 1, 2 or 3)", static_cast<unsigned>(index_));
             return ESP_ERR_INVALID_ARG;
         }
 
         uint32_t raw = power_.encode(0);
+        if (index_ != 1)
+            raw &= ~PowerProfile::PDO1_FLAGS;
 
         uint8_t buffer[4];
         buffer[0] = raw & 0xFF;
@@ -63,9 +68,80 @@ namespace stusb4500
         esp_err_t err = write_register(reg, buffer, sizeof(buffer));
         if (err != ESP_OK)
         {
-            ESP_LOGE(TAG, "Failed to write PDO[%u] at reg 0x%02X (err=0x%x)", index_, reg, err);
+            ESP_LOGE(TAG, "Failed to write PDO[%u] at reg 0x%02X (err=0x%x)", static_cast<unsigned>(index_), reg, err);
             return err;
         }
         return ESP_OK;
     }
-} // namespace stusb4500
\ No newline at end of file
+
+    esp_err_t PDOTable::read()
+    {
+        uint8_t buffer[PDOTable::table_len] = {0};
+        esp_err_t err = read_register(PDOTable::base_reg_addr, buffer, sizeof(buffer));
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to read PDO table at reg 0x%02X (err=0x%x)", PDOTable::base_reg_addr, err);
+            return err;
+        }
+
+        uint8_t count = 0;
+        err = read_u8(PDOTable::pdo_number_reg, count);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to read PDO number at reg 0x%02X (err=0x%x)", PDOTable::pdo_number_reg, err);
+            return err;
+        }
+
+        for (size_t i = 0; i < power_.pdos.size(); ++i)
+            power_.decode(load_le32(buffer + i * PDOTable::pdo_len), i);
+        power_.pdo_number = count & 0x07;
+        return ESP_OK;
+    }
+
+    esp_err_t PDOTable::write(bool verify)
+    {
+        uint8_t count = power_.pdo_number;
+        if (count < 1 || count > power_.pdos.size())
+        {
+            ESP_LOGE(TAG, "Invalid PDO count: %u", count);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        uint8_t buffer[PDOTable::table_len];
+        for (size_t i = 0; i < power_.pdos.size(); ++i)
+            store_le32(power_.encode(i), buffer + i * PDOTable::pdo_len);
+
+        esp_err_t err = write_register(PDOTable::base_reg_addr, buffer, sizeof(buffer));
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to write PDO table at reg 0x%02X (err=0x%x)", PDOTable::base_reg_addr, err);
+            return err;
+        }
+
+        err = write_register(PDOTable::pdo_number_reg, &count, 1);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to write PDO number at reg 0x%02X (err=0x%x)", PDOTable::pdo_number_reg, err);
+            return err;
+        }
+
+        if (!verify)
+            return ESP_OK;
+
+        uint8_t readback[PDOTable::table_len] = {0};
+        uint8_t readback_count = 0;
+        if (read_register(PDOTable::base_reg_addr, readback, sizeof(readback)) != ESP_OK ||
+            read_u8(PDOTable::pdo_number_reg, readback_count) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "PDO table readback failed");
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+
+        if (std::memcmp(buffer, readback, sizeof(buffer)) != 0 || (readback_count & 0x07) != count)
+        {
+            ESP_LOGE(TAG, "PDO table readback mismatch");
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        return ESP_OK;
+    }
+} // namespace stusb4500
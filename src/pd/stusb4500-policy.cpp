@@ -0,0 +1,175 @@
+#include "pd/stusb4500-policy.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-POLICY";
+
+    bool SinkPlan::same_pdos(const PowerProfile &power) const
+    {
+        if (power.pdo_number != pdo_number)
+            return false;
+
+        // PDO1 compris : son courant est plafonné par vSafe5V et la limite de la charge
+        for (size_t i = 0; i < pdo_number; ++i)
+        {
+            if (power.pdos[i].voltage_mv != pdos[i].voltage_mv ||
+                power.pdos[i].current_ma != pdos[i].current_ma)
+                return false;
+        }
+        return true;
+    }
+
+    bool ContractPolicy::better(const SourcePDO &a, uint32_t power_a,
+                                const SourcePDO &b, uint32_t power_b,
+                                const LoadProfile &load)
+    {
+        // Un PDO qui couvre le besoin l'emporte toujours sur un PDO qui ne le couvre pas
+        const bool a_ok = power_a >= load.required_power_mw;
+        const bool b_ok = power_b >= load.required_power_mw;
+        if (a_ok != b_ok)
+            return a_ok;
+
+        switch (load.preference)
+        {
+        case LoadProfile::Preference::LowestVoltage:
+            if (a_ok && a.max_voltage_mv != b.max_voltage_mv)
+                return a.max_voltage_mv < b.max_voltage_mv;
+            return power_a > power_b;
+
+        case LoadProfile::Preference::HighestVoltage:
+            if (a.max_voltage_mv != b.max_voltage_mv)
+                return a.max_voltage_mv > b.max_voltage_mv;
+            return power_a > power_b;
+
+        case LoadProfile::Preference::MaxPower:
+        default:
+            if (power_a != power_b)
+                return power_a > power_b;
+            // À puissance égale, moins de pertes avec la tension la plus basse
+            return a.max_voltage_mv < b.max_voltage_mv;
+        }
+    }
+
+    SinkPlan ContractPolicy::select(const SourceCapabilities &caps,
+                                    const LoadProfile &load,
+                                    const PDObjectProfile &pdo1)
+    {
+        SinkPlan plan = {};
+        plan.pdos[0] = pdo1;
+        plan.pdos[0].voltage_mv = 5000;
+        plan.pdos[0].defined = true;
+
+        // Deux meilleurs candidats au-dessus de 5 V : best -> PDO3, second -> PDO2
+        int best = -1;
+        int second = -1;
+        uint32_t best_power = 0;
+        uint32_t second_power = 0;
+
+        for (size_t i = 0; i < caps.size(); ++i)
+        {
+            const SourcePDO &src = caps[i];
+            if (src.type != SourcePDOType::Fixed || src.max_voltage_mv <= 5000)
+                continue;
+            if (src.max_voltage_mv < load.min_voltage_mv || src.max_voltage_mv > load.max_voltage_mv)
+                continue;
+
+            const uint16_t current = src.max_current_ma < load.max_current_ma ? src.max_current_ma : load.max_current_ma;
+            const uint32_t power = static_cast<uint32_t>(src.max_voltage_mv) * current / 1000;
+
+            if (best < 0 || better(src, power, caps[best], best_power, load))
+            {
+                second = best;
+                second_power = best_power;
+                best = static_cast<int>(i);
+                best_power = power;
+            }
+            else if (second < 0 || better(src, power, caps[second], second_power, load))
+            {
+                second = static_cast<int>(i);
+                second_power = power;
+            }
+        }
+
+        // Repli sur 5 V : le courant du PDO1 est borné par l'offre vSafe5V de la source
+        // (toujours un PDO fixe en position 1, sauf Source_Capabilities malformé)
+        const SourcePDO *vsafe5v = caps.at_position(1);
+        if (vsafe5v != nullptr && vsafe5v->type == SourcePDOType::Fixed)
+        {
+            const uint16_t limit = vsafe5v->max_current_ma < load.max_current_ma ? vsafe5v->max_current_ma : load.max_current_ma;
+            if (plan.pdos[0].current_ma > limit)
+                plan.pdos[0].current_ma = limit;
+            plan.source_position = 1;
+            plan.expected_power_mw = 5u * plan.pdos[0].current_ma;
+        }
+
+        auto fill = [&](size_t slot, int index) {
+            const SourcePDO &src = caps[index];
+            PDObjectProfile &pdo = plan.pdos[slot];
+            pdo = pdo1;
+            pdo.voltage_mv = src.max_voltage_mv;
+            pdo.current_ma = src.max_current_ma < load.max_current_ma ? src.max_current_ma : load.max_current_ma;
+            pdo.defined = true;
+        };
+
+        if (best >= 0 && second >= 0)
+        {
+            fill(1, second);
+            fill(2, best);
+            plan.pdo_number = 3;
+        }
+        else if (best >= 0)
+        {
+            fill(1, best);
+            plan.pdo_number = 2;
+        }
+
+        if (best >= 0)
+        {
+            plan.source_position = static_cast<uint8_t>(best + 1);
+            plan.expected_power_mw = best_power;
+        }
+
+        plan.meets_requirement = plan.source_position != 0 && plan.expected_power_mw >= load.required_power_mw;
+        return plan;
+    }
+
+    void SinkPlan::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Sink plan ---");
+        for (size_t i = 0; i < pdo_number; ++i)
+        {
+            ESP_LOGI(TAG, " PDO%u : %5u mV  %4u mA", static_cast<unsigned>(i + 1),
+                     pdos[i].voltage_mv, pdos[i].current_ma);
+        }
+        ESP_LOGI(TAG, "Source PDO visé  : %u", source_position);
+        ESP_LOGI(TAG, "Puissance prévue : %u mW (%s)", static_cast<unsigned>(expected_power_mw),
+                 meets_requirement ? "OK" : "insuffisante");
+#endif
+    }
+
+    std::string SinkPlan::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{\"pdos\": [";
+        for (size_t i = 0; i < pdo_number; ++i)
+        {
+            if (i)
+                json += ",";
+            json += pdos[i].to_json();
+        }
+        json += "],";
+        json += "\"source_position\": " + std::to_string(source_position) + ",";
+        json += "\"expected_power_mw\": " + std::to_string(expected_power_mw) + ",";
+        json += "\"meets_requirement\": " + std::string(meets_requirement ? "true" : "false");
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
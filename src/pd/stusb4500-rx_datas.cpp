@@ -1,41 +1,75 @@
 #include "pd/stusb4500-rx_datas.hpp"
+#include "stusb4500-output.hpp"
 #include "esp_log.h"
 
+#include <cinttypes>
+
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-RXDATAS";
-
-    esp_err_t RXDatas::read()
+    esp_err_t RXDatas::read(int expected_objects)
     {
         uint8_t buffer[RXDatas::reg_len] = {0};
 
-        esp_err_t err = read_register(RXDatas::reg_addr, buffer, sizeof(buffer));
+        // Phase 1 : header seul, ou rafale unique dimensionnée par l'appelant
+        size_t fetched = header_len;
+        if (expected_objects > 0)
+            fetched += static_cast<size_t>(expected_objects < 7 ? expected_objects : 7) * object_len;
+
+        esp_err_t err = read_register(RXDatas::reg_addr, buffer, fetched);
         if (err != ESP_OK)
         {
             ESP_LOGE(TAG, "Failed to read RXDatas at reg 0x%02X (err=0x%x)", RXDatas::reg_addr, err);
             return err;
         }
 
-        decode(buffer, sizeof(buffer));
+        // Phase 2 : uniquement les objets annoncés par le header et pas encore lus
+        const uint16_t header = buffer[0] | (buffer[1] << 8);
+        const size_t needed = header_len + PDHeader::num_objects(header) * object_len;
+        if (needed > fetched)
+        {
+            err = read_register(RXDatas::reg_addr + fetched, buffer + fetched, needed - fetched);
+            if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Failed to read RX data objects at reg 0x%02X (err=0x%x)",
+                         static_cast<unsigned>(RXDatas::reg_addr + fetched), err);
+                return err;
+            }
+            fetched = needed;
+        }
+
+        Metrics::instance().on_rx_bytes_saved(RXDatas::reg_len - fetched);
+        decode(buffer, needed);
         return ESP_OK;
     }
 
     void RXDatas::decode(const uint8_t *buf, size_t len)
     {
-        if (len >= 2)
+        header_ = 0;
+        objects_ = 0;
+        for (auto &obj : data_)
+            obj = 0;
+
+        if (buf == nullptr || len < 2)
+            return;
+
+        header_ = buf[0] | (buf[1] << 8);
+
+        // Le header annonce jusqu'à 7 objets : on ne décode que ceux réellement présents
+        size_t announced = PDHeader::num_objects(header_);
+        size_t available = (len - 2) / 4;
+        if (available < announced)
         {
-            header_ = buf[0] | (buf[1] << 8);
-            size_t expected = num_objects() * 4;
-            if (len >= 2 + expected)
-            {
-                for (size_t i = 0; i < num_objects() && i < 7; ++i)
-                {
-                    data_[i] = (buf[2 + i * 4]) |
-                               (buf[3 + i * 4] << 8) |
-                               (buf[4 + i * 4] << 16) |
-                               (buf[5 + i * 4] << 24);
-                }
-            }
+            ESP_LOGW(TAG, "Truncated RX message: %u objects announced, %u received",
+                     static_cast<unsigned>(announced), static_cast<unsigned>(available));
+        }
+        objects_ = static_cast<uint8_t>(available < announced ? available : announced);
+
+        for (size_t i = 0; i < objects_; ++i)
+        {
+            data_[i] = static_cast<uint32_t>(buf[2 + i * 4]) |
+                       (static_cast<uint32_t>(buf[3 + i * 4]) << 8) |
+                       (static_cast<uint32_t>(buf[4 + i * 4]) << 16) |
+                       (static_cast<uint32_t>(buf[5 + i * 4]) << 24);
         }
     }
 
@@ -46,12 +80,12 @@ namespace stusb4500
 
     uint8_t RXDatas::message_type() const
     {
-        return header_ & 0x0F;
+        return PDHeader::message_type(header_);
     }
 
     uint8_t RXDatas::num_objects() const
     {
-        return (header_ >> 12) & 0x07;
+        return objects_;
     }
 
     bool RXDatas::is_data_message() const
@@ -64,6 +98,25 @@ namespace stusb4500
         return num_objects() == 0;
     }
 
+    bool RXDatas::is_source_capabilities() const
+    {
+        return is_data_message() && message_type() == SOURCE_CAPABILITIES;
+    }
+
+    uint32_t RXDatas::data_object(size_t index) const
+    {
+        return index < num_objects() ? data_[index] : 0;
+    }
+
+    bool RXDatas::source_capabilities(SourceCapabilities &out) const
+    {
+        if (!is_source_capabilities())
+            return false;
+
+        out.decode(data_, num_objects());
+        return true;
+    }
+
     PowerProfile RXDatas::get_pdo(size_t index) const
     {
         if (index < num_objects() && index < 7) {
@@ -77,15 +130,21 @@ namespace stusb4500
 
     void RXDatas::log() const
     {
+#if STUSB4500_LOG_TEXT
         ESP_LOGI(TAG, "--- RXDatas ---");
         ESP_LOGI(TAG, "Header           : 0x%04X", header_);
         ESP_LOGI(TAG, "Message Type     : %u", message_type());
         ESP_LOGI(TAG, "Num Data Objects : %u", num_objects());
-        for (size_t i = 0; i < num_objects() && i < 7; ++i)
+        if (is_source_capabilities())
         {
-            ESP_LOGI(TAG, " ------------ PDO%zu ------------ ", (i)); 
-            get_pdo(i).log();
+            SourceCapabilities caps;
+            source_capabilities(caps);
+            caps.log();
+            return;
         }
+        for (size_t i = 0; i < num_objects(); ++i)
+            ESP_LOGI(TAG, " Object%zu         : 0x%08" PRIX32, i, data_[i]);
+#endif
     }
 
 
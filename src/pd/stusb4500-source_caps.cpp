@@ -0,0 +1,207 @@
+#include "pd/stusb4500-source_caps.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-SRC_CAPS";
+
+    SourcePDO SourcePDO::decode(uint32_t raw)
+    {
+        SourcePDO pdo = {};
+        pdo.raw = raw;
+
+        switch (TYPE.decode(raw))
+        {
+        case 0b00: // Fixed supply
+            pdo.type = SourcePDOType::Fixed;
+            pdo.min_voltage_mv = pdo.max_voltage_mv = FIXED_VOLTAGE.decode(raw);
+            pdo.max_current_ma = FIXED_MAX_CURRENT.decode(raw);
+            pdo.max_power_mw = static_cast<uint32_t>(pdo.max_voltage_mv) * pdo.max_current_ma / 1000;
+            pdo.dual_role_power = FIXED_DUAL_ROLE_POWER.test(raw);
+            pdo.usb_suspend_supported = FIXED_USB_SUSPEND.test(raw);
+            pdo.unconstrained_power = FIXED_UNCONSTRAINED_POWER.test(raw);
+            pdo.usb_comm_capable = FIXED_USB_COMM_CAPABLE.test(raw);
+            pdo.dual_role_data = FIXED_DUAL_ROLE_DATA.test(raw);
+            pdo.unchunked_ext = FIXED_UNCHUNKED_EXT.test(raw);
+            pdo.epr_capable = FIXED_EPR_CAPABLE.test(raw);
+            pdo.peak_current = FIXED_PEAK_CURRENT.decode(raw);
+            break;
+
+        case 0b01: // Battery
+            pdo.type = SourcePDOType::Battery;
+            pdo.max_voltage_mv = RANGE_MAX_VOLTAGE.decode(raw);
+            pdo.min_voltage_mv = RANGE_MIN_VOLTAGE.decode(raw);
+            pdo.max_power_mw = BATTERY_MAX_POWER.decode(raw);
+            if (pdo.min_voltage_mv)
+            {
+                uint32_t current = pdo.max_power_mw * 1000 / pdo.min_voltage_mv;
+                pdo.max_current_ma = current > UINT16_MAX ? UINT16_MAX : current;
+            }
+            break;
+
+        case 0b10: // Variable supply
+            pdo.type = SourcePDOType::Variable;
+            pdo.max_voltage_mv = RANGE_MAX_VOLTAGE.decode(raw);
+            pdo.min_voltage_mv = RANGE_MIN_VOLTAGE.decode(raw);
+            pdo.max_current_ma = VARIABLE_MAX_CURRENT.decode(raw);
+            pdo.max_power_mw = static_cast<uint32_t>(pdo.max_voltage_mv) * pdo.max_current_ma / 1000;
+            break;
+
+        default: // APDO
+            switch (APDO_TYPE.decode(raw))
+            {
+            case 0b00:
+                pdo.type = SourcePDOType::PPS;
+                pdo.max_voltage_mv = PPS_MAX_VOLTAGE.decode(raw);
+                pdo.min_voltage_mv = PPS_MIN_VOLTAGE.decode(raw);
+                pdo.max_current_ma = PPS_MAX_CURRENT.decode(raw);
+                pdo.max_power_mw = static_cast<uint32_t>(pdo.max_voltage_mv) * pdo.max_current_ma / 1000;
+                pdo.pps_power_limited = PPS_POWER_LIMITED.test(raw);
+                break;
+            case 0b01:
+                pdo.type = SourcePDOType::EPR_AVS;
+                pdo.max_voltage_mv = EPR_AVS_MAX_VOLTAGE.decode(raw);
+                pdo.min_voltage_mv = AVS_MIN_VOLTAGE.decode(raw);
+                pdo.max_power_mw = EPR_AVS_PDP.decode(raw) * 1000;
+                if (pdo.min_voltage_mv)
+                {
+                    uint32_t current = pdo.max_power_mw * 1000 / pdo.min_voltage_mv;
+                    pdo.max_current_ma = current > UINT16_MAX ? UINT16_MAX : current;
+                }
+                break;
+            case 0b10:
+                // SPR AVS : 9 V à 20 V, courant max annoncé à 15 V et à 20 V
+                pdo.type = SourcePDOType::SPR_AVS;
+                pdo.min_voltage_mv = 9000;
+                pdo.max_voltage_mv = 20000;
+                pdo.max_current_ma = SPR_AVS_MAX_CURRENT_15V.decode(raw);
+                pdo.max_power_mw = 20000u * SPR_AVS_MAX_CURRENT_20V.decode(raw) / 1000;
+                break;
+            default:
+                pdo.type = SourcePDOType::Unknown;
+                break;
+            }
+            break;
+        }
+        return pdo;
+    }
+
+    const char *SourcePDO::to_string(SourcePDOType type)
+    {
+        switch (type)
+        {
+        case SourcePDOType::Fixed:    return "Fixed";
+        case SourcePDOType::Battery:  return "Battery";
+        case SourcePDOType::Variable: return "Variable";
+        case SourcePDOType::PPS:      return "PPS";
+        case SourcePDOType::EPR_AVS:  return "EPR_AVS";
+        case SourcePDOType::SPR_AVS:  return "SPR_AVS";
+        default:                      return "Unknown";
+        }
+    }
+
+    void SourcePDO::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        if (type == SourcePDOType::Fixed)
+        {
+            ESP_LOGI(TAG, "  %-8s %5u mV          %4u mA  %6u mW%s%s",
+                     to_string(type), max_voltage_mv, max_current_ma, static_cast<unsigned>(max_power_mw),
+                     unconstrained_power ? " [unconstrained]" : "", epr_capable ? " [EPR]" : "");
+        }
+        else
+        {
+            ESP_LOGI(TAG, "  %-8s %5u-%5u mV    %4u mA  %6u mW%s",
+                     to_string(type), min_voltage_mv, max_voltage_mv, max_current_ma,
+                     static_cast<unsigned>(max_power_mw), pps_power_limited ? " [power limited]" : "");
+        }
+#endif
+    }
+
+    std::string SourcePDO::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"type\": \"" + std::string(to_string(type)) + "\",";
+        json += "\"min_voltage_mv\": " + std::to_string(min_voltage_mv) + ",";
+        json += "\"max_voltage_mv\": " + std::to_string(max_voltage_mv) + ",";
+        json += "\"max_current_ma\": " + std::to_string(max_current_ma) + ",";
+        json += "\"max_power_mw\": " + std::to_string(max_power_mw);
+        if (type == SourcePDOType::Fixed)
+        {
+            json += ",\"unconstrained_power\": " + std::string(unconstrained_power ? "true" : "false");
+            json += ",\"usb_comm_capable\": " + std::string(usb_comm_capable ? "true" : "false");
+            json += ",\"dual_role_power\": " + std::string(dual_role_power ? "true" : "false");
+            json += ",\"epr_capable\": " + std::string(epr_capable ? "true" : "false");
+        }
+        else if (type == SourcePDOType::PPS)
+        {
+            json += ",\"pps_power_limited\": " + std::string(pps_power_limited ? "true" : "false");
+        }
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+    void SourceCapabilities::decode(const uint32_t *objects, std::size_t count)
+    {
+        count_ = 0;
+        if (objects == nullptr)
+            return;
+
+        for (std::size_t i = 0; i < count && i < MAX_OBJECTS; ++i)
+            pdos_[count_++] = SourcePDO::decode(objects[i]);
+    }
+
+    const SourcePDO *SourceCapabilities::at_position(uint8_t position) const
+    {
+        if (position < 1 || position > count_)
+            return nullptr;
+        return &pdos_[position - 1];
+    }
+
+    uint32_t SourceCapabilities::max_power_mw() const
+    {
+        uint32_t best = 0;
+        for (const auto &pdo : *this)
+        {
+            if (pdo.max_power_mw > best)
+                best = pdo.max_power_mw;
+        }
+        return best;
+    }
+
+    void SourceCapabilities::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Source Capabilities (%u PDO) ---", count_);
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            ESP_LOGI(TAG, " PDO%u:", static_cast<unsigned>(i + 1));
+            pdos_[i].log();
+        }
+#endif
+    }
+
+    std::string SourceCapabilities::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "[";
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            if (i)
+                json += ",";
+            json += pdos_[i].to_json();
+        }
+        json += "]";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
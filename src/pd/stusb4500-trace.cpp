@@ -0,0 +1,158 @@
+#include "pd/stusb4500-trace.hpp"
+#include "pd/stusb4500-rx_datas.hpp"
+#include "stusb4500-fields.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-TRACE";
+
+    void MessageTrace::record(const RXDatas &rx, uint8_t pe_state, int64_t timestamp_us)
+    {
+        if (CAPACITY == 0)
+            return;
+
+        TraceRecord entry;
+        entry.timestamp_us = timestamp_us;
+        entry.header = rx.header();
+        entry.pe_state = pe_state;
+        entry.num_objects = rx.num_objects();
+        for (std::size_t i = 0; i < entry.num_objects; ++i)
+            entry.objects[i] = rx.data_object(i);
+
+        portENTER_CRITICAL(&lock_);
+        records_[head_] = entry;
+        head_ = (head_ + 1) % STORAGE;
+        if (count_ < CAPACITY)
+            count_++;
+        else
+            dropped_++;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    void MessageTrace::clear()
+    {
+        portENTER_CRITICAL(&lock_);
+        head_ = 0;
+        count_ = 0;
+        dropped_ = 0;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    std::size_t MessageTrace::size() const
+    {
+        portENTER_CRITICAL(&lock_);
+        std::size_t count = count_;
+        portEXIT_CRITICAL(&lock_);
+        return count;
+    }
+
+    uint32_t MessageTrace::dropped() const
+    {
+        portENTER_CRITICAL(&lock_);
+        uint32_t dropped = dropped_;
+        portEXIT_CRITICAL(&lock_);
+        return dropped;
+    }
+
+    bool MessageTrace::at(std::size_t index, TraceRecord &out) const
+    {
+        bool found = false;
+        portENTER_CRITICAL(&lock_);
+        if (index < count_)
+        {
+            out = records_[(head_ + STORAGE - count_ + index) % STORAGE];
+            found = true;
+        }
+        portEXIT_CRITICAL(&lock_);
+        return found;
+    }
+
+    std::size_t MessageTrace::dump(uint8_t *out, std::size_t len) const
+    {
+        const std::size_t count = size();
+        if (out == nullptr || len < DUMP_HEADER_SIZE + count * RECORD_SIZE)
+            return 0;
+
+        store_le32(DUMP_MAGIC, out);
+        out[4] = DUMP_VERSION;
+        out[5] = static_cast<uint8_t>(RECORD_SIZE);
+        out[6] = static_cast<uint8_t>(count & 0xFF);
+        out[7] = static_cast<uint8_t>(count >> 8);
+
+        std::size_t written = DUMP_HEADER_SIZE;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            TraceRecord entry;
+            if (!at(i, entry))
+                break;
+
+            uint8_t *p = out + written;
+            store_le64(static_cast<uint64_t>(entry.timestamp_us), p);
+            p[8] = entry.header & 0xFF;
+            p[9] = entry.header >> 8;
+            p[10] = entry.pe_state;
+            p[11] = entry.num_objects;
+            for (std::size_t j = 0; j < 7; ++j)
+                store_le32(entry.objects[j], p + 12 + j * 4);
+            written += RECORD_SIZE;
+        }
+
+        // Le journal a pu être vidé entre size() et la copie
+        const std::size_t copied = (written - DUMP_HEADER_SIZE) / RECORD_SIZE;
+        out[6] = static_cast<uint8_t>(copied & 0xFF);
+        out[7] = static_cast<uint8_t>(copied >> 8);
+        return written;
+    }
+
+    void MessageTrace::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- PD message trace (%u entries, %u dropped) ---",
+                 static_cast<unsigned>(size()), static_cast<unsigned>(dropped()));
+        TraceRecord entry;
+        for (std::size_t i = 0; at(i, entry); ++i)
+        {
+            char objects[7 * 9 + 1] = {0};
+            for (std::size_t j = 0; j < entry.num_objects && j < 7; ++j)
+                snprintf(objects + j * 9, sizeof(objects) - j * 9, " %08" PRIX32, entry.objects[j]);
+            ESP_LOGI(TAG, "%12lld us  PE=0x%02X  hdr=0x%04X type=%2u n=%u%s",
+                     static_cast<long long>(entry.timestamp_us), entry.pe_state, entry.header,
+                     entry.message_type(), entry.num_objects, objects);
+        }
+#endif
+    }
+
+    std::string MessageTrace::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{\"dropped\": " + std::to_string(dropped()) + ", \"messages\": [";
+        TraceRecord entry;
+        for (std::size_t i = 0; at(i, entry); ++i)
+        {
+            if (i)
+                json += ",";
+            json += "{\"timestamp_us\": " + std::to_string(entry.timestamp_us) + ",";
+            json += "\"pe_state\": " + std::to_string(entry.pe_state) + ",";
+            json += "\"header\": " + std::to_string(entry.header) + ",";
+            json += "\"objects\": [";
+            for (std::size_t j = 0; j < entry.num_objects && j < 7; ++j)
+            {
+                if (j)
+                    json += ",";
+                json += std::to_string(entry.objects[j]);
+            }
+            json += "]}";
+        }
+        json += "]}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -0,0 +1,69 @@
+#include "status/stusb4500-alert_subscriptions.hpp"
+
+namespace stusb4500
+{
+    static constexpr AlertClass ALL_CLASSES[] = {AlertClass::PortStatus, AlertClass::TypeCMonitoring,
+                                                 AlertClass::CCHwFault, AlertClass::PRTStatus};
+
+    int AlertSubscriptions::subscribe(uint8_t classes, AlertHandler handler, void *ctx)
+    {
+        if (handler == nullptr || (classes & MASKABLE) == 0)
+            return -1;
+
+        int id = -1;
+        portENTER_CRITICAL(&lock_);
+        for (size_t i = 0; i < entries_.size(); ++i)
+        {
+            if (entries_[i].handler == nullptr)
+            {
+                entries_[i] = {static_cast<uint8_t>(classes & MASKABLE), handler, ctx};
+                id = static_cast<int>(i);
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&lock_);
+        return id;
+    }
+
+    bool AlertSubscriptions::unsubscribe(int id)
+    {
+        if (id < 0 || static_cast<size_t>(id) >= entries_.size())
+            return false;
+
+        portENTER_CRITICAL(&lock_);
+        const bool found = entries_[id].handler != nullptr;
+        entries_[id] = {};
+        portEXIT_CRITICAL(&lock_);
+        return found;
+    }
+
+    uint8_t AlertSubscriptions::subscribed() const
+    {
+        uint8_t classes = 0;
+        portENTER_CRITICAL(&lock_);
+        for (const Entry &entry : entries_)
+            classes |= entry.classes;
+        portEXIT_CRITICAL(&lock_);
+        return classes;
+    }
+
+    void AlertSubscriptions::dispatch(uint8_t alerts, const StatusSnapshot &snapshot) const
+    {
+        for (size_t i = 0; i < entries_.size(); ++i)
+        {
+            // Copie sous verrou : l'appel se fait hors section critique
+            portENTER_CRITICAL(&lock_);
+            const Entry entry = entries_[i];
+            portEXIT_CRITICAL(&lock_);
+
+            if (entry.handler == nullptr)
+                continue;
+            for (AlertClass alert : ALL_CLASSES)
+            {
+                if (entry.classes & alerts & static_cast<uint8_t>(alert))
+                    entry.handler(alert, snapshot, entry.ctx);
+            }
+        }
+    }
+
+} // namespace stusb4500
@@ -0,0 +1,196 @@
+#include "status/stusb4500-pe_tracker.hpp"
+#include "status/stusb4500-status_types.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-PE";
+
+    std::size_t PETracker::index_of(uint8_t state)
+    {
+        for (std::size_t i = 0; i < STATES.size(); ++i)
+        {
+            if (STATES[i] == state)
+                return i;
+        }
+        return UNKNOWN;
+    }
+
+    bool PETracker::is_wait_state(uint8_t state)
+    {
+        // États dans lesquels le PE attend le chargeur
+        return state == 0x13 || state == 0x14 || state == 0x16 || state == 0x17 || state == 0x19 ||
+               state == 0x3A || state == 0x3B;
+    }
+
+    bool PETracker::is_legal(uint8_t from, uint8_t to)
+    {
+        // Détachement, resets et reprise sur erreur sont possibles depuis tout état
+        if (to == 0x00 || to == 0x01 || to == 0x02 || to == 0x03 || to == 0x12 || to == 0x40)
+            return true;
+
+        // Séquence de négociation sink : tout saut vers l'avant (états intermédiaires non échantillonnés)
+        if (from >= 0x12 && from <= 0x19 && to > from && to <= 0x19)
+            return true;
+
+        switch (from)
+        {
+        case 0x00: // PE_INIT
+        case 0x3B: // PE_HARD_RESET_RECOVERY
+            return to >= 0x12 && to <= 0x19;
+        case 0x01: // PE_SOFT_RESET
+        case 0x03: // PE_SEND_SOFT_RESET
+            return to >= 0x14 && to <= 0x19;
+        case 0x02: // PE_HARD_RESET
+            return to == 0x3A || to == 0x3B;
+        case 0x3A: // PE_HARD_RESET_SHUTDOWN
+            return to == 0x3B || (to >= 0x12 && to <= 0x19);
+        case 0x04: // PE_C_BIST
+            return to == 0x18;
+        case 0x16: // PE_SNK_SELECT_CAPABILITIES : Reject / Wait
+            return to == 0x14;
+        case 0x18: // PE_SNK_READY : nouvelles capacités (évaluation et Request non échantillonnées) ou mode BIST
+            return to == 0x14 || to == 0x15 || to == 0x16 || to == 0x17 || to == 0x04;
+        case 0x19: // PE_SNK_READY_SENDING
+            return to == 0x15 || to == 0x16 || to == 0x18;
+        default:
+            return false;
+        }
+    }
+
+    bool PETracker::observe(uint8_t state, int64_t now_us)
+    {
+        if (!started_)
+        {
+            started_ = true;
+            current_ = state;
+            entered_us_ = now_us;
+            stats_[index_of(state)].entries++;
+            return true;
+        }
+
+        if (state == current_)
+            return true;
+
+        StateStats &previous = stats_[index_of(current_)];
+        const int64_t spent = now_us - entered_us_;
+        previous.total_us += spent;
+        if (spent > previous.max_us)
+            previous.max_us = spent;
+
+        Transition &t = history_[history_head_];
+        t.timestamp_us = now_us;
+        t.from = current_;
+        t.to = state;
+        t.legal = is_legal(current_, state);
+        history_head_ = (history_head_ + 1) % HISTORY;
+        if (history_count_ < HISTORY)
+            history_count_++;
+
+        transitions_++;
+        if (!t.legal)
+        {
+            illegal_++;
+            ESP_LOGW(TAG, "Unexpected PE transition 0x%02X -> 0x%02X (%s -> %s)", t.from, t.to,
+                     StateStatusRegister::to_string(t.from).c_str(), StateStatusRegister::to_string(t.to).c_str());
+        }
+
+        current_ = state;
+        entered_us_ = now_us;
+        stuck_reported_ = false;
+        stats_[index_of(state)].entries++;
+        return t.legal;
+    }
+
+    bool PETracker::check_stuck(int64_t now_us)
+    {
+        if (!started_ || stuck_reported_ || !is_wait_state(current_))
+            return false;
+        if (now_us - entered_us_ < stuck_threshold_us_)
+            return false;
+
+        stuck_reported_ = true;
+        stuck_events_++;
+        ESP_LOGW(TAG, "PE stuck in %s for %lld ms", StateStatusRegister::to_string(current_).c_str(),
+                 static_cast<long long>((now_us - entered_us_) / 1000));
+        return true;
+    }
+
+    int64_t PETracker::time_to_stuck(int64_t now_us) const
+    {
+        if (!started_ || stuck_reported_ || !is_wait_state(current_))
+            return -1;
+        const int64_t deadline = entered_us_ + stuck_threshold_us_;
+        return deadline > now_us ? deadline - now_us : 0;
+    }
+
+    bool PETracker::history(std::size_t index, Transition &out) const
+    {
+        if (index >= history_count_)
+            return false;
+        out = history_[(history_head_ + HISTORY - history_count_ + index) % HISTORY];
+        return true;
+    }
+
+    void PETracker::reset()
+    {
+        *this = PETracker(stuck_threshold_us_);
+    }
+
+    void PETracker::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Policy engine ---");
+        ESP_LOGI(TAG, "Current          : %s", StateStatusRegister::to_string(current_).c_str());
+        ESP_LOGI(TAG, "Transitions      : %u (unexpected=%u, stuck=%u)", static_cast<unsigned>(transitions_),
+                 static_cast<unsigned>(illegal_), static_cast<unsigned>(stuck_events_));
+        for (std::size_t i = 0; i < stats_.size(); ++i)
+        {
+            if (stats_[i].entries == 0)
+                continue;
+            ESP_LOGI(TAG, "  %-30s x%-4u total=%lld ms max=%lld ms",
+                     i < STATES.size() ? StateStatusRegister::to_string(STATES[i]).c_str() : "UNKNOWN",
+                     static_cast<unsigned>(stats_[i].entries),
+                     static_cast<long long>(stats_[i].total_us / 1000), static_cast<long long>(stats_[i].max_us / 1000));
+        }
+        Transition t;
+        for (std::size_t i = 0; history(i, t); ++i)
+        {
+            ESP_LOGI(TAG, "  %12lld us  0x%02X -> 0x%02X%s", static_cast<long long>(t.timestamp_us), t.from, t.to,
+                     t.legal ? "" : "  (unexpected)");
+        }
+#endif
+    }
+
+    std::string PETracker::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"current\": \"" + StateStatusRegister::to_string(current_) + "\",";
+        json += "\"transitions\": " + std::to_string(transitions_) + ",";
+        json += "\"unexpected\": " + std::to_string(illegal_) + ",";
+        json += "\"stuck\": " + std::to_string(stuck_events_) + ",";
+        json += "\"states\": {";
+        bool first = true;
+        for (std::size_t i = 0; i < stats_.size(); ++i)
+        {
+            if (stats_[i].entries == 0)
+                continue;
+            if (!first)
+                json += ",";
+            first = false;
+            json += "\"" + (i < STATES.size() ? StateStatusRegister::to_string(STATES[i]) : std::string("UNKNOWN")) + "\": {";
+            json += "\"entries\": " + std::to_string(stats_[i].entries) + ",";
+            json += "\"total_ms\": " + std::to_string(stats_[i].total_us / 1000) + ",";
+            json += "\"max_ms\": " + std::to_string(stats_[i].max_us / 1000) + "}";
+        }
+        json += "}}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -0,0 +1,102 @@
+#include "status/stusb4500-power_accounting.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-POWER";
+
+    PowerStats PowerStats::at(int64_t now_us) const
+    {
+        PowerStats copy = *this;
+        if (contract_power_mw == 0 || now_us <= contract_start_us)
+            return copy;
+
+        const int64_t elapsed = now_us - contract_start_us;
+        const uint64_t energy = static_cast<uint64_t>(contract_power_mw) * static_cast<uint64_t>(elapsed);
+        copy.session_energy_mw_us += energy;
+        copy.total_energy_mw_us += energy;
+        if (elapsed > copy.longest_contract_us)
+            copy.longest_contract_us = elapsed;
+        return copy;
+    }
+
+    void PowerAccounting::close_contract(int64_t now_us)
+    {
+        stats_ = stats_.at(now_us);
+        stats_.contract_voltage_mv = 0;
+        stats_.contract_current_ma = 0;
+        stats_.contract_power_mw = 0;
+        stats_.contract_start_us = now_us;
+    }
+
+    void PowerAccounting::on_contract(uint16_t voltage_mv, uint16_t current_ma, int64_t now_us)
+    {
+        if (voltage_mv == stats_.contract_voltage_mv && current_ma == stats_.contract_current_ma)
+            return;
+
+        close_contract(now_us);
+        if (voltage_mv == 0 || current_ma == 0)
+            return;
+
+        if (stats_.session_start_us == 0)
+        {
+            stats_.session_start_us = now_us;
+            stats_.session_contracts = 0;
+            stats_.session_energy_mw_us = 0;
+            stats_.sessions++;
+        }
+
+        stats_.contract_voltage_mv = voltage_mv;
+        stats_.contract_current_ma = current_ma;
+        stats_.contract_power_mw = static_cast<uint32_t>(voltage_mv) * current_ma / 1000;
+        stats_.session_contracts++;
+        if (stats_.contract_power_mw > stats_.peak_power_mw)
+            stats_.peak_power_mw = stats_.contract_power_mw;
+    }
+
+    void PowerAccounting::on_detach(int64_t now_us)
+    {
+        close_contract(now_us);
+        stats_.session_start_us = 0;
+    }
+
+    void PowerStats::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Power accounting ---");
+        ESP_LOGI(TAG, "Contract         : %u mV x %u mA = %u mW", contract_voltage_mv, contract_current_ma,
+                 static_cast<unsigned>(contract_power_mw));
+        ESP_LOGI(TAG, "Session          : #%u, %u contract(s), %u mWh",
+                 static_cast<unsigned>(sessions), static_cast<unsigned>(session_contracts),
+                 static_cast<unsigned>(session_energy_mwh()));
+        ESP_LOGI(TAG, "Total energy     : %u mWh", static_cast<unsigned>(total_energy_mwh()));
+        ESP_LOGI(TAG, "Peak power       : %u mW", static_cast<unsigned>(peak_power_mw));
+        ESP_LOGI(TAG, "Longest contract : %lld ms", static_cast<long long>(longest_contract_us / 1000));
+#endif
+    }
+
+    std::string PowerStats::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"contract_voltage_mv\": " + std::to_string(contract_voltage_mv) + ",";
+        json += "\"contract_current_ma\": " + std::to_string(contract_current_ma) + ",";
+        json += "\"contract_power_mw\": " + std::to_string(contract_power_mw) + ",";
+        json += "\"contract_start_us\": " + std::to_string(contract_start_us) + ",";
+        json += "\"session_start_us\": " + std::to_string(session_start_us) + ",";
+        json += "\"session_contracts\": " + std::to_string(session_contracts) + ",";
+        json += "\"sessions\": " + std::to_string(sessions) + ",";
+        json += "\"session_energy_mwh\": " + std::to_string(session_energy_mwh()) + ",";
+        json += "\"total_energy_mwh\": " + std::to_string(total_energy_mwh()) + ",";
+        json += "\"peak_power_mw\": " + std::to_string(peak_power_mw) + ",";
+        json += "\"longest_contract_ms\": " + std::to_string(longest_contract_us / 1000);
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
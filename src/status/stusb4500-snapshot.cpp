@@ -0,0 +1,46 @@
+#include <cstring>
+
+#include "status/stusb4500-snapshot.hpp"
+
+namespace stusb4500
+{
+    void SnapshotPublisher::publish(const StatusSnapshot &snapshot)
+    {
+        uint32_t buffer[WORDS] = {};
+        std::memcpy(buffer, &snapshot, sizeof(snapshot));
+
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WORDS; ++i)
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    bool SnapshotPublisher::read(StatusSnapshot &out, int max_attempts) const
+    {
+        uint32_t buffer[WORDS];
+
+        for (int attempt = 0; attempt < max_attempts; ++attempt)
+        {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+
+            for (std::size_t i = 0; i < WORDS; ++i)
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) != before)
+                continue;
+
+            std::memcpy(&out, buffer, sizeof(out));
+            out.sequence = before / 2;
+            return true;
+        }
+        return false;
+    }
+
+} // namespace stusb4500
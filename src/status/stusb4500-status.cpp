@@ -1,4 +1,5 @@
 #include "status/stusb4500-status.hpp"
+#include "stusb4500-output.hpp"
 
 #define RETURN_IF_ERROR(x)         \
     do {                           \
@@ -29,6 +30,7 @@ namespace stusb4500
 
     void STATUS::log() const
     {
+#if STUSB4500_LOG_TEXT
         policy_engine_state.log();
         port_status_0.log();
         port_status_1.log();
@@ -40,10 +42,12 @@ namespace stusb4500
         pd_typec_status.log();
         typec_status.log();
         prt_status.log();
+#endif
     }
 
     std::string STATUS::to_json() const
     {
+#if STUSB4500_JSON_OUTPUT
         return std::string("{") +
                "\"policy_engine_state\": " + policy_engine_state.to_json() + "," +
                "\"port_status_0\": " + port_status_0.to_json() + "," +
@@ -57,5 +61,8 @@ namespace stusb4500
                "\"typec_status\": " + typec_status.to_json() + "," +
                "\"prt_status\": " + prt_status.to_json() +
                "}";
+#else
+        return {};
+#endif
     }
 } // namespace stusb4500
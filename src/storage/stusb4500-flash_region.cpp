@@ -0,0 +1,53 @@
+#include "storage/stusb4500-flash_region.hpp"
+
+#if defined(CONFIG_STUSB4500_JOURNAL)
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    esp_err_t PartitionRegion::open(const char *label)
+    {
+        partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+        if (partition_ == nullptr)
+        {
+            ESP_LOGE(TAG, "Partition '%s' not found", label);
+            return ESP_ERR_NOT_FOUND;
+        }
+        return ESP_OK;
+    }
+
+    size_t PartitionRegion::size() const
+    {
+        return partition_ ? partition_->size : 0;
+    }
+
+    size_t PartitionRegion::sector_size() const
+    {
+        return partition_ ? partition_->erase_size : 0;
+    }
+
+    esp_err_t PartitionRegion::read(size_t offset, void *data, size_t len)
+    {
+        if (partition_ == nullptr)
+            return ESP_ERR_INVALID_STATE;
+        return esp_partition_read(partition_, offset, data, len);
+    }
+
+    esp_err_t PartitionRegion::write(size_t offset, const void *data, size_t len)
+    {
+        if (partition_ == nullptr)
+            return ESP_ERR_INVALID_STATE;
+        return esp_partition_write(partition_, offset, data, len);
+    }
+
+    esp_err_t PartitionRegion::erase(size_t offset, size_t len)
+    {
+        if (partition_ == nullptr)
+            return ESP_ERR_INVALID_STATE;
+        return esp_partition_erase_range(partition_, offset, len);
+    }
+
+} // namespace stusb4500
+
+#endif
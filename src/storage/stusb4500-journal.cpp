@@ -0,0 +1,275 @@
+#include "storage/stusb4500-journal.hpp"
+#include "stusb4500-fields.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define RETURN_IF_ERROR(x)         \
+    do {                           \
+        esp_err_t __err_rc = (x);  \
+        if (__err_rc != ESP_OK) {  \
+            return __err_rc;       \
+        }                          \
+    } while (0)
+
+namespace stusb4500
+{
+    /// Enregistrements encodés par écriture flash lors d'un flush
+    static constexpr size_t CHUNK = 8;
+
+    static uint8_t crc8(const uint8_t *data, size_t len)
+    {
+        uint8_t crc = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+        return crc;
+    }
+
+    void JournalRecord::encode(uint8_t *out) const
+    {
+        store_le32(sequence, out);
+        store_le32(uptime_ms, out + 4);
+        out[8] = static_cast<uint8_t>(event);
+        out[9] = 0;
+        out[10] = arg16 & 0xFF;
+        out[11] = arg16 >> 8;
+        store_le32(arg32, out + 12);
+        out[9] = crc8(out, SIZE);
+    }
+
+    bool JournalRecord::decode(const uint8_t *in)
+    {
+        uint8_t copy[SIZE];
+        std::memcpy(copy, in, SIZE);
+        copy[9] = 0;
+        if (crc8(copy, SIZE) != in[9])
+            return false;
+
+        sequence = load_le32(in);
+        uptime_ms = load_le32(in + 4);
+        event = static_cast<JournalEvent>(in[8]);
+        arg16 = static_cast<uint16_t>(in[10] | (in[11] << 8));
+        arg32 = load_le32(in + 12);
+        return true;
+    }
+
+    bool EventJournal::is_erased(const uint8_t *data, size_t len) const
+    {
+        return std::all_of(data, data + len, [](uint8_t b)
+                           { return b == 0xFF; });
+    }
+
+    esp_err_t EventJournal::mount()
+    {
+        const size_t sector = region_.sector_size();
+        if (sector < JournalRecord::SIZE || sector % JournalRecord::SIZE != 0 || region_.size() < 2 * sector)
+        {
+            ESP_LOGE(TAG, "Zone inutilisable (%u octets, secteurs de %u)",
+                     static_cast<unsigned>(region_.size()), static_cast<unsigned>(sector));
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        const size_t capacity = region_.size() / sector * sector;
+        uint32_t highest = 0;
+        size_t highest_offset = 0;
+        bool found = false;
+
+        uint8_t raw[JournalRecord::SIZE];
+        JournalRecord rec;
+        for (size_t offset = 0; offset < capacity; offset += JournalRecord::SIZE)
+        {
+            RETURN_IF_ERROR(region_.read(offset, raw, sizeof(raw)));
+            if (is_erased(raw, sizeof(raw)) || !rec.decode(raw))
+                continue;
+            if (!found || rec.sequence > highest)
+            {
+                highest = rec.sequence;
+                highest_offset = offset;
+                found = true;
+            }
+        }
+
+        write_offset_ = found ? (highest_offset + JournalRecord::SIZE) % capacity : 0;
+        next_sequence_ = found ? highest + 1 : 1;
+
+        // Un emplacement non vierge après le dernier enregistrement (écriture
+        // interrompue) : on repart au secteur suivant, qui sera effacé avant usage
+        if (write_offset_ % sector != 0)
+        {
+            RETURN_IF_ERROR(region_.read(write_offset_, raw, sizeof(raw)));
+            if (!is_erased(raw, sizeof(raw)))
+                write_offset_ = (write_offset_ / sector + 1) * sector % capacity;
+        }
+
+        mounted_ = true;
+        ESP_LOGI(TAG, "Journal monté : %s, prochaine séquence %lu à l'offset 0x%x",
+                 found ? "reprise" : "vierge", static_cast<unsigned long>(next_sequence_),
+                 static_cast<unsigned>(write_offset_));
+        return ESP_OK;
+    }
+
+    void EventJournal::record(JournalEvent event, uint16_t arg16, uint32_t arg32)
+    {
+        JournalRecord rec;
+        rec.uptime_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000);
+        rec.event = event;
+        rec.arg16 = arg16;
+        rec.arg32 = arg32;
+
+        portENTER_CRITICAL(&lock_);
+        if (buffered_ < BUFFER)
+            buffer_[buffered_++] = rec;
+        else
+            ++dropped_;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    size_t EventJournal::pending() const
+    {
+        portENTER_CRITICAL(&lock_);
+        size_t count = buffered_;
+        portEXIT_CRITICAL(&lock_);
+        return count;
+    }
+
+    bool EventJournal::flush_due(uint32_t max_age_ms) const
+    {
+        portENTER_CRITICAL(&lock_);
+        size_t count = buffered_;
+        uint32_t oldest = count ? buffer_[0].uptime_ms : 0;
+        bool overflow = dropped_ != dropped_reported_;
+        portEXIT_CRITICAL(&lock_);
+
+        if (overflow || count >= BUFFER / 2)
+            return true;
+        uint32_t now = static_cast<uint32_t>(esp_timer_get_time() / 1000);
+        return count > 0 && now - oldest >= max_age_ms;
+    }
+
+    size_t EventJournal::sector_room() const
+    {
+        const size_t sector = region_.sector_size();
+        return (sector - write_offset_ % sector) / JournalRecord::SIZE;
+    }
+
+    esp_err_t EventJournal::append(const uint8_t *data, size_t count, size_t &landed)
+    {
+        landed = 0;
+        const size_t sector = region_.sector_size();
+        const size_t capacity = region_.size() / sector * sector;
+        const size_t start = write_offset_;
+        const size_t len = count * JournalRecord::SIZE;
+
+        // Une seule écriture, jamais à cheval sur deux secteurs (count <= sector_room())
+        esp_err_t err = ESP_OK;
+        if (start % sector == 0)
+        {
+            // L'anneau entre dans un secteur : on efface le plus ancien contenu
+            err = region_.erase(start, sector);
+        }
+        else
+        {
+            // Milieu de secteur : la zone doit être vierge, une NOR ne réécrit pas sans effacement
+            uint8_t cells[CHUNK * JournalRecord::SIZE];
+            err = region_.read(start, cells, len);
+            if (err == ESP_OK && !is_erased(cells, len))
+                err = ESP_ERR_INVALID_STATE;
+        }
+        if (err == ESP_OK)
+        {
+            err = region_.write(start, data, len);
+            if (err != ESP_OK)
+            {
+                // Écriture interrompue : les enregistrements arrivés entiers sont acquis, pas de doublon au nouvel essai
+                uint8_t cells[CHUNK * JournalRecord::SIZE];
+                if (region_.read(start, cells, len) == ESP_OK)
+                {
+                    while (landed < count && std::memcmp(cells + landed * JournalRecord::SIZE,
+                                                         data + landed * JournalRecord::SIZE, JournalRecord::SIZE) == 0)
+                        ++landed;
+                }
+            }
+        }
+
+        if (err != ESP_OK)
+        {
+            // Zone peut-être programmée en partie : abandonnée jusqu'au prochain effacement, le reste
+            // des enregistrements reste en RAM et repart du secteur suivant
+            write_offset_ = (start / sector + 1) * sector % capacity;
+            return err;
+        }
+        landed = count;
+        write_offset_ = (start + len) % capacity;
+        return ESP_OK;
+    }
+
+    esp_err_t EventJournal::flush()
+    {
+        if (!mounted_)
+            return ESP_ERR_INVALID_STATE;
+
+        uint8_t raw[CHUNK * JournalRecord::SIZE];
+        for (;;)
+        {
+            JournalRecord chunk[CHUNK];
+            size_t n = 0;
+            uint32_t lost = 0;
+
+            const size_t limit = std::min(CHUNK, sector_room());
+            portENTER_CRITICAL(&lock_);
+            n = std::min(buffered_, limit);
+            std::copy_n(buffer_.begin(), n, chunk);
+            if (n < limit && dropped_ != dropped_reported_)
+            {
+                lost = dropped_ - dropped_reported_;
+                dropped_reported_ = dropped_;
+            }
+            portEXIT_CRITICAL(&lock_);
+
+            if (lost)
+            {
+                chunk[n].uptime_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000);
+                chunk[n].event = JournalEvent::Overflow;
+                chunk[n].arg16 = 0;
+                chunk[n].arg32 = lost;
+            }
+            size_t total = n + (lost ? 1 : 0);
+            if (total == 0)
+                return ESP_OK;
+
+            for (size_t i = 0; i < total; ++i)
+            {
+                chunk[i].sequence = next_sequence_ + i;
+                chunk[i].encode(raw + i * JournalRecord::SIZE);
+            }
+
+            size_t landed = 0;
+            esp_err_t err = append(raw, total, landed);
+            next_sequence_ += landed;
+
+            const size_t written = std::min(landed, n);
+            portENTER_CRITICAL(&lock_);
+            std::move(buffer_.begin() + written, buffer_.begin() + buffered_, buffer_.begin());
+            buffered_ -= written;
+            // Enregistrement Overflow non écrit : à refaire à la prochaine tentative
+            if (lost && landed < total)
+                dropped_reported_ -= lost;
+            portEXIT_CRITICAL(&lock_);
+
+            if (err != ESP_OK)
+            {
+                // Les enregistrements non écrits restent en RAM pour la prochaine tentative
+                ESP_LOGW(TAG, "Écriture du journal échouée : %s", esp_err_to_name(err));
+                return err;
+            }
+        }
+    }
+
+} // namespace stusb4500
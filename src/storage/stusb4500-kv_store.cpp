@@ -0,0 +1,63 @@
+#include "storage/stusb4500-kv_store.hpp"
+
+#if defined(CONFIG_STUSB4500_NVS_STORAGE)
+
+#include "esp_log.h"
+#include "nvs.h"
+
+namespace stusb4500
+{
+    esp_err_t NvsStore::get(const char *key, void *data, size_t &len)
+    {
+        nvs_handle_t handle;
+        esp_err_t err = nvs_open(namespace_, NVS_READONLY, &handle);
+        if (err == ESP_ERR_NVS_NOT_FOUND)
+            return ESP_ERR_NOT_FOUND;
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "nvs_open(%s) failed (err=0x%x)", namespace_, err);
+            return err;
+        }
+
+        err = nvs_get_blob(handle, key, data, &len);
+        nvs_close(handle);
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+    }
+
+    esp_err_t NvsStore::set(const char *key, const void *data, size_t len)
+    {
+        nvs_handle_t handle;
+        esp_err_t err = nvs_open(namespace_, NVS_READWRITE, &handle);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "nvs_open(%s) failed (err=0x%x)", namespace_, err);
+            return err;
+        }
+
+        err = nvs_set_blob(handle, key, data, len);
+        if (err == ESP_OK)
+            err = nvs_commit(handle);
+        nvs_close(handle);
+
+        if (err != ESP_OK)
+            ESP_LOGE(TAG, "Failed to store %s (err=0x%x)", key, err);
+        return err;
+    }
+
+    esp_err_t NvsStore::erase(const char *key)
+    {
+        nvs_handle_t handle;
+        esp_err_t err = nvs_open(namespace_, NVS_READWRITE, &handle);
+        if (err != ESP_OK)
+            return err;
+
+        err = nvs_erase_key(handle, key);
+        if (err == ESP_OK)
+            err = nvs_commit(handle);
+        nvs_close(handle);
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+    }
+
+} // namespace stusb4500
+
+#endif
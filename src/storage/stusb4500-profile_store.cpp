@@ -0,0 +1,92 @@
+#include "storage/stusb4500-profile_store.hpp"
+#include "stusb4500-fields.hpp"
+
+#include <cstring>
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    // Sérialisation : version, pdo_number, puis les 3 PDO sink encodés (LE32)
+    static constexpr size_t PROFILE_SIZE = 2 + 3 * 4;
+
+    bool ProfileStore::make_key(const char *name, char (&key)[16])
+    {
+        size_t len = name ? std::strlen(name) : 0;
+        if (len == 0 || len > NAME_LEN || std::strcmp(name, "active") == 0)
+        {
+            ESP_LOGE(TAG, "Invalid profile name '%s'", name ? name : "");
+            return false;
+        }
+        std::memcpy(key, "pf_", 3);
+        std::memcpy(key + 3, name, len + 1);
+        return true;
+    }
+
+    esp_err_t ProfileStore::save(const char *name, const PowerProfile &power)
+    {
+        char key[16];
+        if (!make_key(name, key))
+            return ESP_ERR_INVALID_ARG;
+        if (power.pdo_number < 1 || power.pdo_number > power.pdos.size())
+            return ESP_ERR_INVALID_ARG;
+
+        uint8_t buffer[PROFILE_SIZE];
+        buffer[0] = STORE_VERSION;
+        buffer[1] = power.pdo_number;
+        for (size_t i = 0; i < power.pdos.size(); ++i)
+            store_le32(power.encode(i), buffer + 2 + i * 4);
+        return store_.set(key, buffer, sizeof(buffer));
+    }
+
+    esp_err_t ProfileStore::load(const char *name, PowerProfile &power)
+    {
+        char key[16];
+        if (!make_key(name, key))
+            return ESP_ERR_INVALID_ARG;
+
+        uint8_t buffer[PROFILE_SIZE] = {0};
+        size_t len = sizeof(buffer);
+        esp_err_t err = store_.get(key, buffer, len);
+        if (err != ESP_OK)
+            return err;
+
+        if (len != PROFILE_SIZE || buffer[0] != STORE_VERSION || buffer[1] < 1 || buffer[1] > power.pdos.size())
+        {
+            ESP_LOGW(TAG, "Ignoring incompatible profile '%s' (%u bytes)", name, static_cast<unsigned>(len));
+            return ESP_ERR_INVALID_VERSION;
+        }
+
+        for (size_t i = 0; i < power.pdos.size(); ++i)
+            power.decode(load_le32(buffer + 2 + i * 4), i);
+        power.pdo_number = buffer[1];
+        return ESP_OK;
+    }
+
+    esp_err_t ProfileStore::remove(const char *name)
+    {
+        char key[16];
+        if (!make_key(name, key))
+            return ESP_ERR_INVALID_ARG;
+        return store_.erase(key);
+    }
+
+    esp_err_t ProfileStore::set_active(const char *name)
+    {
+        char key[16];
+        if (!make_key(name, key))
+            return ESP_ERR_INVALID_ARG;
+        return store_.set(ACTIVE_KEY, name, std::strlen(name));
+    }
+
+    esp_err_t ProfileStore::active(char *name)
+    {
+        size_t len = NAME_LEN;
+        esp_err_t err = store_.get(ACTIVE_KEY, name, len);
+        if (err != ESP_OK)
+            return err;
+        name[len < NAME_LEN ? len : NAME_LEN] = '\0';
+        return ESP_OK;
+    }
+
+} // namespace stusb4500
@@ -0,0 +1,191 @@
+#include "stusb4500-bus_capture.hpp"
+#include "stusb4500-fields.hpp"
+#include "stusb4500-output.hpp"
+
+#include <cstring>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+namespace stusb4500
+{
+    BusRecorder::BusRecorder(uint8_t *buffer, size_t capacity) : buffer_(buffer), capacity_(capacity)
+    {
+        if (buffer_ == nullptr || capacity_ < BusCapture::HEADER_SIZE)
+        {
+            capacity_ = 0;
+            return;
+        }
+        store_le32(BusCapture::MAGIC, buffer_);
+        buffer_[4] = BusCapture::VERSION;
+        buffer_[5] = buffer_[6] = buffer_[7] = 0;
+        used_ = BusCapture::HEADER_SIZE;
+    }
+
+    size_t BusRecorder::size() const
+    {
+        portENTER_CRITICAL(&lock_);
+        size_t used = used_;
+        portEXIT_CRITICAL(&lock_);
+        return used;
+    }
+
+    void BusRecorder::observe(bool write, uint8_t reg, const uint8_t *data, size_t len, esp_err_t result)
+    {
+        const int64_t now = esp_timer_get_time();
+        const bool error = result != ESP_OK;
+        const size_t payload = (write || !error) ? len : 0;
+        const size_t need = BusCapture::RECORD_SIZE + (error ? 4 : 0) + payload;
+
+        portENTER_CRITICAL(&lock_);
+        if (len > 0xFF || used_ + need > capacity_)
+        {
+            ++dropped_;
+            portEXIT_CRITICAL(&lock_);
+            return;
+        }
+
+        uint8_t *p = buffer_ + used_;
+        store_le32(records_ ? static_cast<uint32_t>(now - last_us_) : 0, p);
+        p[4] = (write ? BusCapture::FLAG_WRITE : 0) | (error ? BusCapture::FLAG_ERROR : 0);
+        p[5] = reg;
+        p[6] = static_cast<uint8_t>(len);
+        p += BusCapture::RECORD_SIZE;
+        if (error)
+        {
+            store_le32(static_cast<uint32_t>(result), p);
+            p += 4;
+        }
+        if (payload)
+            std::memcpy(p, data, payload);
+
+        used_ += need;
+        last_us_ = now;
+        ++records_;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    esp_err_t BusRecorder::save(FILE *file) const
+    {
+        if (file == nullptr || capacity_ == 0)
+            return ESP_ERR_INVALID_ARG;
+
+        const size_t used = size();
+        if (fwrite(buffer_, 1, used, file) != used)
+        {
+            ESP_LOGE(TAG, "Short write while saving capture");
+            return ESP_FAIL;
+        }
+        if (dropped_)
+            ESP_LOGW(TAG, "Capture truncated: %lu transactions dropped", static_cast<unsigned long>(dropped_));
+        return ESP_OK;
+    }
+
+    BusReplayer::BusReplayer(const uint8_t *capture, size_t len) : capture_(capture), len_(len)
+    {
+        valid_ = capture_ != nullptr && len_ >= BusCapture::HEADER_SIZE && load_le32(capture_) == BusCapture::MAGIC &&
+                 capture_[4] == BusCapture::VERSION;
+        offset_ = valid_ ? BusCapture::HEADER_SIZE : len_;
+    }
+
+    esp_err_t BusReplayer::diverge(const char *why, uint8_t reg)
+    {
+        if (first_divergence_ < 0)
+            first_divergence_ = static_cast<int32_t>(replayed_);
+        ++divergences_;
+        ESP_LOGW(TAG, "Transaction %lu: %s (reg 0x%02X)", static_cast<unsigned long>(replayed_), why, reg);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    bool BusReplayer::next(bool write, uint8_t reg, size_t len, const uint8_t *written, uint8_t *read, esp_err_t &result)
+    {
+        if (offset_ + BusCapture::RECORD_SIZE > len_)
+        {
+            diverge("beyond end of capture", reg);
+            ++replayed_;
+            result = ESP_ERR_NOT_FOUND;
+            return true;
+        }
+
+        const uint8_t *p = capture_ + offset_;
+        const uint32_t delta_us = load_le32(p);
+        const bool rec_write = p[4] & BusCapture::FLAG_WRITE;
+        const bool rec_error = p[4] & BusCapture::FLAG_ERROR;
+        const uint8_t rec_reg = p[5];
+        const uint8_t rec_len = p[6];
+        p += BusCapture::RECORD_SIZE;
+
+        esp_err_t rec_result = ESP_OK;
+        if (rec_error)
+        {
+            rec_result = static_cast<esp_err_t>(load_le32(p));
+            p += 4;
+        }
+        const size_t payload = (rec_write || !rec_error) ? rec_len : 0;
+        const size_t end = static_cast<size_t>(p - capture_) + payload;
+        if (end > len_)
+        {
+            offset_ = len_;
+            diverge("truncated record", reg);
+            ++replayed_;
+            result = ESP_ERR_NOT_FOUND;
+            return true;
+        }
+
+        // La capture avance dans tous les cas : une divergence n'en décale pas la suite
+        offset_ = end;
+        recorded_us_ += delta_us;
+
+        if (rec_write != write || rec_reg != reg || rec_len != len)
+            result = diverge(rec_write != write ? "direction mismatch" : rec_reg != reg ? "register mismatch" : "length mismatch", reg);
+        else if (write && std::memcmp(written, p, len) != 0)
+            result = diverge("written bytes differ", reg);
+        else
+        {
+            if (!write && payload)
+                std::memcpy(read, p, len);
+            result = rec_result;
+        }
+        ++replayed_;
+        return true;
+    }
+
+    bool BusReplayer::intercept_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result)
+    {
+        return next(false, reg, len, nullptr, data, result);
+    }
+
+    bool BusReplayer::intercept_write(uint8_t reg, const uint8_t *data, size_t len, esp_err_t &result)
+    {
+        return next(true, reg, len, data, nullptr, result);
+    }
+
+    void BusReplayer::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Rejeu I2C ---");
+        ESP_LOGI(TAG, "Transactions rejouées : %lu%s", static_cast<unsigned long>(replayed_),
+                 finished() ? " (capture terminée)" : "");
+        ESP_LOGI(TAG, "Divergences           : %lu (première : %ld)", static_cast<unsigned long>(divergences_),
+                 static_cast<long>(first_divergence_));
+        ESP_LOGI(TAG, "Durée enregistrée     : %llu us", static_cast<unsigned long long>(recorded_us_));
+#endif
+    }
+
+    std::string BusReplayer::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"replayed\": " + std::to_string(replayed_) + ",";
+        json += "\"finished\": " + std::string(finished() ? "true" : "false") + ",";
+        json += "\"divergences\": " + std::to_string(divergences_) + ",";
+        json += "\"first_divergence\": " + std::to_string(first_divergence_) + ",";
+        json += "\"recorded_us\": " + std::to_string(recorded_us_);
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
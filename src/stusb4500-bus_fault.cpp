@@ -0,0 +1,167 @@
+#include "stusb4500-bus_fault.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+namespace stusb4500
+{
+    BusFaultInjector::BusFaultInjector(const Settings &settings, BusTap *downstream)
+        : settings_(settings), downstream_(downstream), state_(settings.seed ? settings.seed : 1)
+    {
+    }
+
+    void BusFaultInjector::fail_next(uint16_t count, BusFault fault)
+    {
+        portENTER_CRITICAL(&lock_);
+        scripted_left_ = count;
+        scripted_ = fault;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    void BusFaultInjector::stick(int64_t duration_us)
+    {
+        const int64_t until = esp_timer_get_time() + duration_us;
+        portENTER_CRITICAL(&lock_);
+        stuck_until_us_ = until;
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    uint32_t BusFaultInjector::next_random()
+    {
+        // xorshift32 : suffisant pour des tirages de test, reproductible à graine égale
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+
+    bool BusFaultInjector::roll(uint32_t ppm)
+    {
+        return ppm != 0 && next_random() % 1000000 < ppm;
+    }
+
+    bool BusFaultInjector::inject(uint8_t reg, esp_err_t &result)
+    {
+        if (!targeted(reg))
+            return false;
+
+        const int64_t now = esp_timer_get_time();
+        bool nack = false;
+        bool timeout = false;
+
+        portENTER_CRITICAL(&lock_);
+        ++stats_.transactions;
+        if (now < stuck_until_us_)
+        {
+            ++stats_.stuck;
+            timeout = true;
+        }
+        else if (scripted_left_ > 0 && scripted_ != BusFault::BitFlip)
+        {
+            --scripted_left_;
+            nack = scripted_ == BusFault::Nack;
+            timeout = scripted_ == BusFault::Timeout;
+            stats_.nacks += nack;
+            stats_.timeouts += timeout;
+        }
+        else
+        {
+            nack = roll(settings_.nack_ppm);
+            timeout = !nack && roll(settings_.timeout_ppm);
+            stats_.nacks += nack;
+            stats_.timeouts += timeout;
+        }
+        portEXIT_CRITICAL(&lock_);
+
+        if (nack)
+        {
+            result = ESP_FAIL;
+            return true;
+        }
+        if (timeout)
+        {
+            // Le maître I2C reste bloqué jusqu'à l'expiration de son délai
+            esp_rom_delay_us(settings_.timeout_us);
+            result = ESP_ERR_TIMEOUT;
+            return true;
+        }
+        return false;
+    }
+
+    bool BusFaultInjector::intercept_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result)
+    {
+        if (inject(reg, result))
+            return true;
+        return downstream_ != nullptr && downstream_->intercept_read(reg, data, len, result);
+    }
+
+    bool BusFaultInjector::intercept_write(uint8_t reg, const uint8_t *data, size_t len, esp_err_t &result)
+    {
+        if (inject(reg, result))
+            return true;
+        return downstream_ != nullptr && downstream_->intercept_write(reg, data, len, result);
+    }
+
+    void BusFaultInjector::filter_read(uint8_t reg, uint8_t *data, size_t len, esp_err_t &result)
+    {
+        if (downstream_ != nullptr)
+            downstream_->filter_read(reg, data, len, result);
+        if (result != ESP_OK || len == 0 || !targeted(reg))
+            return;
+
+        portENTER_CRITICAL(&lock_);
+        bool flip = false;
+        if (scripted_left_ > 0 && scripted_ == BusFault::BitFlip)
+        {
+            --scripted_left_;
+            flip = true;
+        }
+        else
+        {
+            flip = roll(settings_.bitflip_ppm);
+        }
+        const uint32_t bit = flip ? next_random() % (len * 8) : 0;
+        if (flip)
+            ++stats_.bitflips;
+        portEXIT_CRITICAL(&lock_);
+
+        if (flip)
+            data[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+
+    void BusFaultInjector::observe(bool write, uint8_t reg, const uint8_t *data, size_t len, esp_err_t result)
+    {
+        if (downstream_ != nullptr)
+            downstream_->observe(write, reg, data, len, result);
+    }
+
+    void BusFaultInjector::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Injection de défauts I2C ---");
+        ESP_LOGI(TAG, "Transactions visées : %lu", static_cast<unsigned long>(stats_.transactions));
+        ESP_LOGI(TAG, "NACK / timeout      : %lu / %lu", static_cast<unsigned long>(stats_.nacks),
+                 static_cast<unsigned long>(stats_.timeouts));
+        ESP_LOGI(TAG, "Bits inversés       : %lu", static_cast<unsigned long>(stats_.bitflips));
+        ESP_LOGI(TAG, "Bus bloqué          : %lu", static_cast<unsigned long>(stats_.stuck));
+#endif
+    }
+
+    std::string BusFaultInjector::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{";
+        json += "\"transactions\": " + std::to_string(stats_.transactions) + ",";
+        json += "\"nacks\": " + std::to_string(stats_.nacks) + ",";
+        json += "\"timeouts\": " + std::to_string(stats_.timeouts) + ",";
+        json += "\"bitflips\": " + std::to_string(stats_.bitflips) + ",";
+        json += "\"stuck\": " + std::to_string(stats_.stuck);
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -1,55 +1,55 @@
 #include <cstdint>
 #include "stusb4500-common_types.hpp"
+#include "stusb4500-output.hpp"
 
 #include "esp_log.h"
 
 namespace stusb4500
 {
-    static const char *TAG = "STUSB4500-PDO";
-        void PowerProfile::decode(uint32_t raw, size_t index)
+    [[maybe_unused]] static const char *TAG = "STUSB4500-PDO";
+    void PowerProfile::decode(uint32_t raw, size_t index)
     {
+        if (index >= pdos.size())
+            return;
 
         // --- Extraction des champs physiques ---
-        uint16_t voltage_step = (raw >> 10) & 0x3FF;
-        uint16_t current_step = raw & 0x3FF;
-
-        pdos[index].voltage_mv = voltage_step * 50;
-        pdos[index].current_ma = current_step * 10;
-
-        // --- Extraction des bits de configuration partagée ---
-        dual_role_power = raw & (1 << 29);
-        higher_capability = raw & (1 << 28);
-        unconstrained_power = raw & (1 << 27);
-        usb_comm_capable = raw & (1 << 26);
-
-        frs = static_cast<FastRoleSwap>((raw >> 23) & 0x03);
+        pdos[index].voltage_mv = static_cast<uint16_t>(VOLTAGE.decode(raw));
+        pdos[index].current_ma = static_cast<uint16_t>(CURRENT.decode(raw));
+
+        // --- Bits de configuration, propres au PDO1 ---
+        if (index != 0)
+            return;
+        dual_role_power = DUAL_ROLE_POWER.test(raw);
+        higher_capability = HIGHER_CAPABILITY.test(raw);
+        unconstrained_power = UNCONSTRAINED_POWER.test(raw);
+        usb_comm_capable = USB_COMM_CAPABLE.test(raw);
+
+        frs = static_cast<FastRoleSwap>(FRS.decode(raw));
     }
 
     uint32_t PowerProfile::encode(size_t index) const
     {
         uint32_t raw = 0;
+        if (index >= pdos.size())
+            return raw;
 
-        const uint16_t voltage_step = pdos[index].voltage_mv / 50;
-        const uint16_t current_step = pdos[index].current_ma / 10;
-
-        if (dual_role_power)
-            raw |= (1 << 29);
-        if (higher_capability)
-            raw |= (1 << 28);
-        if (unconstrained_power)
-            raw |= (1 << 27);
-        if (usb_comm_capable)
-            raw |= (1 << 26);
-
-        raw |= (static_cast<uint32_t>(frs) & 0x03) << 23;
-        raw |= (static_cast<uint32_t>(voltage_step) & 0x3FF) << 10;
-        raw |= (static_cast<uint32_t>(current_step) & 0x3FF);
+        if (index == 0)
+        {
+            raw = DUAL_ROLE_POWER.encode(raw, dual_role_power);
+            raw = HIGHER_CAPABILITY.encode(raw, higher_capability);
+            raw = UNCONSTRAINED_POWER.encode(raw, unconstrained_power);
+            raw = USB_COMM_CAPABLE.encode(raw, usb_comm_capable);
+            raw = FRS.encode(raw, static_cast<uint32_t>(frs));
+        }
+        raw = VOLTAGE.encode(raw, pdos[index].voltage_mv);
+        raw = CURRENT.encode(raw, pdos[index].current_ma);
 
         return raw;
     }
 
     void PowerProfile::log() const
     {
+#if STUSB4500_LOG_TEXT
         ESP_LOGI(TAG, "====== Power Profile ======");
         ESP_LOGI(TAG, "Common Flags:");
         ESP_LOGI(TAG, "  CommCapable     : %s", usb_comm_capable ? "Yes" : "No");
@@ -59,17 +59,19 @@ namespace stusb4500
         ESP_LOGI(TAG, "  FRS             : 0x%02X", static_cast<uint8_t>(frs));
         ESP_LOGI(TAG, "PDO Count         : %u", pdo_number);
         
-        for (size_t i = 0; i < pdos.size(); ++i)
+        for (size_t i = 0; i < pdo_number && i < pdos.size(); ++i)
         {
             ESP_LOGI(TAG, "--- PDO #%zu ---", i);
             pdos[i].log();
         }
     
         ESP_LOGI(TAG, "===========================");
+#endif
     }
 
     std::string PowerProfile::to_json() const
     {
+#if STUSB4500_JSON_OUTPUT
         std::string json = "{";
 
         json += "\"usb_comm_capable\": " + std::string(usb_comm_capable ? "true" : "false") + ",";
@@ -80,10 +82,10 @@ namespace stusb4500
         json += "\"pdo_number\": " + std::to_string(pdo_number) + ",";
 
         json += "\"pdos\": [";
-        for (size_t i = 0; i < pdos.size(); ++i)
+        for (size_t i = 0; i < pdo_number && i < pdos.size(); ++i)
         {
             json += pdos[i].to_json();
-            if (i + 1 < pdos.size())
+            if (i + 1 < pdo_number && i + 1 < pdos.size())
                 json += ",";
         }
         json += "]";
@@ -91,19 +93,28 @@ namespace stusb4500
         json += "}";
 
         return json;
+#else
+        return {};
+#endif
     }
 
 
-    void PDObjectProfile::log() const{      
+    void PDObjectProfile::log() const{
+#if STUSB4500_LOG_TEXT
         ESP_LOGI(TAG, "  Voltage : %u mV, Current : %u mA", voltage_mv, current_ma);
+#endif
     }
 
     std::string PDObjectProfile::to_json() const
     {
+#if STUSB4500_JSON_OUTPUT
         return std::string("{") +
             "\"voltage_mv\": " + std::to_string(voltage_mv) + "," +
             "\"current_ma\": " + std::to_string(current_ma) +
             "}";
+#else
+        return {};
+#endif
     }
 
 }
\ No newline at end of file
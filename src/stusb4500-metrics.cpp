@@ -0,0 +1,234 @@
+#include "stusb4500-metrics.hpp"
+#include "stusb4500-output.hpp"
+
+#include "esp_log.h"
+
+namespace stusb4500
+{
+    [[maybe_unused]] static const char *TAG = "STUSB4500-METRICS";
+
+    template <typename T, std::size_t N>
+    static void copy_counters(const std::array<std::atomic<T>, N> &from, std::array<T, N> &to)
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            to[i] = from[i].load(std::memory_order_relaxed);
+    }
+
+    template <typename T, std::size_t N>
+    static void clear_counters(std::array<std::atomic<T>, N> &counters)
+    {
+        for (auto &counter : counters)
+            counter.store(0, std::memory_order_relaxed);
+    }
+
+    MetricsSnapshot Metrics::snapshot() const
+    {
+        MetricsSnapshot out;
+        for (std::size_t i = 0; i < bus_.size(); ++i)
+        {
+            out.bus[i].reads = bus_[i].reads.load(std::memory_order_relaxed);
+            out.bus[i].writes = bus_[i].writes.load(std::memory_order_relaxed);
+            out.bus[i].read_bytes = bus_[i].read_bytes.load(std::memory_order_relaxed);
+            out.bus[i].write_bytes = bus_[i].write_bytes.load(std::memory_order_relaxed);
+            out.bus[i].retries = bus_[i].retries.load(std::memory_order_relaxed);
+            out.bus[i].failures = bus_[i].failures.load(std::memory_order_relaxed);
+        }
+        copy_counters(alerts_, out.alerts);
+        out.alerts_total = alerts_total_.load(std::memory_order_relaxed);
+        copy_counters(alert_duration_, out.alert_duration);
+        copy_counters(nvm_ops_, out.nvm_ops);
+        copy_counters(nvm_failures_, out.nvm_failures);
+        for (std::size_t i = 0; i < nvm_duration_.size(); ++i)
+            copy_counters(nvm_duration_[i], out.nvm_duration[i]);
+        copy_counters(recoveries_, out.recoveries);
+        copy_counters(recovery_failures_, out.recovery_failures);
+        for (std::size_t i = 0; i < recovery_duration_.size(); ++i)
+            copy_counters(recovery_duration_[i], out.recovery_duration[i]);
+        copy_counters(recovery_max_us_, out.recovery_max_us);
+        out.contract_changes = contract_changes_.load(std::memory_order_relaxed);
+        out.contract_power_mw = contract_power_mw_.load(std::memory_order_relaxed);
+        out.attach_contracts = attach_contracts_.load(std::memory_order_relaxed);
+        copy_counters(attach_to_contract_, out.attach_to_contract);
+        out.attach_to_contract_last_us = attach_to_contract_last_us_.load(std::memory_order_relaxed);
+        out.attach_to_contract_max_us = attach_to_contract_max_us_.load(std::memory_order_relaxed);
+        out.fast_path_hits = fast_path_hits_.load(std::memory_order_relaxed);
+        out.fast_path_misses = fast_path_misses_.load(std::memory_order_relaxed);
+        out.rx_bytes_saved = rx_bytes_saved_.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    void Metrics::reset()
+    {
+        for (auto &bus : bus_)
+        {
+            bus.reads.store(0, std::memory_order_relaxed);
+            bus.writes.store(0, std::memory_order_relaxed);
+            bus.read_bytes.store(0, std::memory_order_relaxed);
+            bus.write_bytes.store(0, std::memory_order_relaxed);
+            bus.retries.store(0, std::memory_order_relaxed);
+            bus.failures.store(0, std::memory_order_relaxed);
+        }
+        clear_counters(alerts_);
+        alerts_total_.store(0, std::memory_order_relaxed);
+        clear_counters(alert_duration_);
+        clear_counters(nvm_ops_);
+        clear_counters(nvm_failures_);
+        for (auto &histogram : nvm_duration_)
+            clear_counters(histogram);
+        clear_counters(recoveries_);
+        clear_counters(recovery_failures_);
+        for (auto &histogram : recovery_duration_)
+            clear_counters(histogram);
+        clear_counters(recovery_max_us_);
+        contract_changes_.store(0, std::memory_order_relaxed);
+        contract_power_mw_.store(0, std::memory_order_relaxed);
+        attach_contracts_.store(0, std::memory_order_relaxed);
+        clear_counters(attach_to_contract_);
+        attach_to_contract_last_us_.store(0, std::memory_order_relaxed);
+        attach_to_contract_max_us_.store(0, std::memory_order_relaxed);
+        fast_path_hits_.store(0, std::memory_order_relaxed);
+        fast_path_misses_.store(0, std::memory_order_relaxed);
+        rx_bytes_saved_.store(0, std::memory_order_relaxed);
+    }
+
+    const char *MetricsSnapshot::to_string(RegClass cls)
+    {
+        switch (cls)
+        {
+        case RegClass::Status: return "status";
+        case RegClass::Ctrl:   return "ctrl";
+        case RegClass::RX:     return "rx";
+        case RegClass::NVM:    return "nvm";
+        case RegClass::PDO:    return "pdo";
+        case RegClass::RDO:    return "rdo";
+        default:               return "other";
+        }
+    }
+
+    const char *MetricsSnapshot::to_string(AlertKind kind)
+    {
+        switch (kind)
+        {
+        case AlertKind::PortStatus:      return "port_status";
+        case AlertKind::TypeCMonitoring: return "typec_monitoring";
+        case AlertKind::CCHwFault:       return "cc_hw_fault";
+        case AlertKind::PDTypeC:         return "pd_typec";
+        case AlertKind::PRTStatus:       return "prt_status";
+        default:                         return "unknown";
+        }
+    }
+
+    const char *MetricsSnapshot::to_string(RecoveryKind kind)
+    {
+        switch (kind)
+        {
+        case RecoveryKind::Nvm:    return "nvm";
+        case RecoveryKind::Status: return "status";
+        default:                   return "unknown";
+        }
+    }
+
+    [[maybe_unused]] static std::string histogram_json(const MetricsSnapshot::Histogram &histogram)
+    {
+        std::string json = "[";
+        for (std::size_t i = 0; i < histogram.size(); ++i)
+        {
+            if (i)
+                json += ",";
+            json += std::to_string(histogram[i]);
+        }
+        json += "]";
+        return json;
+    }
+
+    void MetricsSnapshot::log() const
+    {
+#if STUSB4500_LOG_TEXT
+        ESP_LOGI(TAG, "--- Driver metrics ---");
+        ESP_LOGI(TAG, "%-7s %8s %8s %9s %9s %7s %7s", "class", "reads", "writes", "rd bytes", "wr bytes", "retries", "fails");
+        for (std::size_t i = 0; i < bus.size(); ++i)
+        {
+            const Bus &b = bus[i];
+            ESP_LOGI(TAG, "%-7s %8u %8u %9u %9u %7u %7u", to_string(static_cast<RegClass>(i)),
+                     static_cast<unsigned>(b.reads), static_cast<unsigned>(b.writes),
+                     static_cast<unsigned>(b.read_bytes), static_cast<unsigned>(b.write_bytes),
+                     static_cast<unsigned>(b.retries), static_cast<unsigned>(b.failures));
+        }
+        ESP_LOGI(TAG, "Alerts           : %u", static_cast<unsigned>(alerts_total));
+        for (std::size_t i = 0; i < alerts.size(); ++i)
+            ESP_LOGI(TAG, "  %-16s: %u", to_string(static_cast<AlertKind>(i)), static_cast<unsigned>(alerts[i]));
+        ESP_LOGI(TAG, "NVM read/write   : %u/%u (failures %u/%u)",
+                 static_cast<unsigned>(nvm_ops[0]), static_cast<unsigned>(nvm_ops[1]),
+                 static_cast<unsigned>(nvm_failures[0]), static_cast<unsigned>(nvm_failures[1]));
+        for (std::size_t i = 0; i < recoveries.size(); ++i)
+            ESP_LOGI(TAG, "Recovery %-7s : %u (failures %u, max %u us)", to_string(static_cast<RecoveryKind>(i)),
+                     static_cast<unsigned>(recoveries[i]), static_cast<unsigned>(recovery_failures[i]),
+                     static_cast<unsigned>(recovery_max_us[i]));
+        ESP_LOGI(TAG, "Contract changes : %u (now %u mW)", static_cast<unsigned>(contract_changes),
+                 static_cast<unsigned>(contract_power_mw));
+        ESP_LOGI(TAG, "Attach->contract : %u (last %u us, max %u us)", static_cast<unsigned>(attach_contracts),
+                 static_cast<unsigned>(attach_to_contract_last_us), static_cast<unsigned>(attach_to_contract_max_us));
+        ESP_LOGI(TAG, "Fast path        : %u hits / %u misses", static_cast<unsigned>(fast_path_hits),
+                 static_cast<unsigned>(fast_path_misses));
+        ESP_LOGI(TAG, "RX bytes saved   : %u", static_cast<unsigned>(rx_bytes_saved));
+#endif
+    }
+
+    std::string MetricsSnapshot::to_json() const
+    {
+#if STUSB4500_JSON_OUTPUT
+        std::string json = "{\"i2c\": {";
+        for (std::size_t i = 0; i < bus.size(); ++i)
+        {
+            const Bus &b = bus[i];
+            if (i)
+                json += ",";
+            json += "\"" + std::string(to_string(static_cast<RegClass>(i))) + "\": {";
+            json += "\"reads\": " + std::to_string(b.reads) + ",";
+            json += "\"writes\": " + std::to_string(b.writes) + ",";
+            json += "\"read_bytes\": " + std::to_string(b.read_bytes) + ",";
+            json += "\"write_bytes\": " + std::to_string(b.write_bytes) + ",";
+            json += "\"retries\": " + std::to_string(b.retries) + ",";
+            json += "\"failures\": " + std::to_string(b.failures) + "}";
+        }
+        json += "},\"alerts\": {\"total\": " + std::to_string(alerts_total);
+        for (std::size_t i = 0; i < alerts.size(); ++i)
+            json += ",\"" + std::string(to_string(static_cast<AlertKind>(i))) + "\": " + std::to_string(alerts[i]);
+        json += ",\"duration_hist\": " + histogram_json(alert_duration) + "},";
+        json += "\"nvm\": {";
+        json += "\"reads\": " + std::to_string(nvm_ops[0]) + ",";
+        json += "\"writes\": " + std::to_string(nvm_ops[1]) + ",";
+        json += "\"read_failures\": " + std::to_string(nvm_failures[0]) + ",";
+        json += "\"write_failures\": " + std::to_string(nvm_failures[1]) + ",";
+        json += "\"read_duration_hist\": " + histogram_json(nvm_duration[0]) + ",";
+        json += "\"write_duration_hist\": " + histogram_json(nvm_duration[1]) + "},";
+        json += "\"recovery\": {";
+        for (std::size_t i = 0; i < recoveries.size(); ++i)
+        {
+            if (i)
+                json += ",";
+            json += "\"" + std::string(to_string(static_cast<RecoveryKind>(i))) + "\": {";
+            json += "\"count\": " + std::to_string(recoveries[i]) + ",";
+            json += "\"failures\": " + std::to_string(recovery_failures[i]) + ",";
+            json += "\"max_us\": " + std::to_string(recovery_max_us[i]) + ",";
+            json += "\"duration_hist\": " + histogram_json(recovery_duration[i]) + "}";
+        }
+        json += "},";
+        json += "\"contract_changes\": " + std::to_string(contract_changes) + ",";
+        json += "\"contract_power_mw\": " + std::to_string(contract_power_mw) + ",";
+        json += "\"attach_to_contract\": {";
+        json += "\"count\": " + std::to_string(attach_contracts) + ",";
+        json += "\"last_us\": " + std::to_string(attach_to_contract_last_us) + ",";
+        json += "\"max_us\": " + std::to_string(attach_to_contract_max_us) + ",";
+        json += "\"duration_hist\": " + histogram_json(attach_to_contract) + ",";
+        json += "\"fast_path_hits\": " + std::to_string(fast_path_hits) + ",";
+        json += "\"fast_path_misses\": " + std::to_string(fast_path_misses) + "},";
+        json += "\"rx_bytes_saved\": " + std::to_string(rx_bytes_saved);
+        json += "}";
+        return json;
+#else
+        return {};
+#endif
+    }
+
+} // namespace stusb4500
@@ -1,8 +1,12 @@
 #include "config/stusb4500-config_macro.hpp"
 #include "config/stusb4500-config_types.hpp"
 #include "stusb4500.hpp"
+#include "stusb4500-output.hpp"
 #include "sdkconfig.h"
 
+#include <algorithm>
+#include <cinttypes>
+
 #define RETURN_IF_ERROR(x)         \
     do {                           \
         esp_err_t __err_rc = (x);  \
@@ -16,10 +20,12 @@
         switch (format)                                       \
         {                                                     \
             case OutputFormat::Log:                           \
-                obj.log();                                    \
+                if (STUSB4500_LOG_TEXT)                       \
+                    obj.log();                                \
                 break;                                        \
             case OutputFormat::JSON:                          \
-                printf("%s\n", obj.to_json().c_str());        \
+                if (STUSB4500_JSON_OUTPUT)                    \
+                    printf("%s\n", obj.to_json().c_str());    \
                 break;                                        \
             case OutputFormat::None:                          \
             default:                                          \
@@ -41,12 +47,30 @@ namespace stusb4500
         return ESP_OK;
     }
 
+    /// Verrou du composant (mutex récursif) tenu jusqu'à la fin de la portée
+    class DeviceLock
+    {
+    public:
+        explicit DeviceLock(SemaphoreHandle_t mutex) : mutex_(mutex) { xSemaphoreTakeRecursive(mutex_, portMAX_DELAY); }
+        ~DeviceLock() { xSemaphoreGiveRecursive(mutex_); }
+        DeviceLock(const DeviceLock &) = delete;
+        DeviceLock &operator=(const DeviceLock &) = delete;
+
+    private:
+        SemaphoreHandle_t mutex_;
+    };
+
     STUSB4500Manager::STUSB4500Manager(I2CDevices &i2c)
         : i2c_(i2c),
           cfg_(i2c_),
+#if defined(CONFIG_STUSB4500_INT_ALERT)
           alert_gpio_(gpio_num_t(CONFIG_STUSB4500_INT_ALERT)),
+#else
+          alert_gpio_(GPIO_NUM_NC),
+#endif
           status_(i2c_),
-          ctrl_(i2c_)
+          ctrl_(i2c_),
+          device_lock_(xSemaphoreCreateRecursiveMutexStatic(&device_lock_buffer_))
           {}
 
     // === API PUBLIQUE ===
@@ -58,13 +82,18 @@ namespace stusb4500
 
     esp_err_t STUSB4500Manager::init_device()
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(is_ready());
         ConfigParams from_kconfig = load_config_from_kconfig();
         cfg_.datas() = from_kconfig ; 
         cfg_.datas().log();
+        configured_sink_ = from_kconfig.power_;
         RETURN_IF_ERROR(get_status());
-        RETURN_IF_ERROR(apply_nvm_config(from_kconfig));
-        return ESP_OK;
+        // Image encodée à la compilation : comparée et programmée telle quelle
+        RETURN_IF_ERROR(apply_nvm_image(kconfig_nvm_image(), from_kconfig));
+        RETURN_IF_ERROR(apply_active_profile());
+        update_charger_context();
+        return update_alert_mask(true);
     }
 
     esp_err_t STUSB4500Manager::is_ready()
@@ -95,14 +124,21 @@ namespace stusb4500
     }
 
     esp_err_t STUSB4500Manager::apply_nvm_config(ConfigParams &cfg)
-    {   
+    {
+        DeviceLock lock(device_lock_);
+        return apply_nvm_image(NVMData::encode_image(cfg), cfg);
+    }
+
+    esp_err_t STUSB4500Manager::apply_nvm_image(const std::array<uint8_t, 40> &image, const ConfigParams &cfg)
+    {
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
-        esp_err_t err = check_nvm_config(cfg);
+        esp_err_t err = check_nvm_image(image, cfg);
         if ( err == ESP_ERR_INVALID_STATE)
         {
-            NVMData new_nvm(cfg);
             NVM iface_nvm(i2c_);
-            RETURN_IF_ERROR(iface_nvm.write(new_nvm));
+            esp_err_t write_err = iface_nvm.write(image);
+            journal(JournalEvent::NvmWrite, 0, static_cast<uint32_t>(write_err));
+            RETURN_IF_ERROR(write_err);
             vTaskDelay(pdMS_TO_TICKS(1000));
             reset(); 
             vTaskDelay(pdMS_TO_TICKS(1000));
@@ -112,17 +148,60 @@ namespace stusb4500
         return ESP_OK;    
     }
 
+    esp_err_t STUSB4500Manager::apply_config(const ConfigParams &target, bool program_nvm, OutputFormat format)
+    {
+        DeviceLock lock(device_lock_);
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        ConfigParams current = cfg_.datas();
+        ConfigPatch patch(i2c_);
+        RETURN_IF_ERROR(patch.read_current(current));
+        // Le masque d'alerte volatil reste dérivé des abonnements
+        ConfigParams wanted = target;
+        wanted.alert_mask.set_raw(subscriptions_.mask(target.alert_mask.get_raw()));
+        patch.compute(current, wanted);
+        HANDLE_OUTPUT(format, patch);
+
+        if (patch.needs_nvm())
+        {
+            if (!program_nvm)
+            {
+                ESP_LOGW(TAG, "Champs NVM modifiés ignorés (program_nvm = false)");
+            }
+            else
+            {
+                ConfigParams nvm_target = target;
+                RETURN_IF_ERROR(apply_nvm_config(nvm_target));
+            }
+        }
+
+        RETURN_IF_ERROR(patch.apply());
+        cfg_.datas() = (patch.needs_nvm() && program_nvm) ? wanted : ConfigPatch::reachable(current, wanted);
+        configured_sink_ = cfg_.datas().power_;
+        fallback_active_ = false;
+        update_charger_context();
+
+        if (!patch.needs_renegotiation())
+            return ESP_OK;
+        table_adjusted_ = false;
+        return renegotiate();
+    }
+
     esp_err_t STUSB4500Manager::check_nvm_config(ConfigParams &cfg)
+    {
+        DeviceLock lock(device_lock_);
+        return check_nvm_image(NVMData::encode_image(cfg), cfg);
+    }
+
+    esp_err_t STUSB4500Manager::check_nvm_image(const std::array<uint8_t, 40> &image, const ConfigParams &cfg)
     {
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
-        NVMData new_nvm(cfg);
         ConfigParams active_cfg;
         NVMData active_nvm(active_cfg);
         NVM iface_nvm(i2c_);
         RETURN_IF_ERROR(iface_nvm.read(active_nvm));
-        if (! active_nvm.equals(new_nvm.to_array()))
+        if (! active_nvm.equals(image))
         {
-            active_nvm.print_diff(new_nvm.to_array());
+            active_nvm.print_diff(image);
             ESP_LOGI(TAG, "Old configuration :");
             active_cfg.log();
             ESP_LOGI(TAG, "New configuration :");
@@ -134,28 +213,120 @@ namespace stusb4500
 
     esp_err_t STUSB4500Manager::handle_alert()
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        RETURN_IF_ERROR(apply_pending_mask());
+        const int64_t start = esp_timer_get_time();
+        RETURN_IF_ERROR(status_.read_alert_status());
+        return process_alert(start);
+    }
+
+    int STUSB4500Manager::subscribe(uint8_t classes, AlertHandler handler, void *ctx)
+    {
+        const int id = subscriptions_.subscribe(classes, handler, ctx);
+        if (id >= 0)
+        {
+            // Appelant quelconque : le bus et cfg_ restent à la tâche du driver
+            mask_pending_ = true;
+            if (task_handle_ != nullptr)
+                xTaskNotifyGive(task_handle_);
+        }
+        return id;
+    }
+
+    esp_err_t STUSB4500Manager::unsubscribe(int id)
+    {
+        if (!subscriptions_.unsubscribe(id))
+            return ESP_ERR_NOT_FOUND;
+        mask_pending_ = true;
+        if (task_handle_ != nullptr)
+            xTaskNotifyGive(task_handle_);
+        return ESP_OK;
+    }
+
+    esp_err_t STUSB4500Manager::apply_pending_mask()
+    {
+        if (!ready_ || !mask_pending_)
+            return ESP_OK;
+        return update_alert_mask();
+    }
+
+    esp_err_t STUSB4500Manager::update_alert_mask(bool force)
+    {
+        // Avant de lire les abonnements : une modification concurrente relève à nouveau le drapeau
+        mask_pending_ = false;
+        auto &mask = cfg_.datas().alert_mask;
+        const uint8_t wanted = subscriptions_.mask(mask.get_raw());
+        if (!force && wanted == mask.get_raw())
+            return ESP_OK;
+
+        const uint8_t previous = mask.get_raw();
+        mask.set_raw(wanted);
+        ESP_LOGI(TAG, "ALERT_STATUS_1_MASK = 0x%02X", wanted);
+        esp_err_t err = cfg_.set_alert_status_mask();
+        if (err != ESP_OK)
+        {
+            // Masque non écrit : réécrit au prochain réveil de la tâche, quelle que soit la reprise
+            mask.set_raw(previous);
+            mask_pending_ = true;
+        }
+        return err;
+    }
+
+    esp_err_t STUSB4500Manager::poll_alert()
+    {
+        const int64_t start = esp_timer_get_time();
         RETURN_IF_ERROR(status_.read_alert_status());
+        const bool pending = consumed_alerts() != 0;
+        poller_.on_poll(start, pending);
+        return pending ? process_alert(start) : ESP_OK;
+    }
+
+    uint8_t STUSB4500Manager::consumed_alerts() const
+    {
+        // Bits d'alerte valides seulement (le bit 0 et le bit 2 sont réservés)
+        constexpr uint8_t ALERT_BITS = AlertSubscriptions::MASKABLE | (1 << 3);
+        const uint8_t masked = cfg_.datas().alert_mask.get_raw() & AlertSubscriptions::MASKABLE;
+        return status_.alert_status_1.get_raw() & ALERT_BITS & ~masked;
+    }
 
-        if (status_.alert_status_1.get_values().port_status_al )
+    esp_err_t STUSB4500Manager::process_alert(int64_t start)
+    {
+        count_alerts();
+        // Familles masquées : aucun consommateur, pas de lecture des registres associés
+        const uint8_t consumed = consumed_alerts();
+        AlertStatus1Register active;
+        active.set_raw(consumed);
+        const auto pending = active.get_values();
+
+        if (pending.port_status_al)
         {
             RETURN_IF_ERROR(status_.read_port_status_0());
             status_.port_status_0.log();
+            RETURN_IF_ERROR(status_.read_port_status_1());
+            on_attach_change(status_.port_status_1.get_values().attached);
         }
 
-        if (status_.alert_status_1.get_values().typec_monitoring_status_al)
+        if (pending.typec_monitoring_status_al)
         {
             RETURN_IF_ERROR(status_.read_typec_monitoring_status_0());
             status_.typec_monitoring_status_0.log();
         }
 
-        if (status_.alert_status_1.get_values().cc_hw_fault_status_al)
+        if (pending.cc_hw_fault_status_al)
         {
             RETURN_IF_ERROR(status_.read_cc_hw_fault_status_0());
             status_.cc_hw_fault_0.log();
+            RETURN_IF_ERROR(status_.read_cc_hw_fault_status_1());
+            const auto faults = status_.cc_hw_fault_1.get_values();
+            if (faults.vpu_ovp_fault || faults.vbus_disch_fault)
+            {
+                watchdog_.on_cc_fault(esp_timer_get_time());
+                journal(JournalEvent::CCFault, status_.cc_hw_fault_1.get_raw());
+            }
         }
 
-        if (status_.alert_status_1.get_values().prt_status_al)
+        if (pending.prt_status_al)
         {
             RETURN_IF_ERROR(status_.read_prt_status());
             status_.prt_status.log();
@@ -163,6 +334,8 @@ namespace stusb4500
             if (status_.prt_status.get_values().prl_hw_rst_received)
             {
                 ESP_LOGW(TAG, "PD Hardware Reset detected. Clearing local PD state.");
+                watchdog_.on_hard_reset_received(esp_timer_get_time());
+                journal(JournalEvent::HardResetReceived);
             }
 
             if (status_.prt_status.get_values().prt_ibist_received)
@@ -171,16 +344,105 @@ namespace stusb4500
             }
 
             if (status_.prt_status.get_values().prl_msg_received)
-            {   
-                get_active_pdo(OutputFormat::Log);
+            {
+                refresh_contract(OutputFormat::Log, true);
             }
         }
+        publish_snapshot();
+        subscriptions_.dispatch(consumed, shadow_);
+        Metrics::instance().on_alert_handled(esp_timer_get_time() - start);
         return ESP_OK;
     }
 
+    void STUSB4500Manager::on_attach_change(bool attached)
+    {
+        // Les capacités annoncées ne valent que pour le chargeur courant
+        if (!attached)
+        {
+            source_caps_.clear();
+            table_adjusted_ = false;
+            charger_fingerprint_ = 0;
+            shadow_.active_pdo = 0;
+            shadow_.active_voltage_mv = 0;
+            shadow_.active_current_ma = 0;
+            if (power_.stats().contract_power_mw != 0)
+                Metrics::instance().on_contract(0);
+            power_.on_detach(esp_timer_get_time());
+            watchdog_.on_detach();
+            // Ni le repli 5 V ni la table anticipée ou ajustée pour ce chargeur ne valent pour le suivant
+            if (restore_configured_sink() != ESP_OK)
+                ESP_LOGW(TAG, "Table PDO configurée non restaurée");
+            attach_us_ = 0;
+            fast_path_fingerprint_ = 0;
+            fast_path_late_ = false;
+            journal(JournalEvent::Detach);
+        }
+        else
+        {
+            attach_us_ = esp_timer_get_time();
+            watchdog_.on_attach(attach_us_);
+            journal(JournalEvent::Attach);
+            if (apply_attach_fast_path() != ESP_OK)
+                ESP_LOGW(TAG, "Table PDO anticipée non écrite");
+        }
+    }
+
+    esp_err_t STUSB4500Manager::resync()
+    {
+        // ALERT_STATUS_1 est effacé à la lecture : une alerte dont le traitement a échoué est perdue,
+        // l'état est donc relu en entier et les transitions manquées rejouées
+        const bool was_attached = status_.port_status_1.get_values().attached;
+        RETURN_IF_ERROR(get_status());
+        // Un reset du STUSB4500 pendant la coupure aurait rétabli le masque NVM
+        RETURN_IF_ERROR(update_alert_mask(true));
+
+        const bool attached = status_.port_status_1.get_values().attached;
+        if (attached != was_attached)
+            on_attach_change(attached);
+        return attached ? refresh_contract(OutputFormat::None, false) : ESP_OK;
+    }
+
+    void STUSB4500Manager::recover_status(int64_t start)
+    {
+        if (bus_fault_since_us_ == 0)
+            bus_fault_since_us_ = start;
+
+        const bool ok = resync() == ESP_OK;
+        const int64_t duration_us = esp_timer_get_time() - bus_fault_since_us_;
+        if (!ok && duration_us < RESYNC_DEADLINE_US)
+            return;
+
+        Metrics::instance().on_recovery(RecoveryKind::Status, duration_us, ok);
+        journal(JournalEvent::BusRecovery, ok, static_cast<uint32_t>(duration_us));
+        if (ok)
+            ESP_LOGW(TAG, "État resynchronisé %lld us après l'erreur bus", static_cast<long long>(duration_us));
+        else
+            ESP_LOGE(TAG, "Resynchronisation abandonnée après %lld us, en attente de la prochaine alerte",
+                     static_cast<long long>(duration_us));
+        // Échec compté une fois : plus de nouvel essai périodique, la prochaine alerte relance la reprise
+        bus_fault_since_us_ = 0;
+    }
+
+    void STUSB4500Manager::count_alerts()
+    {
+        const auto alerts = status_.alert_status_1.get_values();
+        Metrics &metrics = Metrics::instance();
+        if (alerts.port_status_al)
+            metrics.on_alert(AlertKind::PortStatus);
+        if (alerts.typec_monitoring_status_al)
+            metrics.on_alert(AlertKind::TypeCMonitoring);
+        if (alerts.cc_hw_fault_status_al)
+            metrics.on_alert(AlertKind::CCHwFault);
+        if (alerts.pd_typec_status_al)
+            metrics.on_alert(AlertKind::PDTypeC);
+        if (alerts.prt_status_al)
+            metrics.on_alert(AlertKind::PRTStatus);
+    }
+
     /// Envoie un soft reset au STUSB4500
     esp_err_t STUSB4500Manager::reset()
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
         return ctrl_.send_soft_reset();
     }
@@ -188,24 +450,296 @@ namespace stusb4500
     /// Réécrit le PDO avec la configuration par défaut et force une renégociation
     esp_err_t STUSB4500Manager::reconfigure(uint8_t index, Config &cfg)
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
-        PDO active_pdo(i2c_,index,cfg.datas().power_.pdos[index]);
+        // Index 1-based comme le registre DPM_PDO_NUMB ; la table de la configuration commence à 0
+        if (index < 1 || index > cfg.datas().power_.pdos.size())
+        {
+            ESP_LOGE(TAG, "Invalid PDO index %u (must be 1, 2 or 3)", static_cast<unsigned>(index));
+            return ESP_ERR_INVALID_ARG;
+        }
+        PDO active_pdo(i2c_, index, cfg.datas().power_.pdos[index - 1]);
         RETURN_IF_ERROR(active_pdo.write());
         RETURN_IF_ERROR(ctrl_.update_pdo_number(index));
+        forget_charger();
         return ESP_OK;
     }
 
+    esp_err_t STUSB4500Manager::benchmark_negotiation(uint16_t iterations, NegotiationResult &result,
+                                                      OutputFormat format)
+    {
+        DeviceLock lock(device_lock_);
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        NegotiationBench bench(i2c_);
+        esp_err_t err = bench.run(iterations, result, [this]() { return ctrl_.send_soft_reset(); });
+        HANDLE_OUTPUT(format, result);
+        return err;
+    }
+
+    void STUSB4500Manager::set_load_profile(const LoadProfile &load)
+    {
+        DeviceLock lock(device_lock_);
+        load_ = load;
+        policy_enabled_ = true;
+        table_adjusted_ = false;
+        update_charger_context();
+    }
+
+    esp_err_t STUSB4500Manager::apply_policy(OutputFormat format)
+    {
+        DeviceLock lock(device_lock_);
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        if (source_caps_.empty())
+        {
+            ESP_LOGW(TAG, "Aucune capacité source reçue, politique non appliquée");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        PowerProfile &sink = cfg_.datas().power_;
+        SinkPlan plan = ContractPolicy::select(source_caps_, load_, sink.pdos[0]);
+        HANDLE_OUTPUT(format, plan);
+
+        if (!plan.meets_requirement)
+            ESP_LOGW(TAG, "Aucun PDO source ne couvre %u mW", static_cast<unsigned>(load_.required_power_mw));
+
+        if (plan.same_pdos(sink))
+            return ESP_OK;
+
+        PDOTable table(i2c_, sink);
+        for (size_t i = 0; i < sink.pdos.size(); ++i)
+            table.power().pdos[i] = plan.pdos[i];
+        table.power().pdo_number = plan.pdo_number;
+        RETURN_IF_ERROR(table.write());
+        sink = table.power();
+
+        ESP_LOGI(TAG, "Renégociation vers le PDO source %u (%u mW)", plan.source_position,
+                 static_cast<unsigned>(plan.expected_power_mw));
+        return renegotiate();
+    }
+
+    esp_err_t STUSB4500Manager::set_store(KeyValueStore *store)
+    {
+        DeviceLock lock(device_lock_);
+        store_ = store;
+        if (store_ == nullptr)
+            return ESP_OK;
+
+        esp_err_t err = chargers_.load(*store_);
+        // Cache absent ou écrit par une autre configuration : on repart d'un cache vide
+        if (err == ESP_ERR_NOT_FOUND || err == ESP_ERR_INVALID_VERSION || err == ESP_ERR_INVALID_SIZE)
+            return ESP_OK;
+        return err;
+    }
+
+    esp_err_t STUSB4500Manager::save_profile(const char *name, const PowerProfile &power)
+    {
+        DeviceLock lock(device_lock_);
+        if (store_ == nullptr)
+            return ESP_ERR_INVALID_STATE;
+        ProfileStore profiles(*store_);
+        return profiles.save(name, power);
+    }
+
+    esp_err_t STUSB4500Manager::switch_profile(const char *name)
+    {
+        DeviceLock lock(device_lock_);
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        if (store_ == nullptr)
+            return ESP_ERR_INVALID_STATE;
+
+        ProfileStore profiles(*store_);
+        PowerProfile power = cfg_.datas().power_;
+        RETURN_IF_ERROR(profiles.load(name, power));
+
+        // Le profil remplace aussi la table à restaurer après un repli 5 V
+        configured_sink_ = power;
+        fallback_active_ = false;
+        table_adjusted_ = false;
+        RETURN_IF_ERROR(write_pdo_table(power, true));
+        ESP_LOGI(TAG, "Profil '%s' appliqué", name);
+        return profiles.set_active(name);
+    }
+
+    esp_err_t STUSB4500Manager::apply_active_profile()
+    {
+        if (store_ == nullptr)
+            return ESP_OK;
+
+        ProfileStore profiles(*store_);
+        char name[ProfileStore::NAME_LEN + 1];
+        esp_err_t err = profiles.active(name);
+        if (err == ESP_ERR_NOT_FOUND)
+            return ESP_OK;
+        RETURN_IF_ERROR(err);
+
+        PowerProfile power = cfg_.datas().power_;
+        err = profiles.load(name, power);
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Profil actif '%s' illisible, configuration NVM conservée", name);
+            return ESP_OK;
+        }
+
+        configured_sink_ = power;
+        ESP_LOGI(TAG, "Profil '%s' restauré", name);
+        return write_pdo_table(power, true);
+    }
+
+    esp_err_t STUSB4500Manager::set_journal(EventJournal *journal)
+    {
+        journal_ = journal;
+        if (journal_ == nullptr)
+            return ESP_OK;
+
+        RETURN_IF_ERROR(journal_->mount());
+        journal_->record(JournalEvent::Boot);
+        return ESP_OK;
+    }
+
+    void STUSB4500Manager::journal(JournalEvent event, uint16_t arg16, uint32_t arg32)
+    {
+        if (journal_ != nullptr)
+            journal_->record(event, arg16, arg32);
+    }
+
+    static bool sink_matches(const ChargerEntry &entry, const PowerProfile &sink)
+    {
+        bool same = entry.pdo_number == sink.pdo_number;
+        for (size_t i = 0; same && i < entry.sink_pdos.size(); ++i)
+            same = entry.sink_pdos[i] == sink.encode(i);
+        return same;
+    }
+
+    static bool same_table(const PowerProfile &a, const PowerProfile &b)
+    {
+        bool same = a.pdo_number == b.pdo_number;
+        for (size_t i = 0; same && i < a.pdos.size(); ++i)
+            same = a.encode(i) == b.encode(i);
+        return same;
+    }
+
+    esp_err_t STUSB4500Manager::apply_known_charger(const ChargerEntry &entry, bool force)
+    {
+        PowerProfile &sink = cfg_.datas().power_;
+        if (sink_matches(entry, sink))
+        {
+            // Table déjà en place, mais écrite trop tard pour la négociation en cours
+            if (!force)
+                return ESP_OK;
+            ESP_LOGI(TAG, "Chargeur connu 0x%08" PRIX32 ", table anticipée trop tard", entry.fingerprint);
+            return renegotiate();
+        }
+
+        PDOTable table(i2c_, sink);
+        entry.to_profile(table.power());
+        RETURN_IF_ERROR(table.write());
+        sink = table.power();
+
+        ESP_LOGI(TAG, "Chargeur connu 0x%08" PRIX32 ", table PDO restaurée", entry.fingerprint);
+        return renegotiate();
+    }
+
+    esp_err_t STUSB4500Manager::apply_attach_fast_path()
+    {
+#if CONFIG_STUSB4500_ATTACH_FAST_PATH
+        // Pari sur le dernier chargeur utilisé, avant que la source n'envoie ses capacités
+        const ChargerEntry *last = chargers_.most_recent();
+        if (last == nullptr || fallback_active_)
+            return ESP_OK;
+
+        fast_path_fingerprint_ = last->fingerprint;
+        PowerProfile &sink = cfg_.datas().power_;
+        if (sink_matches(*last, sink))
+            return ESP_OK;
+
+        PDOTable table(i2c_, sink);
+        last->to_profile(table.power());
+        RETURN_IF_ERROR(table.write());
+        sink = table.power();
+
+        // Capacités déjà évaluées (alerte traitée en retard) : la table ne vaudra qu'à la prochaine négociation
+        RETURN_IF_ERROR(status_.read_policy_engine_state());
+        fast_path_late_ = status_.policy_engine_state.get_raw() == PETracker::PE_SNK_READY;
+        ESP_LOGI(TAG, "Attachement : table PDO du chargeur 0x%08" PRIX32 " anticipée%s", last->fingerprint,
+                 fast_path_late_ ? " (tardive)" : "");
+#endif
+        return ESP_OK;
+    }
+
+    esp_err_t STUSB4500Manager::renegotiate()
+    {
+        renegotiating_ = true;
+        return ctrl_.send_soft_reset();
+    }
+
+    void STUSB4500Manager::remember_charger(uint32_t rdo)
+    {
+        // La table de repli ne doit pas devenir la table retenue pour ce chargeur
+        if (charger_fingerprint_ == 0 || fallback_active_)
+            return;
+
+        // Contrat obtenu avec une table qui n'est pas celle de ce chargeur : table anticipée pour un autre,
+        // ou table précédant l'ajustement qui vient d'être renégocié
+        if (renegotiating_ || (fast_path_fingerprint_ != 0 && fast_path_fingerprint_ != charger_fingerprint_))
+            return;
+
+        // Sauvegarde NVS différée à la boucle de la tâche (flush_chargers())
+        chargers_.remember(charger_fingerprint_, cfg_.datas().power_, rdo);
+    }
+
+    void STUSB4500Manager::forget_charger()
+    {
+        // PDO modifié directement, table configurée inchangée : seule l'entrée du chargeur courant est
+        // obsolète ; le contrat obtenu avec la nouvelle table la réenregistre
+        if (charger_fingerprint_ != 0 && chargers_.forget(charger_fingerprint_))
+            ESP_LOGI(TAG, "Chargeur 0x%08" PRIX32 " : table retenue invalidée", charger_fingerprint_);
+    }
+
+    void STUSB4500Manager::update_charger_context()
+    {
+        // Tables retenues choisies à partir de la table configurée et du profil de charge : elles ne survivent
+        // pas à leur changement
+        if (chargers_.set_context(ChargerCache::context_of(configured_sink_, policy_enabled_ ? &load_ : nullptr)))
+            ESP_LOGI(TAG, "Configuration ou profil de charge modifié : chargeurs connus oubliés");
+    }
+
+    void STUSB4500Manager::flush_chargers()
+    {
+        if (store_ == nullptr || !chargers_.dirty())
+            return;
+        if (chargers_.save(*store_) != ESP_OK)
+            ESP_LOGW(TAG, "Échec de la sauvegarde du cache chargeurs");
+    }
+
+    esp_err_t STUSB4500Manager::write_pdo_table(const PowerProfile &power, bool verify)
+    {
+        DeviceLock lock(device_lock_);
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        PDOTable table(i2c_, power);
+        RETURN_IF_ERROR(table.write(verify));
+        cfg_.datas().power_ = power;
+        // Table imposée par l'application : restaurée au détachement comme un profil
+        configured_sink_ = power;
+        update_charger_context();
+        return renegotiate();
+    }
+
     /// Lit et retourne l’état courant de la connexion USB-C
     esp_err_t STUSB4500Manager::get_status(OutputFormat format)
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
         RETURN_IF_ERROR(status_.get_status());
+        shadow_.status_timestamp_us = esp_timer_get_time();
+        track_policy_engine();
+        publish_snapshot();
         HANDLE_OUTPUT(format, status_);
         return ESP_OK;
     }
 
     esp_err_t STUSB4500Manager::get_connection_status(OutputFormat format)
     {
+        DeviceLock lock(device_lock_);
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
         RETURN_IF_ERROR(status_.read_port_status_1());
         HANDLE_OUTPUT(format, status_.port_status_1);
@@ -215,29 +749,205 @@ namespace stusb4500
     }
 
     esp_err_t STUSB4500Manager::get_active_pdo(OutputFormat format)
+    {
+        DeviceLock lock(device_lock_);
+        return refresh_contract(format, false);
+    }
+
+    esp_err_t STUSB4500Manager::refresh_contract(OutputFormat format, bool message_received)
     {
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        renegotiating_ = false;
         RXDatas rxdatas(i2c_);
         RETURN_IF_ERROR(rxdatas.read());
         RETURN_IF_ERROR(status_.read_policy_engine_state());
-        HANDLE_OUTPUT(format, status_.policy_engine_state);
-        if (status_.policy_engine_state.get_raw() == 0x18)
+        track_policy_engine();
+        if (message_received)
+            trace_.record(rxdatas, status_.policy_engine_state.get_raw(), esp_timer_get_time());
+
+        if (rxdatas.source_capabilities(source_caps_))
         {
-            RDO rdo(i2c_);
-            RETURN_IF_ERROR(rdo.read());
-            uint8_t index = rdo.obj_position();
-            if (index >= 1 && index <= cfg_.datas().power_.pdo_number)
+            HANDLE_OUTPUT(format, source_caps_);
+            charger_fingerprint_ = ChargerCache::fingerprint(source_caps_);
+            // Repli 5 V : il tient jusqu'au détachement, ni table connue ni politique ne le remplacent
+            if (!table_adjusted_ && !fallback_active_)
             {
-                HANDLE_OUTPUT(format, cfg_.datas().power_.pdos[index - 1]);
-            }
-            else
-            {
-                ESP_LOGW(TAG, "Index PDO invalide : %u", index);
+                // Une seule tentative par attachement, même en cas d'échec
+                table_adjusted_ = true;
+                if (fast_path_fingerprint_ != 0)
+                    Metrics::instance().on_fast_path(fast_path_fingerprint_ == charger_fingerprint_);
+                const ChargerEntry *known = chargers_.find(charger_fingerprint_);
+                if (known != nullptr)
+                    RETURN_IF_ERROR(apply_known_charger(*known, fast_path_late_));
+                else if (policy_enabled_)
+                    RETURN_IF_ERROR(apply_policy(format));
+                else if (fast_path_fingerprint_ != 0 && fast_path_fingerprint_ != charger_fingerprint_ && !fallback_active_)
+                {
+                    // Pari perdu : la table de l'autre chargeur cède la place à la table configurée ; si elle a
+                    // été écrite trop tard, le contrat en cours a déjà été négocié avec la table configurée
+                    const bool anticipated = !same_table(cfg_.datas().power_, configured_sink_);
+                    RETURN_IF_ERROR(restore_configured_sink());
+                    if (anticipated && !fast_path_late_)
+                        RETURN_IF_ERROR(renegotiate());
+                }
+                // Table désormais choisie pour ce chargeur, quelle que soit l'anticipation
+                fast_path_fingerprint_ = 0;
+                fast_path_late_ = false;
             }
         }
+        HANDLE_OUTPUT(format, status_.policy_engine_state);
+        // Renégociation ou soft reset en cours : le dernier contrat reste en vigueur jusqu'au suivant
+        if (status_.policy_engine_state.get_raw() != PETracker::PE_SNK_READY)
+        {
+            publish_snapshot();
+            return ESP_OK;
+        }
+
+        shadow_.active_pdo = 0;
+        shadow_.active_voltage_mv = 0;
+        shadow_.active_current_ma = 0;
+        RDO rdo(i2c_);
+        RETURN_IF_ERROR(rdo.read());
+        shadow_.rdo = rdo.encode();
+        shadow_.rdo_timestamp_us = esp_timer_get_time();
+        uint8_t index = rdo.obj_position();
+        // La position d'objet du RDO désigne un PDO de la source
+        if (const SourcePDO *src = source_caps_.at_position(index))
+        {
+            shadow_.active_pdo = index;
+            shadow_.active_voltage_mv = src->max_voltage_mv;
+            shadow_.active_current_ma = rdo.operating_ma();
+            const SourcePDO &source_pdo = *src;
+            HANDLE_OUTPUT(format, source_pdo);
+            remember_charger(rdo.encode());
+        }
+        else if (index >= 1 && index <= cfg_.datas().power_.pdo_number &&
+            index <= cfg_.datas().power_.pdos.size())
+        {
+            shadow_.active_pdo = index;
+            shadow_.active_voltage_mv = cfg_.datas().power_.pdos[index - 1].voltage_mv;
+            shadow_.active_current_ma = rdo.operating_ma();
+            HANDLE_OUTPUT(format, cfg_.datas().power_.pdos[index - 1]);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "Index PDO invalide : %u", index);
+        }
+        if (shadow_.active_pdo != 0)
+            watchdog_.on_contract();
+        // Premier contrat qui ne sera pas renégocié : durée perçue entre le branchement et la puissance définitive
+        if (shadow_.active_pdo != 0 && attach_us_ != 0 && !renegotiating_)
+        {
+            Metrics::instance().on_attach_contract(esp_timer_get_time() - attach_us_);
+            attach_us_ = 0;
+        }
+        const PowerStats &contract = power_.stats();
+        if (contract.contract_voltage_mv != shadow_.active_voltage_mv || contract.contract_current_ma != shadow_.active_current_ma)
+        {
+            Metrics::instance().on_contract(static_cast<uint32_t>(shadow_.active_voltage_mv) * shadow_.active_current_ma / 1000);
+            journal(JournalEvent::Contract, shadow_.active_pdo,
+                    static_cast<uint32_t>(shadow_.active_voltage_mv) << 16 | (shadow_.active_current_ma / 10));
+        }
+        power_.on_contract(shadow_.active_voltage_mv, shadow_.active_current_ma, esp_timer_get_time());
+        publish_snapshot();
+        return ESP_OK;
+    }
+
+    esp_err_t STUSB4500Manager::run_watchdog()
+    {
+        const NegotiationWatchdog::Action action = watchdog_.poll(esp_timer_get_time());
+        esp_err_t err = ESP_OK;
+        JournalEvent event = JournalEvent::SoftReset;
+        switch (action)
+        {
+        case NegotiationWatchdog::Action::SoftReset:
+            err = ctrl_.send_soft_reset();
+            break;
+        case NegotiationWatchdog::Action::HardReset:
+            event = JournalEvent::HardReset;
+            err = ctrl_.send_hard_reset();
+            break;
+        case NegotiationWatchdog::Action::FallbackPdo:
+            event = JournalEvent::Fallback;
+            err = enter_fallback();
+            break;
+        case NegotiationWatchdog::Action::None:
+        default:
+            return ESP_OK;
+        }
+
+        if (err != ESP_OK)
+        {
+            // Marche non franchie : rejouée sous peu au lieu d'attendre l'échéance doublée
+            ESP_LOGW(TAG, "Watchdog : %s non exécuté (err=0x%x), nouvel essai",
+                     NegotiationWatchdog::to_string(action), err);
+            watchdog_.on_action_failed(action, esp_timer_get_time());
+            return err;
+        }
+        journal(event);
         return ESP_OK;
     }
 
+    esp_err_t STUSB4500Manager::enter_fallback()
+    {
+        PowerProfile &sink = cfg_.datas().power_;
+        // PDO1 seul : tout chargeur PD sait fournir 5 V
+        PDOTable table(i2c_, sink);
+        table.power().pdo_number = 1;
+        RETURN_IF_ERROR(table.write());
+        sink = table.power();
+        fallback_active_ = true;
+        return ctrl_.send_soft_reset();
+    }
+
+    esp_err_t STUSB4500Manager::restore_configured_sink()
+    {
+        PowerProfile &sink = cfg_.datas().power_;
+        if (!same_table(sink, configured_sink_))
+        {
+            PDOTable table(i2c_, configured_sink_);
+            RETURN_IF_ERROR(table.write());
+            sink = configured_sink_;
+        }
+        fallback_active_ = false;
+        return ESP_OK;
+    }
+
+    void STUSB4500Manager::track_policy_engine()
+    {
+        const int64_t now = esp_timer_get_time();
+        pe_.observe(status_.policy_engine_state.get_raw(), now);
+        pe_.check_stuck(now);
+    }
+
+    bool STUSB4500Manager::read_power_stats(PowerStats &out) const
+    {
+        StatusSnapshot snapshot;
+        if (!snapshot_.read(snapshot))
+            return false;
+        out = snapshot.power.at(esp_timer_get_time());
+        return true;
+    }
+
+    void STUSB4500Manager::publish_snapshot()
+    {
+        shadow_.timestamp_us = esp_timer_get_time();
+        shadow_.alert_status_1 = status_.alert_status_1.get_raw();
+        shadow_.port_status_0 = status_.port_status_0.get_raw();
+        shadow_.port_status_1 = status_.port_status_1.get_raw();
+        shadow_.typec_monitoring_status_0 = status_.typec_monitoring_status_0.get_raw();
+        shadow_.typec_monitoring_status_1 = status_.typec_monitoring_status_1.get_raw();
+        shadow_.cc_status = status_.cc_status.get_raw();
+        shadow_.cc_hw_fault_0 = status_.cc_hw_fault_0.get_raw();
+        shadow_.cc_hw_fault_1 = status_.cc_hw_fault_1.get_raw();
+        shadow_.pd_typec_status = status_.pd_typec_status.get_raw();
+        shadow_.typec_status = status_.typec_status.get_raw();
+        shadow_.prt_status = status_.prt_status.get_raw();
+        shadow_.policy_engine_state = status_.policy_engine_state.get_raw();
+        shadow_.power = power_.stats();
+        snapshot_.publish(shadow_);
+    }
+
     void STUSB4500Manager::task_wrapper(void *arg)
     {
         static_cast<STUSB4500Manager *>(arg)->task_main();
@@ -277,24 +987,82 @@ namespace stusb4500
         gpio_isr_handler_add(gpio, gpio_isr_handler, this);
     }
 
+    TickType_t STUSB4500Manager::wait_timeout()
+    {
+        DeviceLock lock(device_lock_);
+        // Réveil sur alerte, ou à l'échéance du watchdog s'il est armé
+        const int64_t wait_us = watchdog_.time_to_deadline(esp_timer_get_time());
+        TickType_t timeout = wait_us < 0 ? portMAX_DELAY : pdMS_TO_TICKS(wait_us / 1000) + 1;
+        // État d'attente du PE sans alerte : réveil au seuil de blocage pour le signaler
+        const int64_t stuck_us = pe_.time_to_stuck(esp_timer_get_time());
+        if (stuck_us >= 0)
+            timeout = std::min<TickType_t>(timeout, pdMS_TO_TICKS(stuck_us / 1000) + 1);
+        // Des événements attendent d'être écrits : on repasse au plus tard dans une seconde
+        if ((journal_ != nullptr && journal_->pending() > 0) || (store_ != nullptr && chargers_.dirty()))
+            timeout = std::min<TickType_t>(timeout, pdMS_TO_TICKS(1000));
+
+        // État à resynchroniser après une erreur bus, ou masque d'alerte resté à écrire : nouvel essai rapide
+        if (bus_fault_since_us_ != 0 || mask_pending_)
+            timeout = std::min<TickType_t>(timeout, std::max<TickType_t>(pdMS_TO_TICKS(RESYNC_RETRY_MS), 1));
+
+#if CONFIG_STUSB4500_ALERT_POLLING
+        // Pas de broche ALERT : cadence rapide tant qu'une négociation est surveillée
+        if (watchdog_.armed())
+            poller_.keep_fast(esp_timer_get_time());
+        timeout = std::min<TickType_t>(timeout, std::max<TickType_t>(pdMS_TO_TICKS(poller_.interval_ms()), 1));
+#endif
+        return timeout;
+    }
+
     void STUSB4500Manager::task_main()
     {
+#if !CONFIG_STUSB4500_ALERT_POLLING
         setup_interrupt(alert_gpio_);
-        init_device();
-        get_connection_status(OutputFormat::Log);
-        get_active_pdo(OutputFormat::Log);
-        
+#endif
+        {
+            DeviceLock lock(device_lock_);
+            init_device();
+            get_connection_status(OutputFormat::Log);
+            if (status_.port_status_1.get_values().attached)
+                watchdog_.on_attach(esp_timer_get_time());
+            get_active_pdo(OutputFormat::Log);
+        }
+
         while (true)
         {
-            if (gpio_get_level(alert_gpio_) == 0 || ulTaskNotifyTake(pdTRUE, portMAX_DELAY))
+            TickType_t timeout = wait_timeout();
+#if CONFIG_STUSB4500_ALERT_POLLING
+            ulTaskNotifyTake(pdTRUE, timeout);
+#else
+            const bool notified = gpio_get_level(alert_gpio_) == 0 || ulTaskNotifyTake(pdTRUE, timeout);
+#endif
+            // Traitement du réveil sous le verrou : les appels publics des autres tâches attendent sa fin
+            DeviceLock lock(device_lock_);
+            const int64_t start = esp_timer_get_time();
+            esp_err_t err = apply_pending_mask();
+#if CONFIG_STUSB4500_ALERT_POLLING
+            if (err == ESP_OK)
+                err = poll_alert();
+#else
+            // Abonnements modifiés par l'application : masque écrit avant de regarder la broche
+            if (err == ESP_OK && notified && gpio_get_level(alert_gpio_) == 0)
             {
-                if (gpio_get_level(alert_gpio_) == 0)
-                {
-                    ESP_LOGE(TAG, "Alert");
-                    handle_alert();
-                }
-                
+                ESP_LOGE(TAG, "Alert");
+                err = handle_alert();
             }
+#endif
+            if (ready_ && (err != ESP_OK || bus_fault_since_us_ != 0))
+                recover_status(start);
+
+            // Action de reprise en échec (bus) : le watchdog la rejoue, l'état est relu comme après une alerte ratée
+            if (run_watchdog() != ESP_OK && ready_ && bus_fault_since_us_ == 0)
+                bus_fault_since_us_ = esp_timer_get_time();
+            pe_.check_stuck(esp_timer_get_time());
+
+            // Écritures flash regroupées, hors du traitement de l'alerte
+            if (journal_ != nullptr && journal_->flush_due())
+                journal_->flush();
+            flush_chargers();
         }
     }
 };
\ No newline at end of file
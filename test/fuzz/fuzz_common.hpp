@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "host_platform.hpp"
+
+// Les harnais exercent aussi les formateurs (log) : traces activées, sortie standard écartée
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+    std::freopen("/dev/null", "w", stdout);
+    host::enable_log(true);
+    return 0;
+}
+
+/// Lecture séquentielle d'une entrée de fuzzing ; zéros une fois l'entrée épuisée
+class FuzzInput
+{
+public:
+    FuzzInput(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    uint8_t u8() { return pos_ < size_ ? data_[pos_++] : 0; }
+    uint16_t u16() { return static_cast<uint16_t>(u8() | u8() << 8); }
+    uint32_t u32() { return u16() | static_cast<uint32_t>(u16()) << 16; }
+
+    const uint8_t *rest() const { return data_ + pos_; }
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
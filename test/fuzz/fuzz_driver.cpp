@@ -0,0 +1,188 @@
+// Pilote autonome des harnais de fuzzing quand libFuzzer n'est pas disponible (GCC) :
+// rejoue le corpus puis des mutations pseudo-aléatoires reproductibles.
+//   fuzz_rx_datas [-runs=N] [-seed=S] [-max_len=L] [-min_exec_s=R] corpus_dir|file...
+// -min_exec_s : échec (code 2) si la cadence tombe sous R exécutions par seconde (régression de performance)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv);
+
+namespace
+{
+    uint32_t rng_state = 1;
+    const std::vector<uint8_t> *current_input = nullptr;
+
+    // Entrée fautive écrite dans ./crash-input, comme le ferait libFuzzer, pour la rejouer seule
+    void on_crash(int sig)
+    {
+        if (current_input != nullptr)
+        {
+            const int fd = open("crash-input", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd >= 0)
+            {
+                [[maybe_unused]] ssize_t n = write(fd, current_input->data(), current_input->size());
+                close(fd);
+            }
+            static const char msg[] = "crash: input saved to ./crash-input\n";
+            [[maybe_unused]] ssize_t n = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+        }
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+
+    uint32_t next_random()
+    {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 17;
+        rng_state ^= rng_state << 5;
+        return rng_state;
+    }
+
+    bool read_file(const std::string &path, std::vector<uint8_t> &out)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return false;
+        out.clear();
+        uint8_t chunk[512];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            out.insert(out.end(), chunk, chunk + n);
+        std::fclose(file);
+        return true;
+    }
+
+    void load_corpus(const std::string &path, std::vector<std::vector<uint8_t>> &corpus)
+    {
+        if (DIR *dir = opendir(path.c_str()))
+        {
+            while (dirent *entry = readdir(dir))
+            {
+                if (entry->d_name[0] != '.')
+                    load_corpus(path + "/" + entry->d_name, corpus);
+            }
+            closedir(dir);
+            return;
+        }
+        std::vector<uint8_t> input;
+        if (read_file(path, input))
+            corpus.push_back(input);
+    }
+
+    // Mutations à la libFuzzer : octet aléatoire, bit inversé, insertion, suppression, valeurs limites, croisement
+    void mutate(std::vector<uint8_t> &input, const std::vector<std::vector<uint8_t>> &corpus, size_t max_len)
+    {
+        static const uint8_t interesting[] = {0x00, 0x01, 0x07, 0x0F, 0x10, 0x1F, 0x7F, 0x80, 0xF0, 0xFF};
+        const int steps = 1 + next_random() % 4;
+        for (int s = 0; s < steps; ++s)
+        {
+            const size_t pos = input.empty() ? 0 : next_random() % input.size();
+            switch (next_random() % 6)
+            {
+            case 0:
+                if (!input.empty())
+                    input[pos] = static_cast<uint8_t>(next_random());
+                break;
+            case 1:
+                if (!input.empty())
+                    input[pos] ^= static_cast<uint8_t>(1u << (next_random() % 8));
+                break;
+            case 2:
+                if (input.size() < max_len)
+                    input.insert(input.begin() + pos, static_cast<uint8_t>(next_random()));
+                break;
+            case 3:
+                if (!input.empty())
+                    input.erase(input.begin() + pos);
+                break;
+            case 4:
+                if (!input.empty())
+                    input[pos] = interesting[next_random() % sizeof(interesting)];
+                break;
+            default:
+                if (!corpus.empty())
+                {
+                    const std::vector<uint8_t> &other = corpus[next_random() % corpus.size()];
+                    if (!other.empty())
+                    {
+                        const size_t from = next_random() % other.size();
+                        const size_t len = std::min(other.size() - from, max_len - std::min(max_len, pos));
+                        input.resize(std::max(input.size(), pos + len));
+                        std::memcpy(input.data() + pos, other.data() + from, len);
+                    }
+                }
+                break;
+            }
+        }
+        if (input.size() > max_len)
+            input.resize(max_len);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    long runs = 10000;
+    size_t max_len = 256;
+    double min_exec_s = 0;
+    std::vector<std::vector<uint8_t>> corpus;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "-runs=", 6) == 0)
+            runs = std::strtol(argv[i] + 6, nullptr, 10);
+        else if (std::strncmp(argv[i], "-seed=", 6) == 0)
+            rng_state = static_cast<uint32_t>(std::strtoul(argv[i] + 6, nullptr, 10)) | 1;
+        else if (std::strncmp(argv[i], "-max_len=", 9) == 0)
+            max_len = std::strtoul(argv[i] + 9, nullptr, 10);
+        else if (std::strncmp(argv[i], "-min_exec_s=", 12) == 0)
+            min_exec_s = std::strtod(argv[i] + 12, nullptr);
+        else
+            load_corpus(argv[i], corpus);
+    }
+
+    for (int sig : {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV})
+        signal(sig, on_crash);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &input : corpus)
+    {
+        current_input = &input;
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    std::vector<uint8_t> input;
+    current_input = &input;
+    for (long run = 0; run < runs; ++run)
+    {
+        if (corpus.empty() || next_random() % 8 == 0)
+            input.assign(next_random() % (max_len + 1), 0);
+        else
+            input = corpus[next_random() % corpus.size()];
+        mutate(input, corpus, max_len);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double exec_s = (corpus.size() + runs) / (seconds > 0 ? seconds : 1e-9);
+    std::fprintf(stderr, "%zu corpus inputs + %ld mutations in %.2f s (%.0f exec/s)\n", corpus.size(), runs, seconds,
+                 exec_s);
+    if (exec_s < min_exec_s)
+    {
+        std::fprintf(stderr, "exec/s below the %.0f floor\n", min_exec_s);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+// PowerProfile, RDO et image NVM : décodage de registres lus sur un bus éventuellement corrompu
+#include "fuzz_common.hpp"
+
+#include "config/stusb4500-config_types.hpp"
+#include "nvm/stusb4500-nvm_data.hpp"
+#include "pd/stusb4500-rdo.hpp"
+#include "stusb4500-common_types.hpp"
+
+using namespace stusb4500;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    FuzzInput in(data, size);
+
+    // Index hors table compris : decode() l'ignore, encode() rend 0
+    PowerProfile power;
+    for (int i = 0; i < 4; ++i)
+    {
+        const size_t index = in.u8() % 5;
+        const uint32_t raw = in.u32();
+        power.decode(raw, index);
+        (void)power.encode(index);
+    }
+    power.pdo_number = in.u8();
+    power.log();
+
+    I2CDevices dev;
+    RDO rdo(dev);
+    uint8_t rdo_bytes[4] = {in.u8(), in.u8(), in.u8(), in.u8()};
+    rdo.decode(rdo_bytes, in.u8() % 6);
+    (void)rdo.obj_position();
+    (void)rdo.operating_ma();
+    rdo.log();
+
+    uint8_t image[40] = {0};
+    for (uint8_t &b : image)
+        b = in.u8();
+    ConfigParams cfg;
+    NVMData nvm(cfg);
+    nvm.decode(image);
+    nvm.log();
+    cfg.log();
+    (void)nvm.to_array();
+    return 0;
+}
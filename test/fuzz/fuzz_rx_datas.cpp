@@ -0,0 +1,36 @@
+// RXDatas::decode() : contenu brut de la fenêtre RX (0x31-0x4E) tel que reçu d'un chargeur
+#include "fuzz_common.hpp"
+
+#include "pd/stusb4500-charger_cache.hpp"
+#include "pd/stusb4500-rx_datas.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+
+using namespace stusb4500;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    I2CDevices dev;
+    RXDatas rx(dev);
+    rx.decode(size == 0 ? nullptr : data, size);
+
+    (void)rx.header();
+    (void)rx.message_type();
+    (void)rx.is_data_message();
+    (void)rx.is_control_message();
+    const uint8_t objects = rx.num_objects();
+    for (size_t i = 0; i <= objects + 1u; ++i)
+        (void)rx.data_object(i);
+    for (size_t i = 0; i < 8; ++i)
+        (void)rx.get_pdo(i).encode(0);
+
+    SourceCapabilities caps;
+    if (rx.source_capabilities(caps))
+    {
+        if (caps.size() > SourceCapabilities::MAX_OBJECTS || caps.size() > objects)
+            __builtin_trap();
+        (void)ChargerCache::fingerprint(caps);
+        caps.log();
+    }
+    rx.log();
+    return 0;
+}
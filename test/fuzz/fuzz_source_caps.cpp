@@ -0,0 +1,47 @@
+// SourceCapabilities::decode() et ContractPolicy::select() : PDO fixes, variables, batterie, PPS/AVS
+#include "fuzz_common.hpp"
+
+#include "pd/stusb4500-policy.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+
+using namespace stusb4500;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    FuzzInput in(data, size);
+
+    LoadProfile load;
+    load.min_voltage_mv = in.u16();
+    load.max_voltage_mv = in.u16();
+    load.required_power_mw = in.u32();
+    load.max_current_ma = in.u16();
+    load.preference = static_cast<LoadProfile::Preference>(in.u8() % 3);
+    PDObjectProfile pdo1;
+    pdo1.current_ma = in.u16() % 5001;
+
+    // Plus d'objets que MAX_OBJECTS possible : decode() doit tronquer
+    uint32_t objects[10] = {0};
+    const size_t count = in.u8() % 11;
+    for (size_t i = 0; i < count; ++i)
+        objects[i] = in.u32();
+
+    SourceCapabilities caps;
+    caps.decode(objects, count);
+    if (caps.size() > SourceCapabilities::MAX_OBJECTS)
+        __builtin_trap();
+    for (const SourcePDO &pdo : caps)
+        (void)SourcePDO::to_string(pdo.type);
+    for (uint8_t position = 0; position <= 8; ++position)
+        (void)caps.at_position(position);
+    (void)caps.max_power_mw();
+    caps.log();
+
+    const SinkPlan plan = ContractPolicy::select(caps, load, pdo1);
+    if (plan.pdo_number < 1 || plan.pdo_number > 3 || plan.source_position > caps.size())
+        __builtin_trap();
+    // Le STUSB4500 ne sait demander qu'un PDO fixe
+    if (plan.source_position != 0 && caps.at_position(plan.source_position)->type != SourcePDOType::Fixed)
+        __builtin_trap();
+    plan.log();
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Registres de statut (0x0B-0x16, 0x29) : set_raw() puis get_values() et formateurs, octets lus sur un bus corrompu
+#include "fuzz_common.hpp"
+
+#include "status/stusb4500-status.hpp"
+
+using namespace stusb4500;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    FuzzInput in(data, size);
+
+    I2CDevices dev;
+    STATUS status(dev);
+    status.policy_engine_state.set_raw(in.u8());
+    status.alert_status_1.set_raw(in.u8());
+    status.port_status_0.set_raw(in.u8());
+    status.port_status_1.set_raw(in.u8());
+    status.typec_monitoring_status_0.set_raw(in.u8());
+    status.typec_monitoring_status_1.set_raw(in.u8());
+    status.cc_status.set_raw(in.u8());
+    status.cc_hw_fault_0.set_raw(in.u8());
+    status.cc_hw_fault_1.set_raw(in.u8());
+    status.pd_typec_status.set_raw(in.u8());
+    status.typec_status.set_raw(in.u8());
+    status.prt_status.set_raw(in.u8());
+
+    // Champs multi-bits : la valeur décodée tient dans la largeur du champ
+    const auto port = status.port_status_1.get_values();
+    const auto cc = status.cc_status.get_values();
+    const auto typec = status.typec_status.get_values();
+    if (port.raw_attached_device > 0x07 || cc.raw_cc1_state > 0x03 || cc.raw_cc2_state > 0x03 ||
+        typec.raw_typec_fsm_state > 0x1F || status.pd_typec_status.get_value() > 0x0F)
+        __builtin_trap();
+    // Bit isolé : relu à sa position, sans déborder sur ses voisins
+    const uint8_t alert = status.alert_status_1.get_raw();
+    const auto alerts = status.alert_status_1.get_values();
+    if (alerts.port_status_al != ((alert >> 6) & 1) || alerts.prt_status_al != ((alert >> 1) & 1) ||
+        port.attached != (status.port_status_1.get_raw() & 1))
+        __builtin_trap();
+
+    (void)status.port_status_0.get_values();
+    (void)status.typec_monitoring_status_0.get_values();
+    (void)status.typec_monitoring_status_1.get_values();
+    (void)status.cc_hw_fault_0.get_values();
+    (void)status.cc_hw_fault_1.get_values();
+    (void)status.prt_status.get_values();
+    (void)StateStatusRegister::to_string(status.policy_engine_state.get_value());
+    (void)PortStatus1Register::to_string(port.raw_attached_device);
+    (void)CCStatusRegister::to_string(cc.raw_cc1_state);
+    (void)PDTypeCStatusRegister::to_string(status.pd_typec_status.get_value());
+    (void)TypeCStatusRegister::to_string(typec.raw_typec_fsm_state);
+
+    status.alert_status_1.log();
+    status.log();
+    (void)status.alert_status_1.to_json();
+    (void)status.to_json();
+    return 0;
+}
@@ -0,0 +1,44 @@
+// Blobs persistants relus au démarrage : cache des chargeurs et profils de puissance
+#include "fuzz_common.hpp"
+
+#include "memory_store.hpp"
+#include "pd/stusb4500-charger_cache.hpp"
+#include "storage/stusb4500-profile_store.hpp"
+
+using namespace stusb4500;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    FuzzInput in(data, size);
+    const size_t split = in.u8();
+    const uint8_t *blob = in.rest();
+    const size_t blob_len = in.remaining();
+    const size_t first = split < blob_len ? split : blob_len;
+
+    host::MemoryStore store;
+    store.set("chg_cache", blob, blob_len);
+    store.set("pf_fuzz", blob, first);
+    store.set("pf_active", blob + first, blob_len - first);
+
+    ChargerCache cache;
+    if (cache.load(store) == ESP_OK)
+    {
+        if (cache.size() > ChargerCache::CAPACITY)
+            __builtin_trap();
+        if (const ChargerEntry *entry = cache.most_recent())
+        {
+            PowerProfile power;
+            entry->to_profile(power);
+        }
+        cache.log();
+        cache.save(store);
+    }
+
+    ProfileStore profiles(store);
+    PowerProfile power;
+    (void)profiles.load("fuzz", power);
+    char name[ProfileStore::NAME_LEN + 1];
+    if (profiles.active(name) == ESP_OK && std::char_traits<char>::length(name) > ProfileStore::NAME_LEN)
+        __builtin_trap();
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+// Interface du composant I2CDevices ; sur hôte, les transactions vont au FakeBus courant
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+class I2CDevices
+{
+public:
+    esp_err_t read(uint8_t reg, uint8_t *data, size_t len);
+    esp_err_t write(uint8_t reg, const uint8_t *data, size_t len);
+};
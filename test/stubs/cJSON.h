@@ -0,0 +1,172 @@
+#pragma once
+// Sous-ensemble de cJSON pour la cible hôte (CONFIG_STUSB4500_JSON_OUTPUT) : construction d'objets et de
+// tableaux, sérialisation compacte comme cJSON_PrintUnformatted (entiers sans décimales, chaînes échappées)
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+typedef int cJSON_bool;
+
+struct cJSON
+{
+    enum Kind
+    {
+        Object,
+        Array,
+        String,
+        Number,
+        Bool
+    };
+
+    Kind kind;
+    std::string name;
+    std::string text;
+    double number = 0;
+    bool boolean = false;
+    cJSON *child = nullptr;
+    cJSON *next = nullptr;
+};
+
+inline cJSON *host_cjson_new(cJSON::Kind kind)
+{
+    cJSON *item = new cJSON;
+    item->kind = kind;
+    return item;
+}
+
+inline void host_cjson_append(cJSON *parent, cJSON *item)
+{
+    cJSON **slot = &parent->child;
+    while (*slot != nullptr)
+        slot = &(*slot)->next;
+    *slot = item;
+}
+
+inline cJSON *cJSON_CreateObject() { return host_cjson_new(cJSON::Object); }
+inline cJSON *cJSON_CreateArray() { return host_cjson_new(cJSON::Array); }
+
+inline cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    if (array == nullptr || item == nullptr)
+        return 0;
+    host_cjson_append(array, item);
+    return 1;
+}
+
+inline cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *name, cJSON *item)
+{
+    if (object == nullptr || item == nullptr || name == nullptr)
+        return 0;
+    item->name = name;
+    host_cjson_append(object, item);
+    return 1;
+}
+
+inline cJSON *cJSON_AddStringToObject(cJSON *object, const char *name, const char *value)
+{
+    cJSON *item = host_cjson_new(cJSON::String);
+    item->text = value != nullptr ? value : "";
+    cJSON_AddItemToObject(object, name, item);
+    return item;
+}
+
+inline cJSON *cJSON_AddNumberToObject(cJSON *object, const char *name, double value)
+{
+    cJSON *item = host_cjson_new(cJSON::Number);
+    item->number = value;
+    cJSON_AddItemToObject(object, name, item);
+    return item;
+}
+
+inline cJSON *cJSON_AddBoolToObject(cJSON *object, const char *name, cJSON_bool value)
+{
+    cJSON *item = host_cjson_new(cJSON::Bool);
+    item->boolean = value != 0;
+    cJSON_AddItemToObject(object, name, item);
+    return item;
+}
+
+inline void cJSON_Delete(cJSON *item)
+{
+    while (item != nullptr)
+    {
+        cJSON *next = item->next;
+        cJSON_Delete(item->child);
+        delete item;
+        item = next;
+    }
+}
+
+inline void host_cjson_quote(std::string &out, const std::string &text)
+{
+    out += '"';
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        }
+        else
+            out += c;
+    }
+    out += '"';
+}
+
+inline void host_cjson_print(std::string &out, const cJSON *item)
+{
+    switch (item->kind)
+    {
+    case cJSON::Object:
+    case cJSON::Array:
+        out += item->kind == cJSON::Object ? '{' : '[';
+        for (const cJSON *child = item->child; child != nullptr; child = child->next)
+        {
+            if (child != item->child)
+                out += ',';
+            if (item->kind == cJSON::Object)
+            {
+                host_cjson_quote(out, child->name);
+                out += ':';
+            }
+            host_cjson_print(out, child);
+        }
+        out += item->kind == cJSON::Object ? '}' : ']';
+        break;
+    case cJSON::String:
+        host_cjson_quote(out, item->text);
+        break;
+    case cJSON::Number:
+    {
+        char number[32];
+        if (std::floor(item->number) == item->number && std::fabs(item->number) < 1e15)
+            std::snprintf(number, sizeof(number), "%.0f", item->number);
+        else
+            std::snprintf(number, sizeof(number), "%1.15g", item->number);
+        out += number;
+        break;
+    }
+    case cJSON::Bool:
+        out += item->boolean ? "true" : "false";
+        break;
+    }
+}
+
+/// Chaîne allouée par malloc : libérée par free() comme avec cJSON
+inline char *cJSON_PrintUnformatted(const cJSON *item)
+{
+    std::string out;
+    host_cjson_print(out, item);
+    char *result = static_cast<char *>(std::malloc(out.size() + 1));
+    std::memcpy(result, out.c_str(), out.size() + 1);
+    return result;
+}
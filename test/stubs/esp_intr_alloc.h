@@ -0,0 +1,3 @@
+#pragma once
+
+#define ESP_INTR_FLAG_LEVEL3 (1 << 3)
@@ -0,0 +1,28 @@
+#pragma once
+// Journalisation hôte : silencieuse sauf si STUSB4500_HOST_LOG est défini dans l'environnement
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "esp_err.h"
+
+typedef enum { ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE } esp_log_level_t;
+
+bool host_log_enabled();
+
+#define HOST_LOG(level, tag, fmt, ...)                                       \
+    do {                                                                     \
+        if (host_log_enabled())                                              \
+            std::printf("%c (%s) " fmt "\n", level, tag, ##__VA_ARGS__);     \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) HOST_LOG('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) HOST_LOG('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) HOST_LOG('D', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) HOST_LOG('V', tag, fmt, ##__VA_ARGS__)
+
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, len, level) \
+    do { (void)(tag); (void)(buffer); (void)(len); (void)(level); } while (0)
+#define ESP_LOG_BUFFER_HEX(tag, buffer, len) ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, len, ESP_LOG_INFO)
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+/// Attente active : avance l'horloge virtuelle de la cible hôte
+void esp_rom_delay_us(uint32_t us);
@@ -0,0 +1,6 @@
+#pragma once
+// Horloge virtuelle de la cible hôte (test/support/host_platform.cpp)
+
+#include <cstdint>
+
+int64_t esp_timer_get_time(void);
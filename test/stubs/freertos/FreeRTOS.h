@@ -0,0 +1,49 @@
+#pragma once
+// Sous-ensemble FreeRTOS / portmacro pour la cible hôte
+
+#include <atomic>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "esp_rom_sys.h" // inclus par portmacro.h dans ESP-IDF
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+#define pdTICKS_TO_MS(ticks) (static_cast<uint32_t>(ticks))
+#define IRAM_ATTR
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+
+/// Spinlock réel : les tests multi-threads (snapshot, enregistreur) l'exercent vraiment
+struct portMUX_TYPE
+{
+    std::atomic<bool> locked{false};
+
+    portMUX_TYPE() = default;
+    portMUX_TYPE(const portMUX_TYPE &) {}
+    portMUX_TYPE &operator=(const portMUX_TYPE &) { return *this; }
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+inline void host_enter_critical(portMUX_TYPE *mux)
+{
+    while (mux->locked.exchange(true, std::memory_order_acquire))
+    {
+    }
+}
+
+inline void host_exit_critical(portMUX_TYPE *mux)
+{
+    mux->locked.store(false, std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux) host_enter_critical(mux)
+#define portEXIT_CRITICAL(mux) host_exit_critical(mux)
@@ -0,0 +1,31 @@
+#pragma once
+// Mutex récursif FreeRTOS pour la cible hôte, adossé à std::recursive_timed_mutex
+
+#include <chrono>
+#include <mutex>
+
+#include "freertos/FreeRTOS.h"
+
+typedef std::recursive_timed_mutex StaticSemaphore_t;
+typedef std::recursive_timed_mutex *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer)
+{
+    return buffer;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t timeout)
+{
+    if (timeout == portMAX_DELAY)
+    {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock_for(std::chrono::milliseconds(pdTICKS_TO_MS(timeout))) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    mutex->unlock();
+    return pdTRUE;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+
+/// Avance l'horloge virtuelle d'autant de millisecondes
+void vTaskDelay(TickType_t ticks);
+void vPortYield(void);
+#define taskYIELD() vPortYield()
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void *), const char *name, uint32_t stack, void *arg,
+                                   int priority, TaskHandle_t *handle, int core);
+TickType_t xTaskGetTickCount(void);
+void xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+/// Sur hôte : consomme les notifications en attente, sinon avance l'horloge de `timeout`
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Mini-cadre de test de la cible hôte : un exécutable par fichier, enregistré dans CTest
+
+namespace check
+{
+    struct Case
+    {
+        const char *name;
+        std::function<void()> fn;
+    };
+
+    inline std::vector<Case> &cases()
+    {
+        static std::vector<Case> all;
+        return all;
+    }
+
+    inline int &failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    struct Register
+    {
+        Register(const char *name, std::function<void()> fn) { cases().push_back({name, std::move(fn)}); }
+    };
+
+    /// Exécute les cas enregistrés (ou ceux dont le nom est passé en argument) ; code de sortie CTest
+    inline int run(int argc, char **argv)
+    {
+        int ran = 0;
+        for (const Case &c : cases())
+        {
+            bool selected = argc < 2;
+            for (int i = 1; i < argc && !selected; ++i)
+                selected = std::string(argv[i]) == c.name;
+            if (!selected)
+                continue;
+            const int before = failures();
+            c.fn();
+            std::printf("[%s] %s\n", failures() == before ? " OK " : "FAIL", c.name);
+            ++ran;
+        }
+        std::fflush(stdout);
+        return failures() == 0 && ran > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+} // namespace check
+
+#define CHECK_CONCAT2(a, b) a##b
+#define CHECK_CONCAT(a, b) CHECK_CONCAT2(a, b)
+
+#define TEST_CASE(name)                                                                       \
+    static void CHECK_CONCAT(test_, name)();                                                  \
+    static check::Register CHECK_CONCAT(register_, name)(#name, CHECK_CONCAT(test_, name));   \
+    static void CHECK_CONCAT(test_, name)()
+
+#define CHECK(cond)                                                                           \
+    do {                                                                                      \
+        if (!(cond)) {                                                                        \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);              \
+            ++check::failures();                                                              \
+        }                                                                                     \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                        \
+    do {                                                                                      \
+        const auto check_a_ = (a);                                                            \
+        const auto check_b_ = (b);                                                            \
+        if (!(check_a_ == check_b_)) {                                                        \
+            std::printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                        #a, #b, static_cast<long long>(check_a_), static_cast<long long>(check_b_)); \
+            ++check::failures();                                                              \
+        }                                                                                     \
+    } while (0)
+
+#define CHECK_OK(expr) CHECK_EQ(static_cast<int>(expr), 0)
+
+#define TEST_MAIN()                                                                           \
+    int main(int argc, char **argv) { return check::run(argc, argv); }
@@ -0,0 +1,280 @@
+#include "chip_sim.hpp"
+
+#include <cstring>
+
+#include "host_platform.hpp"
+
+namespace host
+{
+    namespace
+    {
+        uint32_t le32(const uint8_t *p)
+        {
+            return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+        }
+
+        void put_le32(uint8_t *p, uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+                p[i] = static_cast<uint8_t>(v >> (8 * i));
+        }
+
+        // PE_FSM (0x29)
+        constexpr uint8_t PE_INIT = 0x00;
+        constexpr uint8_t PE_SEND_SOFT_RESET = 0x03;
+        constexpr uint8_t PE_HARD_RESET = 0x02;
+        constexpr uint8_t PE_SNK_WAIT_FOR_CAPABILITIES = 0x13;
+        constexpr uint8_t PE_SNK_EVALUATE_CAPABILITY = 0x14;
+        constexpr uint8_t PE_SNK_SELECT_CAPABILITY = 0x16;
+        constexpr uint8_t PE_SNK_READY = 0x18;
+
+        // Types de message PD (en-tête RX)
+        constexpr uint8_t MSG_SOURCE_CAPABILITIES = 0x01; // message de données
+        constexpr uint8_t MSG_PS_RDY = 0x06;              // message de contrôle
+    } // namespace
+
+    ChipSim::ChipSim()
+    {
+        regs[DEVICE_ID] = 0x25;
+        regs[ALERT_MASK] = 0xFF;
+    }
+
+    uint32_t ChipSim::fixed(uint32_t mv, uint32_t ma)
+    {
+        return (mv / 50) << 10 | (ma / 10);
+    }
+
+    uint32_t ChipSim::rdo() const
+    {
+        return le32(&regs[RDO]);
+    }
+
+    uint32_t ChipSim::sink_pdo(size_t index) const
+    {
+        return le32(&regs[SINK_PDO1 + 4 * index]);
+    }
+
+    void ChipSim::raise(uint8_t alert)
+    {
+        regs[ALERT] |= alert;
+        update_pin();
+    }
+
+    void ChipSim::update_pin()
+    {
+        set_alert_level((regs[ALERT] & ~regs[ALERT_MASK] & ALERT_VALID) != 0 ? 0 : 1);
+    }
+
+    void ChipSim::attach(const std::vector<uint32_t> &source_pdos)
+    {
+        source_ = source_pdos;
+        frozen_ = false;
+        contract_mv_ = 0;
+        ++generation_;
+        regs[PORT_STATUS_1] |= 1;
+        regs[PORT_STATUS_0] |= 1;
+        regs[PE_FSM] = PE_SNK_WAIT_FOR_CAPABILITIES;
+        raise(ALERT_PORT_STATUS);
+        send_caps(now_us() + timing.first_caps_us);
+    }
+
+    void ChipSim::detach()
+    {
+        ++generation_;
+        source_.clear();
+        contract_mv_ = 0;
+        regs[PORT_STATUS_1] &= ~1;
+        regs[PORT_STATUS_0] |= 1;
+        regs[PE_FSM] = PE_INIT;
+        std::memset(&regs[RDO], 0, 4);
+        raise(ALERT_PORT_STATUS);
+    }
+
+    void ChipSim::freeze_pe(uint8_t state)
+    {
+        ++generation_;
+        frozen_ = true;
+        regs[PE_FSM] = state;
+    }
+
+    void ChipSim::receive_control(uint8_t type, uint8_t pe_state)
+    {
+        freeze_pe(pe_state);
+        regs[RX_HEADER] = type;
+        regs[RX_HEADER + 1] = 0;
+        regs[PRT_STATUS] |= 1 << 2;
+        raise(ALERT_PRT);
+    }
+
+    void ChipSim::resend_caps(const std::vector<uint32_t> &source_pdos)
+    {
+        source_ = source_pdos;
+        ++generation_;
+        send_caps(now_us());
+    }
+
+    void ChipSim::receive_hard_reset()
+    {
+        ++generation_;
+        frozen_ = false;
+        contract_mv_ = 0;
+        std::memset(&regs[RDO], 0, 4);
+        regs[PE_FSM] = PE_HARD_RESET;
+        regs[PRT_STATUS] |= 1 << 0;
+        raise(ALERT_PRT);
+        send_caps(now_us() + timing.hard_reset_caps_us);
+    }
+
+    void ChipSim::cc_fault(uint8_t fault1)
+    {
+        regs[CC_HW_FAULT_STATUS_1] = fault1;
+        raise(ALERT_CC_HW_FAULT);
+    }
+
+    void ChipSim::vbus_glitch()
+    {
+        regs[TYPEC_MONITORING_STATUS_0] |= 1 << 1;
+        raise(ALERT_TYPEC_MONITORING);
+    }
+
+    void ChipSim::send_caps(int64_t when_us)
+    {
+        const uint32_t gen = generation_;
+        at(when_us, [this, gen] {
+            if (gen != generation_ || !attached() || silent)
+                return;
+
+            // Source_Capabilities reçu : la puce négocie avec la table sink présente à cet instant
+            ++negotiations;
+            regs[RX_HEADER] = MSG_SOURCE_CAPABILITIES;
+            regs[RX_HEADER + 1] = static_cast<uint8_t>(source_.size() << 4);
+            for (size_t i = 0; i < source_.size(); ++i)
+                put_le32(&regs[RX_HEADER + 2 + 4 * i], source_[i]);
+            regs[PRT_STATUS] |= 1 << 2;
+            regs[PE_FSM] = PE_SNK_EVALUATE_CAPABILITY;
+            raise(ALERT_PRT);
+
+            // PDO sink de plus haut rang servi par la source, sinon 5 V avec capability mismatch
+            const int count = regs[PDO_NUMBER] >= 1 && regs[PDO_NUMBER] <= 3 ? regs[PDO_NUMBER] : 1;
+            uint32_t request = 0;
+            uint32_t mv = 5000;
+            for (int s = count - 1; s >= 0 && request == 0; --s)
+            {
+                const uint32_t pdo = sink_pdo(s);
+                for (size_t i = 0; i < source_.size() && request == 0; ++i)
+                {
+                    if (sink_mv(source_[i]) == sink_mv(pdo) && sink_ma(source_[i]) >= sink_ma(pdo))
+                    {
+                        request = static_cast<uint32_t>(i + 1) << 28 | (sink_ma(pdo) / 10) << 10 | (sink_ma(pdo) / 10);
+                        mv = sink_mv(pdo);
+                    }
+                }
+            }
+            if (request == 0)
+                request = 1u << 28 | 1u << 26 | (sink_ma(source_.empty() ? 0 : source_[0]) / 10) << 10;
+
+            at(now_us() + timing.accept_us, [this, gen] {
+                if (gen == generation_)
+                    regs[PE_FSM] = PE_SNK_SELECT_CAPABILITY;
+            });
+            const int64_t ps_rdy = now_us() + timing.accept_us + timing.us_per_volt * mv / 1000;
+            at(ps_rdy, [this, gen, request, mv] {
+                if (gen != generation_ || !attached())
+                    return;
+                ++contracts;
+                contract_us = now_us();
+                contract_mv_ = mv;
+                regs[RX_HEADER] = MSG_PS_RDY;
+                regs[RX_HEADER + 1] = 0;
+                put_le32(&regs[RDO], request);
+                regs[PE_FSM] = PE_SNK_READY;
+                regs[PRT_STATUS] |= 1 << 2;
+                raise(ALERT_PRT);
+            });
+        });
+    }
+
+    void ChipSim::on_read(uint8_t reg, uint8_t *, size_t len)
+    {
+        // Registres effacés à la lecture
+        for (size_t i = 0; i < len; ++i)
+        {
+            const uint8_t r = static_cast<uint8_t>(reg + i);
+            if (r == ALERT)
+                regs[ALERT] = 0;
+            else if (r == PORT_STATUS_0)
+                regs[PORT_STATUS_0] &= ~1;
+            else if (r == PRT_STATUS)
+                regs[PRT_STATUS] &= ~(1 << 2 | 1 << 0);
+            else if (r == TYPEC_MONITORING_STATUS_0)
+                regs[TYPEC_MONITORING_STATUS_0] &= ~0x0F;
+        }
+        update_pin();
+    }
+
+    void ChipSim::on_write(uint8_t reg, const uint8_t *data, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            const uint8_t r = static_cast<uint8_t>(reg + i);
+            if (r == ALERT_MASK)
+                update_pin();
+            else if (r == FTP_CTRL_0 && (data[i] & 0x10) != 0)
+                ftp_request(data[i]);
+            else if (r == PD_COMMAND_CTRL && data[i] == 0x26 && regs[TX_HEADER_LOW] == 0x0D)
+            {
+                ++soft_resets;
+                if (!attached())
+                    continue;
+                // Soft reset accepté : négociation en cours abandonnée, la source renvoie ses capacités
+                ++generation_;
+                frozen_ = false;
+                regs[PE_FSM] = PE_SEND_SOFT_RESET;
+                send_caps(now_us() + timing.soft_reset_caps_us);
+            }
+            else if (r == PD_COMMAND_CTRL && data[i] == 0x05)
+            {
+                ++hard_resets;
+                if (!attached())
+                    continue;
+                ++generation_;
+                frozen_ = false;
+                contract_mv_ = 0;
+                std::memset(&regs[RDO], 0, 4);
+                regs[PE_FSM] = PE_HARD_RESET;
+                send_caps(now_us() + timing.hard_reset_caps_us);
+            }
+        }
+    }
+
+    void ChipSim::ftp_request(uint8_t ctrl0)
+    {
+        // Opérations FTP seulement clé présente et hors reset (RST_N)
+        if (!ftp_unlocked() || (ctrl0 & 0x40) == 0)
+            return;
+
+        ++ftp_requests;
+        const size_t sector = ctrl0 & 0x07;
+        switch (regs[FTP_CTRL_1])
+        {
+        case 0x00: // READ
+            if (sector < 5)
+                std::memcpy(&regs[RW_BUFFER], &nvm[sector * 8], 8);
+            break;
+        case 0x01: // LOAD
+            std::memcpy(ftp_load_.data(), &regs[RW_BUFFER], 8);
+            break;
+        case 0x06: // PROG
+            if (sector < 5)
+                std::memcpy(&nvm[sector * 8], ftp_load_.data(), 8);
+            break;
+        case 0x05: // ERASE_EXEC
+            nvm.fill(0);
+            break;
+        default:
+            break;
+        }
+        regs[FTP_CTRL_0] &= ~0x10; // REQ retombe en fin d'opération
+    }
+
+} // namespace host
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "fake_bus.hpp"
+
+namespace host
+{
+    /**
+     * @brief STUSB4500 et source USB PD simulés au niveau registres, sur l'horloge virtuelle.
+     *
+     * Modélise ce que le driver observe : ALERT_STATUS_1 et PRT_STATUS effacés
+     * à la lecture, broche ALERT dérivée du masque 0x0C, buffer RX, état du
+     * policy engine (0x29), RDO, séquence FTP de la NVM (clé, opcodes, REQ).
+     * La source envoie ses capacités après `first_caps_us` ; la puce retient
+     * le PDO sink de plus haut rang servi par la source, comme le STUSB4500,
+     * puis PS_RDY arrive après la transition VBUS. Un soft reset relance la
+     * négociation avec la table sink présente à cet instant.
+     */
+    class ChipSim : public FakeBus
+    {
+    public:
+        // Registres
+        static constexpr uint8_t ALERT = 0x0B;
+        static constexpr uint8_t ALERT_MASK = 0x0C;
+        static constexpr uint8_t PORT_STATUS_0 = 0x0D;
+        static constexpr uint8_t PORT_STATUS_1 = 0x0E;
+        static constexpr uint8_t TYPEC_MONITORING_STATUS_0 = 0x0F;
+        static constexpr uint8_t CC_HW_FAULT_STATUS_1 = 0x13;
+        static constexpr uint8_t PRT_STATUS = 0x16;
+        static constexpr uint8_t PD_COMMAND_CTRL = 0x1A;
+        static constexpr uint8_t PE_FSM = 0x29;
+        static constexpr uint8_t DEVICE_ID = 0x2F;
+        static constexpr uint8_t RX_HEADER = 0x31;
+        static constexpr uint8_t TX_HEADER_LOW = 0x51;
+        static constexpr uint8_t RW_BUFFER = 0x53;
+        static constexpr uint8_t PDO_NUMBER = 0x70;
+        static constexpr uint8_t SINK_PDO1 = 0x85;
+        static constexpr uint8_t RDO = 0x91;
+        static constexpr uint8_t FTP_KEY = 0x95;
+        static constexpr uint8_t FTP_CTRL_0 = 0x96;
+        static constexpr uint8_t FTP_CTRL_1 = 0x97;
+
+        // Bits d'ALERT_STATUS_1
+        static constexpr uint8_t ALERT_PRT = 1 << 1;
+        static constexpr uint8_t ALERT_CC_HW_FAULT = 1 << 4;
+        static constexpr uint8_t ALERT_TYPEC_MONITORING = 1 << 5;
+        static constexpr uint8_t ALERT_PORT_STATUS = 1 << 6;
+        static constexpr uint8_t ALERT_VALID = 0x7A;
+
+        struct Timing
+        {
+            int64_t first_caps_us = 250000;     // attachement -> Source_Capabilities (VBUS établi)
+            int64_t soft_reset_caps_us = 30000; // Accept du soft reset -> Source_Capabilities
+            int64_t hard_reset_caps_us = 900000;
+            int64_t accept_us = 15000;          // Request -> Accept
+            int64_t us_per_volt = 1000;         // transition VBUS avant PS_RDY
+        };
+
+        ChipSim();
+
+        /// Fixed PDO source (mV, mA)
+        static uint32_t fixed(uint32_t mv, uint32_t ma);
+        /// Sink PDO tel que lu dans la table 0x85 (mV, mA)
+        static uint32_t sink_mv(uint32_t pdo) { return ((pdo >> 10) & 0x3FF) * 50; }
+        static uint32_t sink_ma(uint32_t pdo) { return (pdo & 0x3FF) * 10; }
+
+        void attach(const std::vector<uint32_t> &source_pdos);
+        void detach();
+        bool attached() const { return (regs[PORT_STATUS_1] & 1) != 0; }
+
+        /// Fige le policy engine dans `state` (plus de négociation jusqu'au prochain reset ou attachement)
+        void freeze_pe(uint8_t state);
+
+        /// Message de contrôle reçu (ex. Wait, 0x0C) laissant le policy engine figé dans `pe_state`
+        void receive_control(uint8_t type, uint8_t pe_state);
+
+        /// Nouvelles capacités annoncées par la source déjà attachée
+        void resend_caps(const std::vector<uint32_t> &source_pdos);
+
+        /// Hard reset émis par la source : contrat perdu, capacités renvoyées après `hard_reset_caps_us`
+        void receive_hard_reset();
+
+        /// Défaut matériel CC (CC_HW_FAULT_STATUS_1, ex. 0x10 VBUS_DISCH_FAULT), attaché ou non
+        void cc_fault(uint8_t fault1);
+
+        /// Transition VBUS (TYPEC_MONITORING_STATUS_0, VBUS_VALID_SNK_TRANS) : bruit du point de vue du driver
+        void vbus_glitch();
+
+        uint32_t rdo() const;
+        uint32_t sink_pdo(size_t index) const;
+        uint8_t sink_pdo_count() const { return regs[PDO_NUMBER]; }
+        /// Tension du contrat en cours (mV), 0 sans contrat
+        uint32_t contract_mv() const { return contract_mv_; }
+
+        std::array<uint8_t, 40> nvm{};
+        bool ftp_unlocked() const { return regs[FTP_KEY] == 0x47; }
+
+        Timing timing;
+        bool silent = false;        // source muette : plus aucune capacité envoyée, même après un reset
+        uint32_t negotiations = 0;  // Source_Capabilities envoyés
+        uint32_t contracts = 0;     // PS_RDY reçus
+        uint32_t soft_resets = 0;
+        uint32_t hard_resets = 0;
+        uint32_t ftp_requests = 0;
+        int64_t contract_us = 0;    // instant du dernier PS_RDY
+
+    protected:
+        void on_read(uint8_t reg, uint8_t *data, size_t len) override;
+        void on_write(uint8_t reg, const uint8_t *data, size_t len) override;
+
+    private:
+        void raise(uint8_t alert);
+        void update_pin();
+        void send_caps(int64_t when_us);
+        void ftp_request(uint8_t ctrl0);
+
+        std::vector<uint32_t> source_;
+        uint32_t generation_ = 0; // invalide les étapes d'une négociation interrompue
+        uint32_t contract_mv_ = 0;
+        bool frozen_ = false;
+        std::array<uint8_t, 8> ftp_load_{};
+    };
+
+} // namespace host
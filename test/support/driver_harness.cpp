@@ -0,0 +1,40 @@
+#include "driver_harness.hpp"
+
+#include <algorithm>
+
+#include "config/stusb4500-config_macro.hpp"
+#include "host_platform.hpp"
+#include "nvm/stusb4500-nvm_data.hpp"
+
+namespace host
+{
+    void load_kconfig(ChipSim &chip)
+    {
+        stusb4500::ConfigParams cfg = stusb4500::load_config_from_kconfig();
+        chip.nvm = stusb4500::kconfig_nvm_image();
+        for (size_t i = 0; i < cfg.power_.pdos.size(); ++i)
+        {
+            const uint32_t pdo = cfg.power_.encode(i);
+            for (int b = 0; b < 4; ++b)
+                chip.regs[ChipSim::SINK_PDO1 + 4 * i + b] = static_cast<uint8_t>(pdo >> (8 * b));
+        }
+        chip.regs[ChipSim::PDO_NUMBER] = cfg.power_.pdo_number;
+        chip.regs[ChipSim::ALERT_MASK] = cfg.alert_mask.get_raw();
+    }
+
+    void run_alerts_until(stusb4500::STUSB4500Manager &manager, int64_t until_us)
+    {
+        while (now_us() < until_us)
+        {
+            if (alert_level() == 0)
+            {
+                // Une erreur bus laisse l'alerte en place : la tâche réessaierait plus tard
+                if (manager.handle_alert() != ESP_OK)
+                    advance_us(1000);
+                continue;
+            }
+            advance_to(std::min(next_event_us(), until_us));
+        }
+    }
+
+} // namespace host
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "stusb4500.hpp"
+
+#include "chip_sim.hpp"
+
+namespace host
+{
+    /// NVM, table PDO et masque d'alerte du ChipSim alignés sur le Kconfig : init_device() ne reprogramme pas la NVM
+    void load_kconfig(ChipSim &chip);
+
+    /**
+     * @brief Traite les alertes comme le ferait la tâche du driver, sans elle, jusqu'à `until_us`.
+     *
+     * handle_alert() est appelé tant que la broche ALERT est basse ; entre deux
+     * alertes l'horloge saute au prochain événement simulé.
+     */
+    void run_alerts_until(stusb4500::STUSB4500Manager &manager, int64_t until_us);
+
+} // namespace host
@@ -0,0 +1,95 @@
+#include "fake_bus.hpp"
+
+#include <cstring>
+
+#include "I2CDevices.hpp"
+#include "host_platform.hpp"
+
+namespace host
+{
+    namespace
+    {
+        FakeBus *current = nullptr;
+    }
+
+    FakeBus::FakeBus()
+    {
+        current = this;
+    }
+
+    FakeBus::~FakeBus()
+    {
+        if (current == this)
+            current = nullptr;
+    }
+
+    FakeBus *current_bus()
+    {
+        return current;
+    }
+
+    esp_err_t FakeBus::read(uint8_t reg, uint8_t *data, size_t len)
+    {
+        // START, adresse, registre, RESTART, adresse, données
+        counters_.bus_bytes += static_cast<uint32_t>(3 + len);
+        advance_us(static_cast<int64_t>(byte_us) * (3 + len));
+        if (fail_next > 0)
+        {
+            --fail_next;
+            return ESP_FAIL;
+        }
+        ++counters_.reads;
+        counters_.read_bytes += static_cast<uint32_t>(len);
+        for (size_t i = 0; i < len; ++i)
+            data[i] = regs[(reg + i) & 0xFF];
+        on_read(reg, data, len);
+        if (keep_log)
+            log_.push_back({false, reg, std::vector<uint8_t>(data, data + len)});
+        return ESP_OK;
+    }
+
+    esp_err_t FakeBus::write(uint8_t reg, const uint8_t *data, size_t len)
+    {
+        counters_.bus_bytes += static_cast<uint32_t>(2 + len);
+        advance_us(static_cast<int64_t>(byte_us) * (2 + len));
+        if (fail_next > 0)
+        {
+            --fail_next;
+            return ESP_FAIL;
+        }
+        ++counters_.writes;
+        counters_.write_bytes += static_cast<uint32_t>(len);
+        if (keep_log)
+            log_.push_back({true, reg, std::vector<uint8_t>(data, data + len)});
+        for (size_t i = 0; i < len; ++i)
+            regs[(reg + i) & 0xFF] = data[i];
+        on_write(reg, data, len);
+        if (late_timeout_next > 0)
+        {
+            --late_timeout_next;
+            return ESP_ERR_TIMEOUT;
+        }
+        return ESP_OK;
+    }
+
+    void FakeBus::on_read(uint8_t, uint8_t *, size_t)
+    {
+    }
+
+    void FakeBus::on_write(uint8_t, const uint8_t *, size_t)
+    {
+    }
+
+} // namespace host
+
+esp_err_t I2CDevices::read(uint8_t reg, uint8_t *data, size_t len)
+{
+    host::FakeBus *bus = host::current_bus();
+    return bus != nullptr ? bus->read(reg, data, len) : ESP_FAIL;
+}
+
+esp_err_t I2CDevices::write(uint8_t reg, const uint8_t *data, size_t len)
+{
+    host::FakeBus *bus = host::current_bus();
+    return bus != nullptr ? bus->write(reg, data, len) : ESP_FAIL;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esp_err.h"
+
+namespace host
+{
+    /**
+     * @brief Périphérique I2C simulé derrière I2CDevices::read()/write().
+     *
+     * Fichier de 256 registres, compteurs de transactions et d'octets, et coût
+     * temporel de chaque transaction sur l'horloge virtuelle (100 kHz : 9 bits
+     * par octet, adresse et registre compris). Les dérivées (ChipSim)
+     * surchargent on_read()/on_write() pour les registres à effet de bord.
+     */
+    class FakeBus
+    {
+    public:
+        struct Transaction
+        {
+            bool write;
+            uint8_t reg;
+            std::vector<uint8_t> data;
+        };
+
+        struct Counters
+        {
+            uint32_t reads = 0;
+            uint32_t writes = 0;
+            uint32_t read_bytes = 0;  // octets de données, hors adresse et registre
+            uint32_t write_bytes = 0;
+            uint32_t bus_bytes = 0;   // octets sur le fil, adresse et registre compris
+
+            uint32_t transactions() const { return reads + writes; }
+        };
+
+        FakeBus();
+        virtual ~FakeBus();
+
+        esp_err_t read(uint8_t reg, uint8_t *data, size_t len);
+        esp_err_t write(uint8_t reg, const uint8_t *data, size_t len);
+
+        std::array<uint8_t, 256> regs{};
+
+        const Counters &counters() const { return counters_; }
+        void reset_counters() { counters_ = {}; log_.clear(); }
+
+        /// Journal des transactions depuis reset_counters() (si keep_log)
+        const std::vector<Transaction> &transactions() const { return log_; }
+        bool keep_log = false;
+
+        /// Durée d'un octet sur le bus (µs), 0 pour une transaction instantanée
+        uint32_t byte_us = 90;
+
+        /// Prochaines transactions en échec (ESP_FAIL), pour les tests de reprise
+        uint32_t fail_next = 0;
+        /// Prochaines écritures appliquées au registre mais répondant ESP_ERR_TIMEOUT (ACK final perdu)
+        uint32_t late_timeout_next = 0;
+
+    protected:
+        virtual void on_read(uint8_t reg, uint8_t *data, size_t len);
+        virtual void on_write(uint8_t reg, const uint8_t *data, size_t len);
+
+    private:
+        Counters counters_;
+        std::vector<Transaction> log_;
+    };
+
+    /// Bus courant derrière I2CDevices (le dernier FakeBus construit)
+    FakeBus *current_bus();
+
+} // namespace host
@@ -0,0 +1,84 @@
+#include "file_region.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace host
+{
+    FileRegion::FileRegion(const std::string &path, size_t size, size_t sector_size)
+        : size_(size), sector_size_(sector_size)
+    {
+        file_ = std::fopen(path.c_str(), "r+b");
+        if (file_ == nullptr)
+        {
+            // Nouvelle zone : entièrement effacée
+            file_ = std::fopen(path.c_str(), "w+b");
+            if (file_ == nullptr)
+                return;
+            const std::vector<uint8_t> blank(size_, 0xFF);
+            std::fwrite(blank.data(), 1, blank.size(), file_);
+            std::fflush(file_);
+        }
+    }
+
+    FileRegion::~FileRegion()
+    {
+        if (file_ != nullptr)
+            std::fclose(file_);
+    }
+
+    esp_err_t FileRegion::read(size_t offset, void *data, size_t len)
+    {
+        if (file_ == nullptr || offset + len > size_)
+            return ESP_ERR_INVALID_ARG;
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fread(data, 1, len, file_) != len)
+            return ESP_FAIL;
+        return ESP_OK;
+    }
+
+    esp_err_t FileRegion::write(size_t offset, const void *data, size_t len)
+    {
+        if (file_ == nullptr || offset + len > size_)
+            return ESP_ERR_INVALID_ARG;
+
+        std::vector<uint8_t> cells(len);
+        if (read(offset, cells.data(), len) != ESP_OK)
+            return ESP_FAIL;
+
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        const size_t written = std::min(len, write_budget_);
+        bool dirty = false;
+        for (size_t i = 0; i < written; ++i)
+        {
+            dirty |= (bytes[i] & ~cells[i]) != 0;
+            cells[i] &= bytes[i]; // NOR : un bit ne repasse à 1 que par effacement
+        }
+        ++writes_;
+        if (dirty)
+            ++dirty_writes_;
+        if (write_budget_ != SIZE_MAX)
+            write_budget_ -= written;
+
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fwrite(cells.data(), 1, written, file_) != written)
+            return ESP_FAIL;
+        std::fflush(file_);
+        return written == len ? ESP_OK : ESP_FAIL;
+    }
+
+    esp_err_t FileRegion::erase(size_t offset, size_t len)
+    {
+        if (file_ == nullptr || offset % sector_size_ != 0 || len % sector_size_ != 0 || offset + len > size_)
+            return ESP_ERR_INVALID_ARG;
+        const std::vector<uint8_t> blank(len, 0xFF);
+        ++erases_;
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fwrite(blank.data(), 1, len, file_) != len)
+            return ESP_FAIL;
+        std::fflush(file_);
+        return ESP_OK;
+    }
+
+} // namespace host
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "storage/stusb4500-flash_region.hpp"
+
+namespace host
+{
+    /**
+     * @brief FlashRegion dans un fichier, à la place d'une partition sur Linux.
+     *
+     * Même contrat qu'une NOR : erase() remet des secteurs à 0xFF, write() ne
+     * fait que passer des bits à 0 (ET avec le contenu) et une écriture sur
+     * une zone non effacée est comptée dans dirty_writes(). fail_writes_after()
+     * coupe une écriture en cours de route, comme une alimentation perdue ou
+     * une erreur SPI, pour les tests de reprise du journal. Le fichier produit
+     * se décode avec tools/stusb4500_journal.py.
+     */
+    class FileRegion : public stusb4500::FlashRegion
+    {
+    public:
+        FileRegion(const std::string &path, size_t size, size_t sector_size = 4096);
+        ~FileRegion() override;
+
+        bool is_open() const { return file_ != nullptr; }
+
+        size_t size() const override { return size_; }
+        size_t sector_size() const override { return sector_size_; }
+
+        esp_err_t read(size_t offset, void *data, size_t len) override;
+        esp_err_t write(size_t offset, const void *data, size_t len) override;
+        esp_err_t erase(size_t offset, size_t len) override;
+
+        /// Les `bytes` prochains octets s'écrivent, puis toute écriture échoue jusqu'à fail_writes_after(SIZE_MAX)
+        void fail_writes_after(size_t bytes) { write_budget_ = bytes; }
+
+        uint32_t writes() const { return writes_; }
+        uint32_t erases() const { return erases_; }
+        /// Écritures ayant trouvé des octets non effacés (bits à 0 qu'on voulait à 1)
+        uint32_t dirty_writes() const { return dirty_writes_; }
+
+    private:
+        std::FILE *file_ = nullptr;
+        size_t size_;
+        size_t sector_size_;
+        size_t write_budget_ = SIZE_MAX;
+        uint32_t writes_ = 0;
+        uint32_t erases_ = 0;
+        uint32_t dirty_writes_ = 0;
+    };
+
+} // namespace host
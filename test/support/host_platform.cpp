@@ -0,0 +1,327 @@
+#include "host_platform.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace
+{
+    struct Task
+    {
+        void (*entry)(void *) = nullptr;
+        void *arg = nullptr;
+        bool started = false;
+        bool running = false; // la tâche a la main, le test attend
+        int64_t until_us = 0;
+    };
+
+    // Tout l'état est alloué une fois et jamais détruit : la tâche, bloquée dans
+    // son attente, survit à la fin de main()
+    struct State
+    {
+        std::recursive_mutex clock_lock;
+        int64_t now_us = 0;
+        uint64_t sequence = 0;
+        std::multimap<std::pair<int64_t, uint64_t>, std::function<void()>> events;
+
+        std::mutex task_lock;
+        std::condition_variable task_cv;
+        Task task;
+        uint32_t notifications = 0;
+
+        int alert_level = 1;
+        void (*isr)(void *) = nullptr;
+        void *isr_arg = nullptr;
+
+        bool log = std::getenv("STUSB4500_HOST_LOG") != nullptr;
+    };
+
+    State &state()
+    {
+        static State *s = new State;
+        return *s;
+    }
+
+    bool take_notification(bool clear, uint32_t &out)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        if (s.notifications == 0)
+            return false;
+        out = s.notifications;
+        s.notifications = clear ? 0 : s.notifications - 1;
+        return true;
+    }
+
+    // Rend la main au test et attend le prochain run_task_for()
+    void yield_to_test()
+    {
+        State &s = state();
+        std::unique_lock<std::mutex> lock(s.task_lock);
+        s.task.running = false;
+        s.task_cv.notify_all();
+        s.task_cv.wait(lock, [&] { return s.task.running; });
+    }
+
+    int64_t task_until()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        return s.task.until_us;
+    }
+} // namespace
+
+namespace host
+{
+    int64_t now_us()
+    {
+        State &s = state();
+        std::lock_guard<std::recursive_mutex> lock(s.clock_lock);
+        return s.now_us;
+    }
+
+    void advance_to(int64_t when_us)
+    {
+        State &s = state();
+        std::unique_lock<std::recursive_mutex> lock(s.clock_lock);
+        while (!s.events.empty() && s.events.begin()->first.first <= when_us)
+        {
+            auto it = s.events.begin();
+            s.now_us = std::max(s.now_us, it->first.first);
+            std::function<void()> fn = std::move(it->second);
+            s.events.erase(it);
+            fn();
+        }
+        s.now_us = std::max(s.now_us, when_us);
+    }
+
+    void advance_us(int64_t us)
+    {
+        advance_to(now_us() + us);
+    }
+
+    void at(int64_t when_us, std::function<void()> fn)
+    {
+        State &s = state();
+        std::lock_guard<std::recursive_mutex> lock(s.clock_lock);
+        s.events.emplace(std::make_pair(when_us, s.sequence++), std::move(fn));
+    }
+
+    int64_t next_event_us()
+    {
+        State &s = state();
+        std::lock_guard<std::recursive_mutex> lock(s.clock_lock);
+        return s.events.empty() ? INT64_MAX : s.events.begin()->first.first;
+    }
+
+    void clear_events()
+    {
+        State &s = state();
+        std::lock_guard<std::recursive_mutex> lock(s.clock_lock);
+        s.events.clear();
+    }
+
+    void reset()
+    {
+        State &s = state();
+        {
+            std::lock_guard<std::recursive_mutex> lock(s.clock_lock);
+            s.now_us = 0;
+            s.events.clear();
+        }
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        s.notifications = 0;
+        s.alert_level = 1;
+    }
+
+    void run_task_for(int64_t us)
+    {
+        State &s = state();
+        std::unique_lock<std::mutex> lock(s.task_lock);
+        if (s.task.entry == nullptr)
+            return;
+        s.task.until_us = now_us() + us;
+        s.task.running = true;
+        if (!s.task.started)
+        {
+            s.task.started = true;
+            std::thread([] {
+                State &st = state();
+                {
+                    std::unique_lock<std::mutex> l(st.task_lock);
+                    st.task_cv.wait(l, [&] { return st.task.running; });
+                }
+                st.task.entry(st.task.arg);
+            }).detach();
+        }
+        s.task_cv.notify_all();
+        s.task_cv.wait(lock, [&] { return !s.task.running; });
+    }
+
+    bool task_created()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        return s.task.entry != nullptr;
+    }
+
+    uint32_t pending_notifications()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        return s.notifications;
+    }
+
+    void set_alert_level(int level)
+    {
+        State &s = state();
+        void (*isr)(void *) = nullptr;
+        void *arg = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(s.task_lock);
+            if (s.alert_level != 0 && level == 0)
+            {
+                isr = s.isr;
+                arg = s.isr_arg;
+            }
+            s.alert_level = level;
+        }
+        if (isr != nullptr)
+            isr(arg);
+    }
+
+    int alert_level()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.task_lock);
+        return s.alert_level;
+    }
+
+    void enable_log(bool enabled)
+    {
+        state().log = enabled;
+    }
+
+} // namespace host
+
+bool host_log_enabled()
+{
+    return state().log;
+}
+
+// === Horloge ===
+
+int64_t esp_timer_get_time(void)
+{
+    return host::now_us();
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    host::advance_us(us);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host::advance_us(static_cast<int64_t>(ticks) * 1000 * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return static_cast<TickType_t>(host::now_us() / 1000 / portTICK_PERIOD_MS);
+}
+
+void vPortYield(void)
+{
+}
+
+// === Tâche et notifications ===
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void *), const char *, uint32_t, void *arg, int, TaskHandle_t *handle,
+                                   int)
+{
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.task_lock);
+    if (s.task.entry != nullptr)
+        return pdFALSE; // une seule tâche simulée par processus
+    s.task.entry = task;
+    s.task.arg = arg;
+    if (handle != nullptr)
+        *handle = &s.task;
+    return pdPASS;
+}
+
+void xTaskNotifyGive(TaskHandle_t)
+{
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.task_lock);
+    ++s.notifications;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    xTaskNotifyGive(task);
+    if (woken != nullptr)
+        *woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+    const int64_t deadline = timeout == portMAX_DELAY ? INT64_MAX
+                                                      : host::now_us() + static_cast<int64_t>(timeout) * 1000;
+    for (;;)
+    {
+        uint32_t taken = 0;
+        if (take_notification(clear == pdTRUE, taken))
+            return taken;
+        const int64_t now = host::now_us();
+        if (now >= deadline)
+            return 0;
+
+        const int64_t until = task_until();
+        if (now >= until)
+        {
+            yield_to_test();
+            continue;
+        }
+        // Jusqu'au prochain événement simulé, à l'échéance ou à la fin de la tranche accordée par le test
+        host::advance_to(std::min({deadline, until, std::max(host::next_event_us(), now)}));
+    }
+}
+
+// === GPIO ===
+
+esp_err_t gpio_config(const gpio_config_t *)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t, void (*handler)(void *), void *arg)
+{
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.task_lock);
+    s.isr = handler;
+    s.isr_arg = arg;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t)
+{
+    return host::alert_level();
+}
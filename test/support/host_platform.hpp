@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace host
+{
+    /**
+     * @brief Horloge virtuelle et ordonnanceur d'événements de la cible hôte.
+     *
+     * esp_timer_get_time() lit cette horloge ; vTaskDelay(), esp_rom_delay_us()
+     * et chaque transaction I2C simulée la font avancer. Les événements
+     * programmés avec at() s'exécutent, dans l'ordre, quand l'horloge atteint
+     * leur échéance : les tests sont déterministes et ne dorment jamais.
+     */
+    int64_t now_us();
+    void advance_us(int64_t us);
+    /// Avance jusqu'à `when_us` (sans effet si déjà dépassé)
+    void advance_to(int64_t when_us);
+
+    void at(int64_t when_us, std::function<void()> fn);
+    /// Échéance du prochain événement, INT64_MAX si aucun
+    int64_t next_event_us();
+    void clear_events();
+
+    /// Horloge à zéro, événements, notifications et broche ALERT remis à l'état initial
+    void reset();
+
+    /**
+     * @brief Tâche créée par xTaskCreatePinnedToCore(), exécutée en alternance stricte avec le test.
+     *
+     * Le test garde la main ; run_task_for() la cède à la tâche jusqu'à ce que
+     * l'horloge virtuelle ait avancé de `us` et que la tâche se bloque
+     * (ulTaskNotifyTake). Un seul fil s'exécute à la fois : pas de course,
+     * résultat reproductible.
+     */
+    void run_task_for(int64_t us);
+    bool task_created();
+    /// Notifications reçues par la tâche et pas encore consommées
+    uint32_t pending_notifications();
+
+    /// Niveau de la broche ALERT (active basse) ; un front descendant appelle le handler GPIO installé
+    void set_alert_level(int level);
+    int alert_level();
+
+    /// Active les traces ESP_LOGx sur stdout (désactivées par défaut)
+    void enable_log(bool enabled);
+
+} // namespace host
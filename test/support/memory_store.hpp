@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "storage/stusb4500-kv_store.hpp"
+
+namespace host
+{
+    /**
+     * @brief KeyValueStore en RAM, avec la sémantique de nvs_get_blob().
+     *
+     * Un buffer trop petit pour le blob stocké répond INVALID_LENGTH (comme
+     * ESP_ERR_NVS_INVALID_LENGTH) ; `data == nullptr` retourne la taille du blob.
+     */
+    class MemoryStore : public stusb4500::KeyValueStore
+    {
+    public:
+        static constexpr esp_err_t INVALID_LENGTH = 0x110C;
+
+        esp_err_t get(const char *key, void *data, size_t &len) override
+        {
+            ++gets;
+            auto it = blobs.find(key);
+            if (it == blobs.end())
+                return ESP_ERR_NOT_FOUND;
+            if (data == nullptr)
+            {
+                len = it->second.size();
+                return ESP_OK;
+            }
+            if (len < it->second.size())
+                return INVALID_LENGTH;
+            len = it->second.size();
+            if (len != 0)
+                std::memcpy(data, it->second.data(), len);
+            return ESP_OK;
+        }
+
+        esp_err_t set(const char *key, const void *data, size_t len) override
+        {
+            ++sets;
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            blobs[key].assign(bytes, bytes + (bytes != nullptr ? len : 0));
+            return ESP_OK;
+        }
+
+        esp_err_t erase(const char *key) override
+        {
+            return blobs.erase(key) != 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+        }
+
+        std::map<std::string, std::vector<uint8_t>> blobs;
+        uint32_t gets = 0;
+        uint32_t sets = 0; // écritures persistantes (usure NVS)
+    };
+
+} // namespace host
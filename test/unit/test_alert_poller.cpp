@@ -0,0 +1,139 @@
+// Cadence du polling d'ALERT_STATUS_1 sans broche ALERT : adaptation de l'intervalle sur l'horloge virtuelle.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "ctrl/stusb4500-alert_poller.hpp"
+#include "stusb4500-interface.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr int64_t MS = 1000;
+
+    AlertPoller::Settings settings()
+    {
+        AlertPoller::Settings s;
+        s.fast_ms = 20;
+        s.slow_ms = 1000;
+        s.hold_ms = 200;
+        return s;
+    }
+
+    // Boucle de la tâche en mode polling : attente de l'intervalle, lecture d'ALERT_STATUS_1 (effacé à la lecture)
+    void poll_until(host::ChipSim &chip, AlertPoller &poller, int64_t until_us, bool negotiating = false)
+    {
+        I2CDevices dev;
+        INTERFACE io(dev);
+        while (host::now_us() + static_cast<int64_t>(poller.interval_ms()) * MS <= until_us)
+        {
+            host::advance_us(static_cast<int64_t>(poller.interval_ms()) * MS);
+            if (negotiating)
+                poller.keep_fast(host::now_us());
+            const int64_t start = host::now_us();
+            uint8_t alert = 0;
+            CHECK_OK(io.read_register(host::ChipSim::ALERT, &alert, 1));
+            const uint8_t mask = chip.regs[host::ChipSim::ALERT_MASK];
+            poller.on_poll(start, (alert & host::ChipSim::ALERT_VALID & ~mask) != 0);
+        }
+    }
+} // namespace
+
+TEST_CASE(interval_doubles_to_slow_and_drops_on_alert)
+{
+    host::reset();
+    AlertPoller poller(settings());
+    CHECK_EQ(poller.interval_ms(), 20u);
+
+    // Sans alerte : 40, 80, ... plafonné à slow_ms
+    int64_t now = 0;
+    const uint32_t expected[] = {40, 80, 160, 320, 640, 1000, 1000};
+    for (uint32_t interval : expected)
+    {
+        now += poller.interval_ms() * MS;
+        poller.on_poll(now, false);
+        CHECK_EQ(poller.interval_ms(), interval);
+    }
+
+    // Alerte : retour immédiat en cadence rapide, maintenue pendant hold_ms
+    now += poller.interval_ms() * MS;
+    poller.on_poll(now, true);
+    CHECK_EQ(poller.interval_ms(), 20u);
+    const int64_t alert_us = now;
+    while (now + 20 * MS < alert_us + 200 * MS)
+    {
+        now += 20 * MS;
+        poller.on_poll(now, false);
+        CHECK_EQ(poller.interval_ms(), 20u);
+    }
+    now = alert_us + 200 * MS;
+    poller.on_poll(now, false);
+    CHECK_EQ(poller.interval_ms(), 40u);
+
+    const AlertPoller::Stats &stats = poller.stats();
+    CHECK_EQ(stats.alerts, 1u);
+    CHECK_EQ(stats.latency_max_ms, 1000u);
+    CHECK_EQ(stats.latency_mean_ms(), 500u);
+}
+
+TEST_CASE(keep_fast_holds_the_fast_interval)
+{
+    AlertPoller poller(settings());
+    int64_t now = 0;
+    for (int i = 0; i < 50; ++i)
+    {
+        now += poller.interval_ms() * MS;
+        poller.keep_fast(now);
+        poller.on_poll(now, false);
+        CHECK_EQ(poller.interval_ms(), 20u);
+    }
+    CHECK_EQ(poller.stats().polls, 50u);
+    CHECK_EQ(poller.stats().alerts, 0u);
+}
+
+TEST_CASE(simulated_attach_polled_fast_then_slow)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    // Masque tel que laissé par les abonnements du driver : PRT et PORT_STATUS démasqués
+    chip.regs[host::ChipSim::ALERT_MASK] =
+        static_cast<uint8_t>(~(host::ChipSim::ALERT_PRT | host::ChipSim::ALERT_PORT_STATUS));
+    // Source lente à annoncer ses capacités : attachement et négociation sont deux rafales distinctes
+    chip.timing.first_caps_us = 1500 * MS;
+    AlertPoller poller(settings());
+
+    // Régime établi sans source : lectures espacées jusqu'à slow_ms
+    poll_until(chip, poller, 5000 * MS);
+    CHECK_EQ(poller.interval_ms(), 1000u);
+    CHECK(poller.stats().polls <= 10u);
+
+    // Attachement vu au plus tard une fenêtre lente après
+    const int64_t attach_us = host::now_us();
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+    poll_until(chip, poller, attach_us + 1200 * MS);
+    CHECK_EQ(poller.stats().alerts, 1u);
+    CHECK(poller.stats().latency_max_ms <= 1000u);
+    const uint64_t attach_window_ms = poller.stats().latency_sum_ms;
+
+    // Watchdog armé par l'attachement : capacités et PS_RDY vus chacun dans une fenêtre rapide
+    poll_until(chip, poller, attach_us + 2000 * MS, true);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(poller.stats().alerts, 3u);
+    CHECK(poller.stats().latency_sum_ms - attach_window_ms <= 2 * 20u);
+    CHECK_EQ(poller.interval_ms(), 20u);
+
+    // Contrat établi : retour progressif à la cadence lente
+    const uint32_t polls = poller.stats().polls;
+    poll_until(chip, poller, attach_us + 7000 * MS);
+    CHECK_EQ(poller.interval_ms(), 1000u);
+    CHECK(poller.stats().polls - polls <= 20u);
+
+    // Occupation du bus : 39 bits par lecture à 100 kHz, bien sous 1 %
+    const uint32_t ppm = poller.stats().bus_utilization_ppm(100000);
+    CHECK(ppm > 0u);
+    CHECK(ppm < 10000u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,127 @@
+// Abonnements aux alertes : masque dérivé, et écriture de 0x0C réservée à la tâche du driver.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "status/stusb4500-alert_subscriptions.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    void on_alert(AlertClass, const StatusSnapshot &, void *ctx)
+    {
+        ++*static_cast<int *>(ctx);
+    }
+
+    constexpr uint8_t TYPEC = static_cast<uint8_t>(AlertClass::TypeCMonitoring);
+    constexpr uint8_t PORT = static_cast<uint8_t>(AlertClass::PortStatus);
+
+    struct AlertLoad
+    {
+        uint32_t alerts = 0;
+        int handler_runs = 0;
+    };
+
+    // Attachement puis 20 transitions VBUS : alertes traitées et rappels de l'abonné
+    AlertLoad run_glitches(uint8_t classes)
+    {
+        host::reset();
+        host::ChipSim chip;
+        host::load_kconfig(chip);
+        I2CDevices dev;
+        STUSB4500Manager manager(dev);
+        AlertLoad load;
+        CHECK(manager.subscribe(classes, on_alert, &load.handler_runs) >= 0);
+        CHECK_OK(manager.init_device());
+
+        const uint32_t before = STUSB4500Manager::metrics().alerts_total;
+        chip.attach({host::ChipSim::fixed(5000, 3000)});
+        host::run_alerts_until(manager, host::now_us() + 500000);
+        for (int i = 0; i < 20; ++i)
+        {
+            chip.vbus_glitch();
+            host::run_alerts_until(manager, host::now_us() + 10000);
+        }
+        load.alerts = STUSB4500Manager::metrics().alerts_total - before;
+        return load;
+    }
+} // namespace
+
+TEST_CASE(mask_follows_subscriptions)
+{
+    AlertSubscriptions subs;
+    // Base NVM 0x00 : seules les familles internes restent démasquées
+    CHECK_EQ(subs.mask(0x00), static_cast<uint8_t>(AlertSubscriptions::MASKABLE & ~AlertSubscriptions::INTERNAL));
+    CHECK_EQ(subs.subscribe(0, on_alert), -1);
+    CHECK_EQ(subs.subscribe(TYPEC, nullptr), -1);
+
+    int calls = 0;
+    const int id = subs.subscribe(TYPEC, on_alert, &calls);
+    CHECK(id >= 0);
+    CHECK_EQ(subs.mask(0x00) & TYPEC, 0);
+    // Bits réservés repris de la base
+    CHECK_EQ(subs.mask(0x05) & 0x05, 0x05);
+
+    subs.dispatch(TYPEC | AlertClass::PRTStatus, StatusSnapshot{});
+    CHECK_EQ(calls, 1);
+    CHECK(subs.unsubscribe(id));
+    CHECK(!subs.unsubscribe(id));
+    CHECK_EQ(subs.mask(0x00) & TYPEC, TYPEC);
+}
+
+TEST_CASE(unsubscribed_family_stays_off_the_alert_pin)
+{
+    // Abonné aux transitions VBUS : chaque transition réveille le driver et l'abonné
+    const AlertLoad unmasked = run_glitches(PORT | TYPEC);
+    // Abonné au seul attachement : la famille reste masquée, la broche ne bouge pas
+    const AlertLoad masked = run_glitches(PORT);
+
+    CHECK(unmasked.alerts >= 20);
+    CHECK(unmasked.handler_runs >= 21);
+    CHECK(masked.alerts + 20 <= unmasked.alerts);
+    CHECK(masked.handler_runs + 20 <= unmasked.handler_runs);
+    CHECK(masked.handler_runs >= 1);
+}
+
+TEST_CASE(subscribe_defers_mask_write_to_task)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    manager.init();
+    host::run_task_for(100000);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK] & TYPEC, TYPEC);
+
+    // Depuis une tâche applicative : aucun accès bus, la tâche du driver est notifiée
+    chip.reset_counters();
+    int calls = 0;
+    const int id = manager.subscribe(TYPEC, on_alert, &calls);
+    CHECK(id >= 0);
+    CHECK_EQ(chip.counters().transactions(), 0u);
+    CHECK_EQ(host::pending_notifications(), 1u);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK] & TYPEC, TYPEC);
+
+    host::run_task_for(1000);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK] & TYPEC, 0);
+    CHECK_EQ(chip.counters().writes, 1u);
+
+    chip.reset_counters();
+    CHECK_OK(manager.unsubscribe(id));
+    CHECK(manager.unsubscribe(id) == ESP_ERR_NOT_FOUND);
+    CHECK_EQ(chip.counters().transactions(), 0u);
+    host::run_task_for(1000);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK] & TYPEC, TYPEC);
+    CHECK_EQ(chip.counters().writes, 1u);
+
+    // Écriture en échec (bus) : reprise par la tâche sans nouvel appel de l'application
+    manager.subscribe(TYPEC, on_alert, &calls);
+    chip.fail_next = 3;
+    host::run_task_for(1000);
+    CHECK_EQ(chip.fail_next, 0u);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK] & TYPEC, 0);
+}
+
+TEST_MAIN()
@@ -0,0 +1,165 @@
+// Capture I2C : session enregistrée sur le ChipSim puis rejouée par BusReplayer sans puce, divergences détectées.
+
+#include <cstdio>
+#include <vector>
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "fake_bus.hpp"
+#include "host_platform.hpp"
+#include "stusb4500-bus_capture.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    struct Session
+    {
+        std::vector<uint8_t> capture;
+        std::vector<int64_t> alerts_us; // instants des appels à handle_alert()
+        uint32_t records = 0;
+        uint32_t contract_mv = 0;
+    };
+
+    // Attachement d'une source 5/20 V traité alerte par alerte, comme le ferait la tâche
+    Session record_session()
+    {
+        host::reset();
+        host::ChipSim chip;
+        host::load_kconfig(chip);
+        static uint8_t buffer[16384];
+        BusRecorder recorder(buffer, sizeof(buffer));
+        BusTap::install(&recorder);
+
+        Session session;
+        I2CDevices dev;
+        STUSB4500Manager manager(dev);
+        CHECK_OK(manager.init_device());
+        chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+        const int64_t until = host::now_us() + 1000000;
+        while (host::now_us() < until)
+        {
+            if (host::alert_level() == 0)
+            {
+                session.alerts_us.push_back(host::now_us());
+                CHECK_OK(manager.handle_alert());
+                continue;
+            }
+            const int64_t next = host::next_event_us();
+            if (next >= until)
+                break;
+            host::advance_to(next);
+        }
+        BusTap::install(nullptr);
+
+        CHECK_EQ(recorder.dropped(), 0u);
+        session.capture.assign(recorder.data(), recorder.data() + recorder.size());
+        session.records = recorder.records();
+        session.contract_mv = chip.contract_mv();
+        return session;
+    }
+
+    // Même suite d'appels, sans puce : toutes les réponses viennent de la capture
+    void replay_session(const Session &session, BusReplayer &replay, host::FakeBus &bus, StatusSnapshot &snapshot)
+    {
+        BusTap::install(&replay);
+        I2CDevices dev;
+        STUSB4500Manager manager(dev);
+        manager.init_device();
+        for (int64_t when : session.alerts_us)
+        {
+            host::advance_to(when);
+            manager.handle_alert();
+        }
+        BusTap::install(nullptr);
+        CHECK(manager.read_snapshot(snapshot));
+        CHECK_EQ(bus.counters().transactions(), 0u);
+    }
+} // namespace
+
+TEST_CASE(recorded_session_replays_without_chip)
+{
+    const Session session = record_session();
+    CHECK_EQ(session.contract_mv, 20000u);
+    CHECK(session.alerts_us.size() >= 3u);
+    CHECK(session.records > 10u);
+
+    // Aller-retour par fichier, comme une capture rapportée du terrain
+    std::FILE *file = std::tmpfile();
+    CHECK(file != nullptr);
+    CHECK_EQ(std::fwrite(session.capture.data(), 1, session.capture.size(), file), session.capture.size());
+    std::rewind(file);
+    std::vector<uint8_t> bytes(session.capture.size());
+    CHECK_EQ(std::fread(bytes.data(), 1, bytes.size(), file), bytes.size());
+    std::fclose(file);
+
+    host::reset();
+    host::FakeBus bus; // bus vide : une transaction qui l'atteindrait lirait des zéros
+    BusReplayer replay(bytes.data(), bytes.size());
+    CHECK(replay.valid());
+    StatusSnapshot snapshot;
+    replay_session(session, replay, bus, snapshot);
+
+    CHECK_EQ(replay.divergences(), 0u);
+    CHECK_EQ(replay.first_divergence(), -1);
+    CHECK(replay.finished());
+    CHECK_EQ(replay.replayed(), session.records);
+    CHECK(replay.recorded_us() > 0u);
+    CHECK_EQ(snapshot.active_voltage_mv, 20000u);
+}
+
+TEST_CASE(altered_write_is_reported_as_divergence)
+{
+    Session session = record_session();
+
+    // Premier enregistrement d'écriture : un octet écrit modifié
+    size_t offset = BusCapture::HEADER_SIZE;
+    uint32_t index = 0;
+    while (true)
+    {
+        const uint8_t *p = session.capture.data() + offset;
+        const bool write = p[4] & BusCapture::FLAG_WRITE;
+        const bool error = p[4] & BusCapture::FLAG_ERROR;
+        const size_t payload = (write || !error) ? p[6] : 0;
+        const size_t data_at = offset + BusCapture::RECORD_SIZE + (error ? 4 : 0);
+        if (write && payload > 0)
+        {
+            session.capture[data_at] ^= 0x01;
+            break;
+        }
+        offset = data_at + payload;
+        ++index;
+    }
+
+    host::reset();
+    host::FakeBus bus;
+    BusReplayer replay(session.capture.data(), session.capture.size());
+    StatusSnapshot snapshot;
+    replay_session(session, replay, bus, snapshot);
+    CHECK(replay.divergences() >= 1u);
+    CHECK_EQ(replay.first_divergence(), static_cast<int32_t>(index));
+}
+
+TEST_CASE(replay_beyond_capture_end_fails)
+{
+    // Capture réduite à son en-tête : toute transaction va au-delà de la fin
+    host::reset();
+    host::FakeBus bus;
+    uint8_t header[BusCapture::HEADER_SIZE];
+    BusRecorder empty(header, sizeof(header));
+    BusReplayer replay(empty.data(), empty.size());
+    CHECK(replay.valid());
+    BusTap::install(&replay);
+    I2CDevices dev;
+    INTERFACE io(dev);
+    uint8_t value = 0;
+    CHECK(io.read_register(0x2F, &value, 1) == ESP_ERR_NOT_FOUND);
+    BusTap::install(nullptr);
+    CHECK_EQ(replay.divergences(), 3u); // trois tentatives
+    CHECK_EQ(bus.counters().transactions(), 0u);
+
+    const uint8_t bad_header[BusCapture::HEADER_SIZE] = {'I', '2', 'C', 'R', 2, 0, 0, 0};
+    CHECK(!BusReplayer(bad_header, sizeof(bad_header)).valid());
+}
+
+TEST_MAIN()
@@ -0,0 +1,166 @@
+// Défauts I2C injectés : commandes non retentées, reprise NVM sous bruit, abandon borné de la resynchronisation.
+
+#include <cstdio>
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "nvm/stusb4500-nvm.hpp"
+#include "stusb4500-bus_fault.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr std::size_t NVM_KIND = static_cast<std::size_t>(RecoveryKind::Nvm);
+    constexpr std::size_t STATUS_KIND = static_cast<std::size_t>(RecoveryKind::Status);
+
+    // Pire durée de reprise NVM : 3 leave_ftp() de 2 écritures, chacune 3 essais espacés de 10 ms
+    constexpr uint32_t NVM_RECOVERY_BOUND_US = 3 * 2 * 3 * 10000 + 10000;
+
+    void print_histogram(const char *label, const MetricsSnapshot::Histogram &h)
+    {
+        std::printf("%-26s", label);
+        for (uint32_t count : h)
+            std::printf(" %6u", static_cast<unsigned>(count));
+        std::printf("\n");
+    }
+} // namespace
+
+TEST_CASE(command_writes_are_sent_once)
+{
+    host::reset();
+    host::ChipSim chip;
+    I2CDevices dev;
+    INTERFACE io(dev);
+
+    const uint8_t soft_reset = 0x26;
+    const uint8_t header = 0x0D;
+    const uint8_t ftp_req = 0x40 | 0x10;
+    const uint8_t ftp_reset = 0x40;
+    uint8_t pdo[4] = {0x2C, 0x91, 0x01, 0x00};
+    CHECK(!INTERFACE::idempotent(0x1A, &soft_reset, 1));
+    CHECK(!INTERFACE::idempotent(0x51, &header, 1));
+    CHECK(!INTERFACE::idempotent(0x96, &ftp_req, 1));
+    CHECK(INTERFACE::idempotent(0x96, &ftp_reset, 1));
+    CHECK(INTERFACE::idempotent(0x85, pdo, 4));
+
+    // Écriture appliquée mais ACK perdu : une commande n'est pas rejouée
+    chip.late_timeout_next = 1;
+    CHECK(io.write_register(0x51, &header, 1) == ESP_ERR_TIMEOUT);
+    CHECK_EQ(chip.counters().writes, 1u);
+    CHECK(io.write_register(0x1A, &soft_reset, 1) == ESP_OK);
+    CHECK_EQ(chip.soft_resets, 1u);
+
+    chip.reset_counters();
+    chip.late_timeout_next = 1;
+    CHECK(io.write_register(0x1A, &soft_reset, 1) == ESP_ERR_TIMEOUT);
+    CHECK_EQ(chip.counters().writes, 1u);
+    CHECK_EQ(chip.soft_resets, 2u);
+
+    // Registre de données : retenté, sans effet de bord
+    chip.reset_counters();
+    chip.late_timeout_next = 1;
+    CHECK_OK(io.write_register(0x85, pdo, 4));
+    CHECK_EQ(chip.counters().writes, 2u);
+}
+
+TEST_CASE(nvm_read_recovery_under_noise)
+{
+    const uint32_t levels_ppm[] = {50000, 200000};
+    std::printf("%-26s %6s %6s %6s %6s %6s %6s\n", "reprise NVM (us)", "<100", "<1k", "<10k", "<100k", "<1M", ">=1M");
+    for (uint32_t ppm : levels_ppm)
+    {
+        host::reset();
+        host::ChipSim chip;
+        host::load_kconfig(chip);
+        I2CDevices dev;
+        NVM nvm(dev);
+        Metrics::instance().reset();
+
+        BusFaultInjector::Settings noise;
+        noise.nack_ppm = ppm;
+        noise.reg_min = 0x53; // séquence FTP seulement
+        noise.seed = 0xC0FFEE;
+        BusFaultInjector injector(noise);
+        BusTap::install(&injector);
+
+        constexpr int READS = 500;
+        int failed = 0;
+        int unlocked = 0;
+        for (int i = 0; i < READS; ++i)
+        {
+            ConfigParams params;
+            NVMData data(params);
+            if (nvm.read(data) != ESP_OK)
+                ++failed;
+            if (chip.regs[host::ChipSim::FTP_KEY] != 0)
+                ++unlocked;
+        }
+        BusTap::install(nullptr);
+
+        const MetricsSnapshot m = Metrics::instance().snapshot();
+        char label[32];
+        std::snprintf(label, sizeof(label), "NACK %u %%", static_cast<unsigned>(ppm / 10000));
+        print_histogram(label, m.recovery_duration[NVM_KIND]);
+        std::printf("%-26s %d échecs / %d lectures, reprise max %u us\n", "", failed, READS,
+                    static_cast<unsigned>(m.recovery_max_us[NVM_KIND]));
+
+        // Chaque lecture en échec est suivie d'une reprise ; la clé n'est restée ouverte que si la reprise a échoué
+        CHECK(injector.stats().nacks > 0u);
+        CHECK_EQ(m.recoveries[NVM_KIND], static_cast<uint32_t>(failed));
+        CHECK_EQ(static_cast<uint32_t>(unlocked), m.recovery_failures[NVM_KIND]);
+        CHECK(m.recovery_max_us[NVM_KIND] <= NVM_RECOVERY_BOUND_US);
+    }
+}
+
+TEST_CASE(status_resync_gives_up_at_deadline)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    manager.init();
+    host::run_task_for(100000);
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+    host::run_task_for(1000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK(!manager.watchdog().armed());
+    Metrics::instance().reset();
+
+    // ALERT_STATUS_1 reste lisible (la broche remonte), tous les registres d'état sont perdus
+    BusFaultInjector::Settings settings;
+    settings.reg_min = 0x0D;
+    BusFaultInjector injector(settings);
+    BusTap::install(&injector);
+    injector.stick(3000000);
+    const int64_t fault_us = host::now_us();
+    chip.detach();
+    host::run_task_for(900000);
+    MetricsSnapshot m = Metrics::instance().snapshot();
+    CHECK_EQ(m.recoveries[STATUS_KIND], 0u);
+
+    // Délai dépassé : un seul échec compté, puis plus aucune transaction jusqu'à la prochaine alerte
+    host::run_task_for(fault_us + 1200000 - host::now_us());
+    m = Metrics::instance().snapshot();
+    CHECK_EQ(m.recoveries[STATUS_KIND], 1u);
+    CHECK_EQ(m.recovery_failures[STATUS_KIND], 1u);
+    CHECK(m.recovery_max_us[STATUS_KIND] >= 1000000u);
+    CHECK(m.recovery_max_us[STATUS_KIND] < 1100000u);
+    const uint32_t transactions = injector.stats().transactions;
+    host::run_task_for(2500000);
+    CHECK_EQ(injector.stats().transactions, transactions);
+    CHECK_EQ(Metrics::instance().snapshot().recoveries[STATUS_KIND], 1u);
+
+    // Bus rétabli : la prochaine alerte resynchronise l'état complet
+    BusTap::install(nullptr);
+    chip.attach({host::ChipSim::fixed(5000, 3000)});
+    host::run_task_for(1000000);
+    CHECK_EQ(chip.contract_mv(), 5000u);
+    StatusSnapshot snapshot;
+    CHECK(manager.read_snapshot(snapshot));
+    CHECK_EQ(snapshot.active_voltage_mv, 5000u);
+}
+
+TEST_MAIN()
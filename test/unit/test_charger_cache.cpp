@@ -0,0 +1,228 @@
+// Cache des chargeurs connus : persistance, compatibilité du blob stocké, contexte de configuration et sauvegarde
+// depuis la tâche (chemin rapide à l'attachement : test_fast_path.cpp).
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config_macro.hpp"
+#include "memory_store.hpp"
+#include "pd/stusb4500-charger_cache.hpp"
+#include "storage/stusb4500-profile_store.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    const std::vector<uint32_t> CHARGER_A{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 3000),
+                                          host::ChipSim::fixed(15000, 3000), host::ChipSim::fixed(20000, 3000)};
+    const std::vector<uint32_t> CHARGER_B{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 2000),
+                                          host::ChipSim::fixed(15000, 2000), host::ChipSim::fixed(20000, 2250)};
+
+    PowerProfile table_of(uint16_t pdo1_ma, uint16_t pdo3_mv)
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, pdo1_ma};
+        power.pdos[1] = {9000, 1000};
+        power.pdos[2] = {pdo3_mv, 1000};
+        return power;
+    }
+
+    // Contexte du cache sous la table Kconfig, sans profil actif
+    uint32_t kconfig_context()
+    {
+        return ChargerCache::context_of(load_config_from_kconfig().power_);
+    }
+
+    constexpr const char *STORE_KEY = "chg_cache";
+    constexpr std::size_t ENTRY_SIZE = 4 + 4 + 3 * 4 + 1 + 4;
+} // namespace
+
+TEST_CASE(save_and_load_round_trip)
+{
+    host::MemoryStore store;
+    ChargerCache cache;
+    CHECK(cache.remember(0x1234, table_of(1000, 20000), 0x4304B12C));
+    CHECK(cache.remember(0x5678, table_of(1500, 15000), 0x3304B12C));
+    CHECK(cache.dirty());
+    CHECK_OK(cache.save(store));
+    CHECK(!cache.dirty());
+
+    ChargerCache loaded;
+    CHECK_OK(loaded.load(store));
+    CHECK_EQ(loaded.size(), 2u);
+    const ChargerEntry *entry = loaded.find(0x1234);
+    CHECK(entry != nullptr);
+    CHECK_EQ(entry->rdo, 0x4304B12Cu);
+    PowerProfile power;
+    entry->to_profile(power);
+    CHECK_EQ(power.pdos[2].voltage_mv, 20000);
+    CHECK(loaded.most_recent() == entry);
+}
+
+TEST_CASE(larger_cache_blob_is_discarded)
+{
+    // Blob écrit par un firmware configuré avec 8 entrées : plus grand que le buffer de lecture
+    host::MemoryStore store;
+    std::vector<uint8_t> blob(2 + 8 * ENTRY_SIZE, 0xA5);
+    blob[0] = 1;
+    blob[1] = 8;
+    store.blobs[STORE_KEY] = blob;
+
+    ChargerCache cache;
+    CHECK(cache.load(store) == ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(cache.size(), 0u);
+
+    // Le manager démarre avec un cache vide au lieu d'échouer
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.set_store(&store));
+    CHECK_EQ(manager.known_chargers().size(), 0u);
+}
+
+TEST_CASE(configuration_change_forgets_all_chargers)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    host::MemoryStore store;
+    CHECK_OK(ProfileStore(store).save("p15", table_of(1000, 15000)));
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.set_store(&store));
+    CHECK_OK(manager.init_device());
+
+    for (const auto *source : {&CHARGER_A, &CHARGER_B})
+    {
+        chip.attach(*source);
+        host::run_alerts_until(manager, host::now_us() + 2000000);
+        chip.detach();
+        host::run_alerts_until(manager, host::now_us() + 100000);
+    }
+    CHECK_EQ(manager.known_chargers().size(), 2u);
+
+    // Profil changé port vide : aucune table retenue sous le Kconfig ne doit revenir pour A ni pour B
+    CHECK_OK(manager.switch_profile("p15"));
+    CHECK_EQ(manager.known_chargers().size(), 0u);
+    CHECK(manager.known_chargers().dirty());
+    chip.attach(CHARGER_B);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 15000u);
+    CHECK_EQ(chip.soft_resets, 1u); // celui de switch_profile(), port vide
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+}
+
+TEST_CASE(cache_saved_under_other_configuration_is_ignored)
+{
+    // A retenu sous la table Kconfig ; au démarrage suivant, le profil actif change la table configurée
+    host::MemoryStore store;
+    const uint32_t fingerprint_a = ChargerCache::fingerprint(CHARGER_A.data(), CHARGER_A.size());
+    {
+        ChargerCache seed;
+        seed.set_context(kconfig_context());
+        seed.remember(fingerprint_a, table_of(1000, 20000), 0);
+        CHECK_OK(seed.save(store));
+    }
+    ProfileStore profiles(store);
+    CHECK_OK(profiles.save("p15", table_of(1000, 15000)));
+    CHECK_OK(profiles.set_active("p15"));
+
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.set_store(&store));
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+    CHECK_OK(manager.init_device());
+    CHECK_EQ(manager.known_chargers().size(), 0u);
+    CHECK_EQ(manager.known_chargers().context(), ChargerCache::context_of(table_of(1000, 15000)));
+
+    // Blob relu par un cache au contexte déjà connu : repris s'il est le même, ignoré sinon
+    {
+        ChargerCache seed;
+        seed.set_context(kconfig_context());
+        seed.remember(fingerprint_a, table_of(1000, 20000), 0);
+        CHECK_OK(seed.save(store));
+    }
+    ChargerCache same;
+    same.set_context(kconfig_context());
+    CHECK_OK(same.load(store));
+    CHECK_EQ(same.size(), 1u);
+    ChargerCache other;
+    other.set_context(ChargerCache::context_of(table_of(1000, 15000)));
+    CHECK_OK(other.load(store));
+    CHECK_EQ(other.size(), 0u);
+}
+
+TEST_CASE(load_profile_change_reaches_known_charger)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    LoadProfile load;
+    load.max_current_ma = 1000;
+    manager.set_load_profile(load);
+
+    chip.attach(CHARGER_A);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+    chip.detach();
+    host::run_alerts_until(manager, host::now_us() + 100000);
+
+    // Même profil : entrée conservée ; profil plafonné à 9 V : la table retenue pour A ne doit plus gagner
+    manager.set_load_profile(load);
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+    load.max_voltage_mv = 9000;
+    manager.set_load_profile(load);
+    CHECK_EQ(manager.known_chargers().size(), 0u);
+    chip.attach(CHARGER_A);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 9000u);
+}
+
+TEST_CASE(cache_is_saved_from_task_loop)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    host::MemoryStore store;
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    CHECK_OK(manager.set_store(&store));
+    LoadProfile load;
+    load.max_current_ma = 1000;
+    manager.set_load_profile(load);
+
+    // Traitement d'alerte seul : le chargeur est retenu en RAM, rien n'est écrit en NVS
+    chip.attach(CHARGER_A);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+    CHECK(manager.known_chargers().dirty());
+    CHECK_EQ(store.sets, 0u);
+
+    // La boucle de la tâche écrit le cache une fois, puis plus rien tant qu'il ne change pas
+    manager.init();
+    host::run_task_for(1500000);
+    CHECK(!manager.known_chargers().dirty());
+    CHECK_EQ(store.sets, 1u);
+    chip.resend_caps(CHARGER_A);
+    host::run_task_for(1000000);
+    CHECK_EQ(store.sets, 1u);
+
+    ChargerCache reloaded;
+    CHECK_OK(reloaded.load(store));
+    CHECK_EQ(reloaded.size(), 1u);
+    CHECK_EQ(reloaded.most_recent()->rdo, chip.rdo());
+}
+
+TEST_MAIN()
@@ -0,0 +1,166 @@
+// Patch de configuration : écritures minimales, ordonnées et coalescées, comptées sur le bus simulé.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config_macro.hpp"
+#include "config/stusb4500-config_patch.hpp"
+#include "pd/stusb4500-pdo.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    // Configuration lue sur la puce, comme le fait apply_config()
+    ConfigParams chip_config(I2CDevices &dev)
+    {
+        ConfigParams current = load_config_from_kconfig();
+        CHECK_OK(ConfigPatch(dev).read_current(current));
+        return current;
+    }
+
+    uint32_t apply_and_count(host::ChipSim &chip, ConfigPatch &patch)
+    {
+        chip.reset_counters();
+        CHECK_OK(patch.apply());
+        return chip.counters().transactions();
+    }
+} // namespace
+
+TEST_CASE(identical_target_costs_no_write)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+
+    chip.reset_counters();
+    const ConfigParams current = chip_config(dev);
+    // Relecture : table des PDO (nombre et rafale de 12 octets) puis masque d'alerte
+    CHECK_EQ(chip.counters().writes, 0u);
+    const uint32_t read_cost = chip.counters().reads;
+    CHECK(read_cost <= 3u);
+
+    ConfigPatch patch(dev);
+    patch.compute(current, current);
+    CHECK(patch.empty());
+    CHECK(!patch.needs_renegotiation());
+    CHECK(!patch.needs_nvm());
+    CHECK_EQ(apply_and_count(chip, patch), 0u);
+}
+
+TEST_CASE(mask_pdo_and_count_in_three_ordered_writes)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    const ConfigParams current = chip_config(dev);
+
+    ConfigParams target = current;
+    target.alert_mask.set_raw(current.alert_mask.get_raw() ^ 0x02);
+    target.power_.pdos[1] = {9000, current.power_.pdos[1].current_ma};
+    target.power_.pdo_number = 2;
+
+    ConfigPatch patch(dev);
+    patch.compute(current, target);
+    CHECK_EQ(patch.size(), 3u);
+    CHECK(patch.needs_renegotiation());
+    CHECK(!patch.needs_nvm());
+
+    chip.keep_log = true;
+    CHECK_EQ(apply_and_count(chip, patch), 3u);
+    const auto &log = chip.transactions();
+    CHECK_EQ(log.size(), 3u);
+    CHECK_EQ(log[0].reg, host::ChipSim::ALERT_MASK);
+    CHECK_EQ(log[1].reg, host::ChipSim::SINK_PDO1 + PDOTable::pdo_len);
+    CHECK_EQ(log[1].data.size(), static_cast<size_t>(PDOTable::pdo_len));
+    CHECK_EQ(log[2].reg, host::ChipSim::PDO_NUMBER);
+    CHECK_EQ(chip.sink_pdo(1), host::ChipSim::fixed(9000, current.power_.pdos[1].current_ma));
+    CHECK_EQ(chip.sink_pdo_count(), 2);
+    CHECK_EQ(chip.regs[host::ChipSim::ALERT_MASK], target.alert_mask.get_raw());
+}
+
+TEST_CASE(first_and_last_pdo_coalesced_into_one_burst)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    const ConfigParams current = chip_config(dev);
+
+    ConfigParams target = current;
+    target.power_.pdos[0].current_ma = 3000;
+    target.power_.pdos[2].voltage_mv = 12000;
+
+    ConfigPatch patch(dev);
+    patch.compute(current, target);
+    CHECK_EQ(patch.size(), 1u);
+    CHECK_EQ(patch[0].reg, PDOTable::base_reg_addr);
+    CHECK_EQ(patch[0].len, PDOTable::table_len);
+
+    chip.reset_counters();
+    CHECK_OK(patch.apply());
+    CHECK_EQ(chip.counters().writes, 1u);
+    CHECK_EQ(chip.counters().write_bytes, static_cast<uint32_t>(PDOTable::table_len));
+    CHECK_EQ(chip.counters().reads, 0u);
+    CHECK_EQ(host::ChipSim::sink_mv(chip.sink_pdo(2)), 12000u);
+}
+
+TEST_CASE(nvm_only_field_writes_nothing)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    const ConfigParams current = chip_config(dev);
+
+    ConfigParams target = current;
+    target.power_.flex_current_ma = current.power_.flex_current_ma + 500;
+    target.discharge_.time_to_pdo = current.discharge_.time_to_pdo + 1;
+
+    ConfigPatch patch(dev);
+    patch.compute(current, target);
+    CHECK(patch.empty());
+    CHECK(patch.needs_nvm());
+    CHECK(!patch.needs_renegotiation());
+    CHECK_EQ(apply_and_count(chip, patch), 0u);
+}
+
+TEST_CASE(manager_apply_config_counts_patch_and_soft_reset)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+
+    // Cible déjà en place : relectures seulement
+    const ConfigParams kconfig = load_config_from_kconfig();
+    chip.reset_counters();
+    CHECK_OK(manager.apply_config(kconfig));
+    CHECK_EQ(chip.counters().writes, 0u);
+    CHECK_EQ(chip.soft_resets, 0u);
+
+    // Un PDO modifié : une rafale, puis le soft reset (TX_HEADER_LOW et PD_COMMAND_CTRL)
+    ConfigParams target = kconfig;
+    target.power_.pdos[2].voltage_mv = 12000;
+    chip.keep_log = true;
+    chip.reset_counters();
+    CHECK_OK(manager.apply_config(target));
+    CHECK_EQ(chip.counters().writes, 3u);
+    uint8_t written[3] = {0};
+    size_t n = 0;
+    for (const auto &t : chip.transactions())
+    {
+        if (t.write && n < 3)
+            written[n++] = t.reg;
+    }
+    CHECK_EQ(written[0], host::ChipSim::SINK_PDO1 + 2 * PDOTable::pdo_len);
+    CHECK_EQ(written[1], host::ChipSim::TX_HEADER_LOW);
+    CHECK_EQ(written[2], host::ChipSim::PD_COMMAND_CTRL);
+    CHECK_EQ(chip.soft_resets, 1u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,132 @@
+// Chemin rapide à l'attachement : table d'un chargeur connu anticipée, pari gagné ou perdu sur source simulée.
+
+#include <cstdio>
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config_macro.hpp"
+#include "memory_store.hpp"
+#include "pd/stusb4500-charger_cache.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    const std::vector<uint32_t> CHARGER_A{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 3000),
+                                          host::ChipSim::fixed(15000, 3000), host::ChipSim::fixed(20000, 3000)};
+    const std::vector<uint32_t> CHARGER_B{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 2000),
+                                          host::ChipSim::fixed(15000, 2000), host::ChipSim::fixed(20000, 2250)};
+
+    PowerProfile table_of(uint16_t pdo1_ma, uint16_t pdo3_mv)
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, pdo1_ma};
+        power.pdos[1] = {9000, 1000};
+        power.pdos[2] = {pdo3_mv, 1000};
+        return power;
+    }
+
+    // Table Kconfig du stub sdkconfig, telle qu'écrite dans les registres 0x85-0x91
+    void check_kconfig_table(host::ChipSim &chip)
+    {
+        const PowerProfile kconfig = load_config_from_kconfig().power_;
+        CHECK_EQ(chip.sink_pdo_count(), kconfig.pdo_number);
+        for (size_t i = 0; i < kconfig.pdos.size(); ++i)
+            CHECK_EQ(chip.sink_pdo(i), kconfig.encode(i));
+    }
+
+    // Cache où A est retenu avec une table 20 V 1 A / PDO1 1 A, sous la table Kconfig
+    void seed_charger_a(host::MemoryStore &store)
+    {
+        ChargerCache seed;
+        seed.set_context(ChargerCache::context_of(load_config_from_kconfig().power_));
+        seed.remember(ChargerCache::fingerprint(CHARGER_A.data(), CHARGER_A.size()), table_of(1000, 20000), 0);
+        CHECK_OK(seed.save(store));
+    }
+} // namespace
+
+TEST_CASE(fast_path_miss_restores_configured_table)
+{
+    // A connu avec une table différente du Kconfig
+    host::MemoryStore store;
+    seed_charger_a(store);
+
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.set_store(&store));
+    CHECK_OK(manager.init_device());
+
+    // B branché : la table de A est anticipée, B n'est ni connu ni soumis à une politique
+    chip.attach(CHARGER_B);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK(chip.contract_mv() != 0);
+    CHECK_EQ(chip.soft_resets, 1u);
+    check_kconfig_table(chip);
+
+    // B retenu avec la table Kconfig, l'entrée de A intacte
+    const uint32_t fingerprint_b = ChargerCache::fingerprint(CHARGER_B.data(), CHARGER_B.size());
+    CHECK_EQ(manager.known_chargers().size(), 2u);
+    const ChargerEntry *entry = manager.known_chargers().most_recent();
+    CHECK(entry != nullptr);
+    CHECK_EQ(entry->fingerprint, fingerprint_b);
+    CHECK_EQ(entry->rdo, chip.rdo());
+    PowerProfile power;
+    entry->to_profile(power);
+    CHECK_EQ(power.pdos[1].voltage_mv, load_config_from_kconfig().power_.pdos[1].voltage_mv);
+}
+
+TEST_CASE(fast_path_timing_on_simulated_source)
+{
+    host::MemoryStore store;
+    seed_charger_a(store);
+
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.set_store(&store));
+    CHECK_OK(manager.init_device());
+    Metrics::instance().reset();
+    const host::ChipSim::Timing &timing = chip.timing;
+
+    // Pari gagné : contrat définitif dès la première négociation
+    chip.attach(CHARGER_A);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(chip.soft_resets, 0u);
+    CHECK_EQ(chip.sink_pdo(0), host::ChipSim::fixed(5000, 1000));
+    MetricsSnapshot m = Metrics::instance().snapshot();
+    CHECK_EQ(m.fast_path_hits, 1u);
+    const uint32_t hit_us = m.attach_to_contract_last_us;
+    // Capacités, Accept, transition 5 -> 20 V, plus le traitement des alertes
+    const int64_t one_negotiation_us = timing.first_caps_us + timing.accept_us + 15 * timing.us_per_volt;
+    CHECK(hit_us >= one_negotiation_us);
+    CHECK(hit_us < one_negotiation_us + 10000);
+
+    // Détachement : la table de A ne reste pas en place
+    chip.detach();
+    host::run_alerts_until(manager, host::now_us() + 100000);
+    check_kconfig_table(chip);
+
+    // Pari perdu : une renégociation de plus sur la table configurée
+    chip.attach(CHARGER_B);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(chip.soft_resets, 1u);
+    m = Metrics::instance().snapshot();
+    CHECK_EQ(m.fast_path_misses, 1u);
+    CHECK_EQ(m.attach_contracts, 2u);
+    const uint32_t miss_us = m.attach_to_contract_last_us;
+    // Soft reset envoyé dès les capacités de B : leur délai de renvoi s'ajoute à la négociation
+    CHECK(miss_us >= hit_us + timing.soft_reset_caps_us);
+    std::printf("attachement -> contrat : pari gagné %u us, pari perdu %u us\n", static_cast<unsigned>(hit_us),
+                static_cast<unsigned>(miss_us));
+}
+
+TEST_MAIN()
@@ -0,0 +1,280 @@
+// Descripteurs déclaratifs (Field/NvmField) contre les décodeurs écrits à la main
+// qu'ils remplacent : équivalence bit à bit puis coût par opération.
+
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#include "check.hpp"
+#include "nvm/stusb4500-banks.hpp"
+#include "pd/stusb4500-rdo.hpp"
+#include "stusb4500-common_types.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    // === Référence : codecs d'origine, masques et décalages écrits à la main ===
+    namespace ref
+    {
+        uint8_t low4(uint8_t v) { return v & 0x0F; }
+        uint8_t high4(uint8_t v) { return (v >> 4) & 0x0F; }
+        uint8_t pack4(uint8_t low, uint8_t high) { return (low & 0x0F) | ((high & 0x0F) << 4); }
+
+        void decode_pdo(PowerProfile &p, uint32_t raw, size_t index)
+        {
+            p.pdos[index].voltage_mv = ((raw >> 10) & 0x3FF) * 50;
+            p.pdos[index].current_ma = (raw & 0x3FF) * 10;
+            // Drapeaux du PDO1 seulement (le code d'origine les lisait aussi dans PDO2/PDO3)
+            if (index != 0)
+                return;
+            p.dual_role_power = raw & (1 << 29);
+            p.higher_capability = raw & (1 << 28);
+            p.unconstrained_power = raw & (1 << 27);
+            p.usb_comm_capable = raw & (1 << 26);
+            p.frs = static_cast<FastRoleSwap>((raw >> 23) & 0x03);
+        }
+
+        uint32_t encode_pdo(const PowerProfile &p, size_t index)
+        {
+            uint32_t raw = 0;
+            if (index == 0)
+            {
+                if (p.dual_role_power)
+                    raw |= 1 << 29;
+                if (p.higher_capability)
+                    raw |= 1 << 28;
+                if (p.unconstrained_power)
+                    raw |= 1 << 27;
+                if (p.usb_comm_capable)
+                    raw |= 1 << 26;
+                raw |= (static_cast<uint32_t>(p.frs) & 0x03) << 23;
+            }
+            raw |= (static_cast<uint32_t>(p.pdos[index].voltage_mv / 50) & 0x3FF) << 10;
+            raw |= static_cast<uint32_t>(p.pdos[index].current_ma / 10) & 0x3FF;
+            return raw;
+        }
+
+        void decode_nvm(ConfigParams &d, const uint8_t *nvm)
+        {
+            const uint8_t *b1 = nvm + 8;
+            d.gpio_function = static_cast<ConfigParams::GPIOFunction>((b1[0] >> 4) & 0x03);
+            d.discharge_.time_to_pdo = low4(b1[2]);
+            d.discharge_.time_to_0v = high4(b1[2]);
+
+            const uint8_t *b3 = nvm + 24;
+            auto &p = d.power_;
+            p.usb_comm_capable = b3[2] & 0x01;
+            p.pdo_number = (b3[2] >> 1) & 0x03;
+            p.unconstrained_power = (b3[2] >> 3) & 0x01;
+            p.pdos[0].current_ma = decode_lup_current(high4(b3[2]));
+            p.pdos[0].vbus_monitor.lower_percent = low4(b3[3]);
+            p.pdos[0].vbus_monitor.upper_percent = high4(b3[3]);
+            p.pdos[1].current_ma = decode_lup_current(low4(b3[4]));
+            p.pdos[1].vbus_monitor.lower_percent = high4(b3[4]);
+            p.pdos[1].vbus_monitor.upper_percent = low4(b3[5]);
+            p.pdos[2].current_ma = decode_lup_current(high4(b3[5]));
+            p.pdos[2].vbus_monitor.lower_percent = low4(b3[6]);
+            p.pdos[2].vbus_monitor.upper_percent = high4(b3[6]);
+
+            const uint8_t *b4 = nvm + 32;
+            p.pdos[1].voltage_mv = (((b4[0] >> 6) & 0x03) | (b4[1] << 2)) * 50;
+            p.pdos[2].voltage_mv = ((b4[2] | ((b4[3] & 0x03) << 8))) * 50;
+            p.flex_current_ma = (((b4[3] >> 2) & 0x3F) | ((b4[4] & 0x0F) << 6)) * 10;
+            d.power_ok = static_cast<ConfigParams::PowerOkConfig>((b4[4] >> 5) & 0x03);
+            d.req_src_current = (b4[6] >> 4) & 0x01;
+            d.alert_mask.set_raw(b4[7]);
+        }
+
+        void encode_nvm(const ConfigParams &d, uint8_t *nvm)
+        {
+            uint8_t *b1 = nvm + 8;
+            b1[0] = (b1[0] & 0xCF) | ((static_cast<uint8_t>(d.gpio_function) & 0x03) << 4);
+            b1[2] = pack4(d.discharge_.time_to_pdo, d.discharge_.time_to_0v);
+
+            uint8_t *b3 = nvm + 24;
+            const auto &p = d.power_;
+            b3[2] = (p.usb_comm_capable & 0x01) | ((p.pdo_number & 0x03) << 1) | ((p.unconstrained_power & 0x01) << 3) |
+                    ((encode_lup_current(p.pdos[0].current_ma) & 0x0F) << 4);
+            b3[3] = pack4(p.pdos[0].vbus_monitor.lower_percent, p.pdos[0].vbus_monitor.upper_percent);
+            b3[4] = pack4(encode_lup_current(p.pdos[1].current_ma), p.pdos[1].vbus_monitor.lower_percent);
+            b3[5] = pack4(p.pdos[1].vbus_monitor.upper_percent, encode_lup_current(p.pdos[2].current_ma));
+            b3[6] = pack4(p.pdos[2].vbus_monitor.lower_percent, p.pdos[2].vbus_monitor.upper_percent);
+
+            uint8_t *b4 = nvm + 32;
+            const uint16_t v2 = p.pdos[1].voltage_mv / 50;
+            const uint16_t v3 = p.pdos[2].voltage_mv / 50;
+            const uint16_t flex = p.flex_current_ma / 10;
+            b4[0] = (b4[0] & 0x3F) | ((v2 & 0x03) << 6);
+            b4[1] = (v2 >> 2) & 0xFF;
+            b4[2] = v3 & 0xFF;
+            b4[3] = ((v3 >> 8) & 0x03) | ((flex & 0x3F) << 2);
+            // Effaçait aussi les bits 4 et 7, que le codec déclaratif conserve
+            b4[4] = (b4[4] & 0x90) | ((flex >> 6) & 0x0F) | ((static_cast<uint8_t>(d.power_ok) & 0x03) << 5);
+            b4[6] = (b4[6] & 0xEF) | ((d.req_src_current & 0x01) << 4);
+        }
+    } // namespace ref
+
+    bool same_config(const ConfigParams &a, const ConfigParams &b)
+    {
+        bool same = a.gpio_function == b.gpio_function && a.discharge_.time_to_pdo == b.discharge_.time_to_pdo &&
+                    a.discharge_.time_to_0v == b.discharge_.time_to_0v && a.power_ok == b.power_ok &&
+                    a.req_src_current == b.req_src_current && a.alert_mask.get_raw() == b.alert_mask.get_raw() &&
+                    a.power_.usb_comm_capable == b.power_.usb_comm_capable &&
+                    a.power_.pdo_number == b.power_.pdo_number &&
+                    a.power_.unconstrained_power == b.power_.unconstrained_power &&
+                    a.power_.flex_current_ma == b.power_.flex_current_ma;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            same = same && a.power_.pdos[i].current_ma == b.power_.pdos[i].current_ma &&
+                   a.power_.pdos[i].voltage_mv == b.power_.pdos[i].voltage_mv &&
+                   a.power_.pdos[i].vbus_monitor.lower_percent == b.power_.pdos[i].vbus_monitor.lower_percent &&
+                   a.power_.pdos[i].vbus_monitor.upper_percent == b.power_.pdos[i].vbus_monitor.upper_percent;
+        }
+        return same;
+    }
+
+    bool same_pdo(const PowerProfile &a, const PowerProfile &b, size_t i)
+    {
+        return a.pdos[i].voltage_mv == b.pdos[i].voltage_mv && a.pdos[i].current_ma == b.pdos[i].current_ma &&
+               a.dual_role_power == b.dual_role_power && a.higher_capability == b.higher_capability &&
+               a.unconstrained_power == b.unconstrained_power && a.usb_comm_capable == b.usb_comm_capable &&
+               a.frs == b.frs;
+    }
+
+    ConfigParams random_config(std::mt19937 &rng)
+    {
+        auto bits = [&](int n) { return static_cast<uint8_t>(rng() & ((1u << n) - 1)); };
+        ConfigParams d;
+        d.gpio_function = static_cast<ConfigParams::GPIOFunction>(bits(2));
+        d.discharge_.time_to_pdo = bits(4);
+        d.discharge_.time_to_0v = bits(4);
+        d.power_ok = static_cast<ConfigParams::PowerOkConfig>(bits(2));
+        d.req_src_current = bits(1);
+        d.power_.usb_comm_capable = bits(1);
+        d.power_.pdo_number = bits(2);
+        d.power_.unconstrained_power = bits(1);
+        d.power_.flex_current_ma = static_cast<uint16_t>((rng() & 0x3FF) * 10);
+        for (auto &pdo : d.power_.pdos)
+        {
+            pdo.current_ma = lup_current_table[bits(4)];
+            pdo.voltage_mv = static_cast<uint16_t>((rng() & 0x3FF) * 50);
+            pdo.vbus_monitor = {bits(4), bits(4)};
+        }
+        return d;
+    }
+
+    template <typename Fn>
+    double ns_per_op(size_t iterations, Fn &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            fn(i);
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+    }
+
+    constexpr size_t RANDOM_CASES = 200000;
+} // namespace
+
+TEST_CASE(pdo_codec_matches_hand_written)
+{
+    std::mt19937 rng(29);
+    for (size_t n = 0; n < RANDOM_CASES; ++n)
+    {
+        const uint32_t raw = rng();
+        const size_t index = n % 3;
+        PowerProfile generated, reference;
+        generated.decode(raw, index);
+        ref::decode_pdo(reference, raw, index);
+        CHECK(same_pdo(generated, reference, index));
+        CHECK_EQ(generated.encode(index), ref::encode_pdo(reference, index));
+    }
+}
+
+TEST_CASE(rdo_accessors_match_hand_written)
+{
+    std::mt19937 rng(30);
+    I2CDevices dev;
+    RDO rdo(dev);
+    for (size_t n = 0; n < RANDOM_CASES; ++n)
+    {
+        uint8_t buf[4];
+        const uint32_t raw = rng();
+        store_le32(raw, buf);
+        rdo.decode(buf, sizeof(buf));
+        CHECK_EQ(rdo.obj_position(), (raw >> 28) & 0x07);
+        CHECK_EQ(rdo.operating_ma(), ((raw >> 10) & 0x3FF) * 10);
+        CHECK_EQ(rdo.max_operating_ma(), (raw & 0x3FF) * 10);
+        CHECK_EQ(rdo.encode(), raw);
+    }
+}
+
+TEST_CASE(nvm_layout_matches_hand_written)
+{
+    std::mt19937 rng(31);
+    for (size_t n = 0; n < RANDOM_CASES; ++n)
+    {
+        uint8_t image[NVMLayout::size];
+        for (uint8_t &b : image)
+            b = static_cast<uint8_t>(rng());
+
+        ConfigParams generated, reference;
+        NVMLayout::decode(generated, image);
+        ref::decode_nvm(reference, image);
+        CHECK(same_config(generated, reference));
+
+        const ConfigParams config = random_config(rng);
+        uint8_t encoded[NVMLayout::size], expected[NVMLayout::size];
+        std::memcpy(encoded, image, sizeof(image));
+        std::memcpy(expected, image, sizeof(image));
+        NVMLayout::encode(config, encoded);
+        ref::encode_nvm(config, expected);
+        CHECK(std::memcmp(encoded, expected, sizeof(encoded)) == 0);
+    }
+}
+
+TEST_CASE(benchmark_generated_against_hand_written)
+{
+    constexpr size_t ITERATIONS = 2000000;
+    std::mt19937 rng(32);
+    std::vector<uint32_t> raws(4096);
+    for (uint32_t &r : raws)
+        r = rng();
+    std::vector<uint8_t> images(4096 * 8);
+    for (uint8_t &b : images)
+        b = static_cast<uint8_t>(rng());
+
+    volatile uint32_t sink = 0;
+    PowerProfile profile;
+    const double pdo_generated = ns_per_op(ITERATIONS, [&](size_t i) {
+        profile.decode(raws[i & 4095], i % 3);
+        sink = sink + profile.encode(i % 3);
+    });
+    const double pdo_reference = ns_per_op(ITERATIONS, [&](size_t i) {
+        ref::decode_pdo(profile, raws[i & 4095], i % 3);
+        sink = sink + ref::encode_pdo(profile, i % 3);
+    });
+
+    ConfigParams config;
+    uint8_t out[NVMLayout::size] = {};
+    const double nvm_generated = ns_per_op(ITERATIONS / 8, [&](size_t i) {
+        NVMLayout::decode(config, &images[(i & 511) * 64]);
+        NVMLayout::encode(config, out);
+        sink = sink + out[26];
+    });
+    const double nvm_reference = ns_per_op(ITERATIONS / 8, [&](size_t i) {
+        ref::decode_nvm(config, &images[(i & 511) * 64]);
+        ref::encode_nvm(config, out);
+        sink = sink + out[26];
+    });
+
+    // Mesure indicative (dépend du niveau d'optimisation) : seule l'équivalence est vérifiée
+    std::printf("PDO decode+encode : descripteurs %.1f ns/op, écrit à la main %.1f ns/op\n", pdo_generated,
+                pdo_reference);
+    std::printf("NVM decode+encode : descripteurs %.1f ns/op, écrit à la main %.1f ns/op\n", nvm_generated,
+                nvm_reference);
+    CHECK(pdo_generated > 0 && nvm_generated > 0);
+}
+
+TEST_MAIN()
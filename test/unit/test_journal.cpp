@@ -0,0 +1,163 @@
+// Journal d'événements sur une FileRegion (NOR simulée) : reprise au montage, écritures interrompues, pas de réécriture sans effacement.
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "file_region.hpp"
+#include "host_platform.hpp"
+#include "storage/stusb4500-journal.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr size_t SECTOR = 256; // 16 enregistrements
+    constexpr size_t REGION = 4 * SECTOR;
+
+    std::string fresh_path(const char *name)
+    {
+        const std::string path = std::string("journal_") + name + ".bin";
+        std::remove(path.c_str());
+        return path;
+    }
+
+    // Enregistrements valides de la zone, dans l'ordre des offsets
+    std::vector<JournalRecord> scan(host::FileRegion &region)
+    {
+        std::vector<JournalRecord> records;
+        uint8_t raw[JournalRecord::SIZE];
+        for (size_t offset = 0; offset < region.size(); offset += JournalRecord::SIZE)
+        {
+            JournalRecord rec;
+            CHECK_OK(region.read(offset, raw, sizeof(raw)));
+            if (rec.decode(raw) && rec.sequence != 0xFFFFFFFF)
+                records.push_back(rec);
+        }
+        return records;
+    }
+
+    // Chaque séquence 1..last exactement une fois, arg32 = séquence attendue
+    void check_complete(host::FileRegion &region, uint32_t last)
+    {
+        std::set<uint32_t> seen;
+        for (const JournalRecord &rec : scan(region))
+        {
+            CHECK(seen.insert(rec.sequence).second);
+            CHECK_EQ(rec.arg32, rec.sequence);
+        }
+        CHECK_EQ(seen.size(), static_cast<size_t>(last));
+        CHECK_EQ(*seen.rbegin(), last);
+    }
+
+    void record_n(EventJournal &journal, uint32_t &next, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i, ++next)
+            journal.record(JournalEvent::Contract, 1, next);
+    }
+} // namespace
+
+TEST_CASE(flush_and_remount)
+{
+    host::reset();
+    host::FileRegion region(fresh_path("remount"), REGION, SECTOR);
+    CHECK(region.is_open());
+    uint32_t next = 1;
+    {
+        EventJournal journal(region);
+        CHECK_OK(journal.mount());
+        record_n(journal, next, 20); // déborde sur le deuxième secteur
+        CHECK_OK(journal.flush());
+        CHECK_EQ(journal.pending(), 0u);
+        CHECK_EQ(journal.write_offset(), 20 * JournalRecord::SIZE);
+    }
+
+    EventJournal journal(region);
+    CHECK_OK(journal.mount());
+    CHECK_EQ(journal.write_offset(), 20 * JournalRecord::SIZE);
+    record_n(journal, next, 5);
+    CHECK_OK(journal.flush());
+    check_complete(region, 25);
+    CHECK_EQ(region.dirty_writes(), 0u);
+    // Deux secteurs entamés : deux effacements
+    CHECK_EQ(region.erases(), 2u);
+}
+
+TEST_CASE(interrupted_write_resumes_in_next_sector)
+{
+    host::reset();
+    host::FileRegion region(fresh_path("interrupted"), REGION, SECTOR);
+    EventJournal journal(region);
+    CHECK_OK(journal.mount());
+    uint32_t next = 1;
+    record_n(journal, next, 3);
+    CHECK_OK(journal.flush());
+
+    // Coupure au milieu du 3e enregistrement du paquet suivant
+    record_n(journal, next, 6);
+    region.fail_writes_after(2 * JournalRecord::SIZE + 7);
+    CHECK(journal.flush() != ESP_OK);
+    // Les deux enregistrements arrivés entiers sont acquis, la fin du secteur est abandonnée
+    CHECK_EQ(journal.pending(), 4u);
+    CHECK_EQ(journal.write_offset(), SECTOR);
+
+    region.fail_writes_after(SIZE_MAX);
+    CHECK_OK(journal.flush());
+    CHECK_EQ(journal.pending(), 0u);
+    CHECK_EQ(region.dirty_writes(), 0u);
+    check_complete(region, 9);
+
+    // Au montage suivant, la reprise suit le plus grand numéro de séquence
+    EventJournal remounted(region);
+    CHECK_OK(remounted.mount());
+    CHECK_EQ(remounted.write_offset(), SECTOR + 4 * JournalRecord::SIZE);
+}
+
+TEST_CASE(chunk_split_at_sector_boundary)
+{
+    host::reset();
+    host::FileRegion region(fresh_path("sector_edge"), REGION, SECTOR);
+    EventJournal journal(region);
+    CHECK_OK(journal.mount());
+    uint32_t next = 1;
+    record_n(journal, next, 14);
+    CHECK_OK(journal.flush());
+
+    // Paquet à cheval sur la frontière : 2 enregistrements dans le secteur 0, la suite dans le secteur 1
+    record_n(journal, next, 8);
+    region.fail_writes_after(2 * JournalRecord::SIZE + 3 * JournalRecord::SIZE + 1);
+    CHECK(journal.flush() != ESP_OK);
+    CHECK_EQ(journal.pending(), 3u);
+    CHECK_EQ(journal.write_offset(), 2 * SECTOR);
+
+    region.fail_writes_after(SIZE_MAX);
+    CHECK_OK(journal.flush());
+    check_complete(region, 22);
+    CHECK_EQ(region.dirty_writes(), 0u);
+}
+
+TEST_CASE(overflow_record_survives_failed_flush)
+{
+    host::reset();
+    host::FileRegion region(fresh_path("overflow"), REGION, SECTOR);
+    EventJournal journal(region);
+    CHECK_OK(journal.mount());
+    uint32_t next = 1;
+    record_n(journal, next, EventJournal::BUFFER + 2);
+    CHECK_EQ(journal.dropped(), 2u);
+
+    region.fail_writes_after(0);
+    CHECK(journal.flush() != ESP_OK);
+    region.fail_writes_after(SIZE_MAX);
+    CHECK_OK(journal.flush());
+
+    const std::vector<JournalRecord> records = scan(region);
+    CHECK_EQ(records.size(), EventJournal::BUFFER + 1);
+    CHECK(records.back().event == JournalEvent::Overflow);
+    CHECK_EQ(records.back().arg32, 2u);
+    CHECK_EQ(region.dirty_writes(), 0u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,196 @@
+// Sortie JSON (CONFIG_STUSB4500_JSON_OUTPUT) : chaque to_json() produit un document bien formé, vide sans l'option.
+
+#include <cctype>
+#include <string>
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config_macro.hpp"
+#include "stusb4500-output.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    /// Analyseur JSON minimal (RFC 8259 sans vérification des séquences \u) : vrai si `text` est un document complet
+    class JsonChecker
+    {
+    public:
+        explicit JsonChecker(const std::string &text) : text_(text) {}
+
+        bool valid()
+        {
+            skip_space();
+            if (!value())
+                return false;
+            skip_space();
+            return pos_ == text_.size();
+        }
+
+    private:
+        const std::string &text_;
+        size_t pos_ = 0;
+
+        char peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+        void skip_space()
+        {
+            while (std::isspace(static_cast<unsigned char>(peek())))
+                ++pos_;
+        }
+        bool literal(const char *word)
+        {
+            const std::string w(word);
+            if (text_.compare(pos_, w.size(), w) != 0)
+                return false;
+            pos_ += w.size();
+            return true;
+        }
+        bool string()
+        {
+            if (peek() != '"')
+                return false;
+            for (++pos_; pos_ < text_.size(); ++pos_)
+            {
+                const char c = text_[pos_];
+                if (c == '\\')
+                    ++pos_;
+                else if (c == '"')
+                {
+                    ++pos_;
+                    return true;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                    return false;
+            }
+            return false;
+        }
+        bool number()
+        {
+            const size_t start = pos_;
+            if (peek() == '-')
+                ++pos_;
+            while (std::isdigit(static_cast<unsigned char>(peek())) || peek() == '.' || peek() == 'e' ||
+                   peek() == 'E' || peek() == '+' || peek() == '-')
+                ++pos_;
+            return pos_ > start && std::isdigit(static_cast<unsigned char>(text_[pos_ - 1]));
+        }
+        bool sequence(char close, bool members)
+        {
+            ++pos_;
+            skip_space();
+            if (peek() == close)
+            {
+                ++pos_;
+                return true;
+            }
+            while (true)
+            {
+                skip_space();
+                if (members)
+                {
+                    if (!string())
+                        return false;
+                    skip_space();
+                    if (peek() != ':')
+                        return false;
+                    ++pos_;
+                    skip_space();
+                }
+                if (!value())
+                    return false;
+                skip_space();
+                if (peek() == ',')
+                {
+                    ++pos_;
+                    continue;
+                }
+                if (peek() != close)
+                    return false;
+                ++pos_;
+                return true;
+            }
+        }
+        bool value()
+        {
+            switch (peek())
+            {
+            case '{':
+                return sequence('}', true);
+            case '[':
+                return sequence(']', false);
+            case '"':
+                return string();
+            case 't':
+                return literal("true");
+            case 'f':
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default:
+                return number();
+            }
+        }
+    };
+
+    void check_json(const std::string &json)
+    {
+        if (!STUSB4500_JSON_OUTPUT)
+        {
+            CHECK(json.empty());
+            return;
+        }
+        if (!JsonChecker(json).valid())
+            std::fprintf(stderr, "JSON mal formé : %s\n", json.c_str());
+        CHECK(JsonChecker(json).valid());
+    }
+} // namespace
+
+TEST_CASE(checker_rejects_malformed_documents)
+{
+    CHECK(JsonChecker("{\"a\": [1, -2.5e3, true, null, \"x\\\"y\"]}").valid());
+    CHECK(!JsonChecker("{\"a\": 1,}").valid());
+    CHECK(!JsonChecker("{\"a\" 1}").valid());
+    CHECK(!JsonChecker("[1, 2").valid());
+    CHECK(!JsonChecker("{} {}").valid());
+}
+
+TEST_CASE(config_json_goes_through_cjson)
+{
+    const ConfigParams cfg = load_config_from_kconfig();
+    const std::string json = cfg.to_json();
+    check_json(json);
+    if (STUSB4500_JSON_OUTPUT)
+    {
+        CHECK(json.find("\"pdo_number\":3") != std::string::npos);
+        CHECK(json.find("\"voltage_mv\":15000") != std::string::npos);
+    }
+}
+
+TEST_CASE(driver_state_json_is_well_formed)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 2250)});
+    host::run_alerts_until(manager, host::now_us() + 500000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+
+    STATUS status(dev);
+    CHECK_OK(status.get_status());
+    check_json(status.to_json());
+    check_json(manager.source_capabilities().to_json());
+    check_json(manager.message_trace().to_json());
+    check_json(manager.pe_tracker().to_json());
+    check_json(manager.watchdog().to_json());
+    check_json(manager.known_chargers().to_json());
+    check_json(STUSB4500Manager::metrics().to_json());
+    PowerStats stats;
+    CHECK(manager.read_power_stats(stats));
+    check_json(stats.to_json());
+}
+
+TEST_MAIN()
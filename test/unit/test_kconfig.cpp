@@ -0,0 +1,117 @@
+// Configuration Kconfig résolue à la compilation : quantification NVM, image de 40 octets et valeurs du sdkconfig de test.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config_macro.hpp"
+#include "nvm/stusb4500-nvm_data.hpp"
+#include "sdkconfig.h"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr ConfigParams quantized_params()
+    {
+        ConfigParams cfg;
+        cfg.power_.pdo_number = 3;
+        cfg.power_.pdos[0] = {5000, 1500};
+        cfg.power_.pdos[1] = {9000, 2250};
+        cfg.power_.pdos[2] = {20000, 3000};
+        cfg.power_.flex_current_ma = 1230;
+        cfg.discharge_.time_to_0v = 9;
+        cfg.discharge_.time_to_pdo = 12;
+        return cfg;
+    }
+
+    constexpr ConfigParams decoded(const std::array<uint8_t, 40> &image)
+    {
+        ConfigParams cfg;
+        NVMLayout::decode(cfg, image.data());
+        return cfg;
+    }
+
+    // Chemin constexpr évalué par le compilateur : un échec ici ne compile pas
+    constexpr std::array<uint8_t, 40> IMAGE = NVMData::encode_image(quantized_params());
+    static_assert(decoded(IMAGE).power_.pdos[1].voltage_mv == 9000, "PDO2 voltage lost in the NVM image");
+    static_assert(decoded(IMAGE).power_.pdos[2].current_ma == 3000, "PDO3 current lost in the NVM image");
+    static_assert(decoded(IMAGE).power_.flex_current_ma == 1230, "flex current lost in the NVM image");
+    static_assert(decoded(IMAGE).power_.pdo_number == 3, "PDO count lost in the NVM image");
+
+    static_assert(is_lup_current(0) && is_lup_current(1500) && is_lup_current(5000), "lookup currents");
+    static_assert(!is_lup_current(1600) && !is_lup_current(2200), "currents outside the lookup table");
+    static_assert(is_voltage_step(9000) && !is_voltage_step(9020), "50 mV voltage grid");
+    static_assert(decode_voltage_step(encode_voltage_step(9020)) == 9000, "voltage truncated to the 50 mV grid");
+} // namespace
+
+TEST_CASE(unrepresentable_values_are_quantized)
+{
+    // Hors table : encode_lup_current() retombe sur le code 0 (courant flex), d'où le static_assert côté Kconfig
+    CHECK_EQ(encode_lup_current(1600), 0);
+    CHECK_EQ(decode_lup_current(encode_lup_current(2250)), 2250);
+
+    ConfigParams off_grid = quantized_params();
+    off_grid.power_.pdos[1] = {9020, 1600};
+    ConfigParams programmed = decoded(NVMData::encode_image(off_grid));
+    CHECK_EQ(programmed.power_.pdos[1].voltage_mv, 9000);
+    CHECK_EQ(programmed.power_.pdos[1].current_ma, 0);
+}
+
+TEST_CASE(kconfig_params_follow_sdkconfig)
+{
+    const ConfigParams cfg = load_config_from_kconfig();
+    CHECK_EQ(cfg.power_.pdo_number, 3);
+    CHECK_EQ(cfg.power_.pdos[0].voltage_mv, 5000);
+    CHECK_EQ(cfg.power_.pdos[0].current_ma, 1500);
+    CHECK_EQ(cfg.power_.pdos[1].voltage_mv, CONFIG_STUSB4500_PDO2_VOLTAGE);
+    CHECK_EQ(cfg.power_.pdos[1].current_ma, 1500);
+    CHECK_EQ(cfg.power_.pdos[2].voltage_mv, CONFIG_STUSB4500_PDO3_VOLTAGE);
+    CHECK_EQ(cfg.power_.pdos[2].current_ma, 1000);
+    CHECK_EQ(cfg.power_.pdos[2].vbus_monitor.upper_percent, CONFIG_STUSB4500_PDO3_VBUS_HIGH);
+    CHECK_EQ(cfg.power_.flex_current_ma, CONFIG_STUSB4500_FLEX_CURRENT);
+    CHECK_EQ(cfg.discharge_.time_to_pdo, CONFIG_STUSB4500_DISCHARGE_TO_PDO);
+    CHECK_EQ(cfg.alert_mask.get_raw(), CONFIG_STUSB4500_ALERT_MASK);
+}
+
+TEST_CASE(compile_time_image_matches_runtime_encoding)
+{
+    ConfigParams cfg = load_config_from_kconfig();
+    const std::array<uint8_t, 40> &image = kconfig_nvm_image();
+    CHECK(NVMData(cfg).to_array() == image);
+
+    // Les octets hors configuration gardent la carte par défaut du composant
+    CHECK_EQ(image[0], NVMData::default_nvm_map[0]);
+    ConfigParams programmed = decoded(image);
+    CHECK_EQ(programmed.power_.pdos[1].voltage_mv, cfg.power_.pdos[1].voltage_mv);
+    CHECK_EQ(programmed.power_.pdos[2].current_ma, cfg.power_.pdos[2].current_ma);
+    CHECK_EQ(programmed.power_.flex_current_ma, cfg.power_.flex_current_ma);
+}
+
+TEST_CASE(init_device_programs_compiled_image)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    const size_t write_op = static_cast<size_t>(NvmOp::Write);
+    const uint32_t writes = STUSB4500Manager::metrics().nvm_ops[write_op];
+
+    // NVM à jour : relue et comparée à l'image, jamais reprogrammée
+    {
+        STUSB4500Manager manager(dev);
+        CHECK_OK(manager.init_device());
+        CHECK(chip.nvm == kconfig_nvm_image());
+        CHECK_EQ(STUSB4500Manager::metrics().nvm_ops[write_op], writes);
+    }
+
+    // NVM programmée pour une autre table : l'image compilée est écrite telle quelle
+    ConfigParams other = load_config_from_kconfig();
+    other.power_.pdos[2].voltage_mv = 12000;
+    chip.nvm = NVMData::encode_image(other);
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    CHECK(chip.nvm == kconfig_nvm_image());
+    CHECK_EQ(STUSB4500Manager::metrics().nvm_ops[write_op], writes + 1);
+}
+
+TEST_MAIN()
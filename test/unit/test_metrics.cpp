@@ -0,0 +1,180 @@
+// Compteurs du driver : ventilation du trafic I2C, reprises, histogrammes, session simulée et mises à jour concurrentes.
+
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "fake_bus.hpp"
+#include "host_platform.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    uint32_t total_reads(const MetricsSnapshot &m)
+    {
+        uint32_t reads = 0;
+        for (const auto &bus : m.bus)
+            reads += bus.reads;
+        return reads;
+    }
+
+    uint32_t total_writes(const MetricsSnapshot &m)
+    {
+        uint32_t writes = 0;
+        for (const auto &bus : m.bus)
+            writes += bus.writes;
+        return writes;
+    }
+
+    const MetricsSnapshot::Bus &bus_of(const MetricsSnapshot &m, RegClass cls)
+    {
+        return m.bus[static_cast<std::size_t>(cls)];
+    }
+} // namespace
+
+TEST_CASE(register_classes)
+{
+    CHECK(reg_class(0x0B) == RegClass::Status);
+    CHECK(reg_class(0x29) == RegClass::Status);
+    CHECK(reg_class(0x1A) == RegClass::Ctrl);
+    CHECK(reg_class(0x31) == RegClass::RX);
+    CHECK(reg_class(0x4E) == RegClass::RX);
+    CHECK(reg_class(0x96) == RegClass::NVM);
+    CHECK(reg_class(0x85) == RegClass::PDO);
+    CHECK(reg_class(0x91) == RegClass::RDO);
+    CHECK(reg_class(0x80) == RegClass::Other);
+}
+
+TEST_CASE(bus_traffic_retries_and_failures)
+{
+    host::reset();
+    host::FakeBus bus;
+    I2CDevices dev;
+    INTERFACE io(dev);
+    Metrics::instance().reset();
+
+    uint8_t buffer[8] = {0};
+    CHECK_OK(io.read_register(0x0B, buffer, 2));
+    CHECK_OK(io.read_register(0x85, buffer, 8));
+    CHECK_OK(io.write_register(0x1A, buffer, 1));
+    bus.fail_next = 1; // un échec, réussi à la deuxième tentative
+    CHECK_OK(io.read_register(0x31, buffer, 2));
+    bus.fail_next = 3; // trois échecs : abandon
+    CHECK(io.write_register(0x91, buffer, 4) != ESP_OK);
+
+    const MetricsSnapshot m = Metrics::instance().snapshot();
+    CHECK_EQ(bus_of(m, RegClass::Status).reads, 1u);
+    CHECK_EQ(bus_of(m, RegClass::Status).read_bytes, 2u);
+    CHECK_EQ(bus_of(m, RegClass::PDO).read_bytes, 8u);
+    CHECK_EQ(bus_of(m, RegClass::Ctrl).writes, 1u);
+    CHECK_EQ(bus_of(m, RegClass::Ctrl).write_bytes, 1u);
+    CHECK_EQ(bus_of(m, RegClass::RX).retries, 1u);
+    CHECK_EQ(bus_of(m, RegClass::RX).failures, 0u);
+    CHECK_EQ(bus_of(m, RegClass::RDO).writes, 1u);
+    CHECK_EQ(bus_of(m, RegClass::RDO).retries, 2u);
+    CHECK_EQ(bus_of(m, RegClass::RDO).failures, 1u);
+    CHECK_EQ(bus_of(m, RegClass::RDO).write_bytes, 0u);
+}
+
+TEST_CASE(duration_histograms)
+{
+    Metrics &metrics = Metrics::instance();
+    metrics.reset();
+    const int64_t durations[] = {50, 99, 100, 999, 5000, 50000, 500000, 5000000};
+    for (int64_t d : durations)
+        metrics.on_alert_handled(d);
+    metrics.on_recovery(RecoveryKind::Status, 120000, true);
+    metrics.on_recovery(RecoveryKind::Status, 80000, false);
+    metrics.on_attach_contract(-5);
+
+    const MetricsSnapshot m = metrics.snapshot();
+    CHECK_EQ(m.alerts_total, 8u);
+    const MetricsSnapshot::Histogram expected{2, 2, 1, 1, 1, 1};
+    for (std::size_t i = 0; i < MetricsSnapshot::BUCKETS; ++i)
+        CHECK_EQ(m.alert_duration[i], expected[i]);
+
+    const std::size_t status = static_cast<std::size_t>(RecoveryKind::Status);
+    CHECK_EQ(m.recoveries[status], 2u);
+    CHECK_EQ(m.recovery_failures[status], 1u);
+    CHECK_EQ(m.recovery_max_us[status], 120000u);
+    CHECK_EQ(m.recovery_duration[status][4], 1u);
+    CHECK_EQ(m.recovery_duration[status][3], 1u);
+    // Durée négative (horloge) ramenée à zéro
+    CHECK_EQ(m.attach_to_contract_last_us, 0u);
+    CHECK_EQ(m.attach_to_contract[0], 1u);
+
+    metrics.reset();
+    CHECK_EQ(metrics.snapshot().alerts_total, 0u);
+    CHECK_EQ(metrics.snapshot().recovery_max_us[status], 0u);
+}
+
+TEST_CASE(simulated_session_counters)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+
+    Metrics::instance().reset();
+    chip.reset_counters();
+    const int64_t attach_us = host::now_us();
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+    host::run_alerts_until(manager, host::now_us() + 1000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+
+    const MetricsSnapshot m = Metrics::instance().snapshot();
+    // Chaque transaction du bus simulé est comptée une fois, dans sa famille
+    CHECK_EQ(total_reads(m), chip.counters().reads);
+    CHECK_EQ(total_writes(m), chip.counters().writes);
+    uint32_t read_bytes = 0;
+    for (const auto &bus : m.bus)
+        read_bytes += bus.read_bytes;
+    CHECK_EQ(read_bytes, chip.counters().read_bytes);
+    CHECK(bus_of(m, RegClass::RX).reads >= 2u);
+    CHECK(bus_of(m, RegClass::RDO).reads >= 1u);
+
+    CHECK_EQ(m.alerts[static_cast<std::size_t>(AlertKind::PortStatus)], 1u);
+    CHECK_EQ(m.alerts[static_cast<std::size_t>(AlertKind::PRTStatus)], 2u); // capacités, PS_RDY
+    CHECK_EQ(m.alerts_total, 3u);
+    CHECK_EQ(m.contract_changes, 1u);
+    CHECK_EQ(m.contract_power_mw, 20000u);
+    CHECK_EQ(m.attach_contracts, 1u);
+    CHECK(m.attach_to_contract_last_us >= static_cast<uint32_t>(chip.contract_us - attach_us));
+    CHECK_EQ(m.attach_to_contract_max_us, m.attach_to_contract_last_us);
+    CHECK_EQ(m.attach_to_contract[4], 1u); // 100 ms - 1 s
+}
+
+TEST_CASE(concurrent_updates_are_not_lost)
+{
+    Metrics &metrics = Metrics::instance();
+    metrics.reset();
+    constexpr int THREADS = 4;
+    constexpr uint32_t PER_THREAD = 100000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&metrics, t] {
+            for (uint32_t i = 0; i < PER_THREAD; ++i)
+            {
+                metrics.on_read(0x31, 4, 1, true);
+                metrics.on_alert(AlertKind::PRTStatus);
+                metrics.on_recovery(RecoveryKind::Nvm, t * 1000 + (i & 0xFF), true);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    const MetricsSnapshot m = metrics.snapshot();
+    CHECK_EQ(bus_of(m, RegClass::RX).reads, THREADS * PER_THREAD);
+    CHECK_EQ(bus_of(m, RegClass::RX).read_bytes, 4 * THREADS * PER_THREAD);
+    CHECK_EQ(m.alerts[static_cast<std::size_t>(AlertKind::PRTStatus)], THREADS * PER_THREAD);
+    CHECK_EQ(m.recovery_max_us[static_cast<std::size_t>(RecoveryKind::Nvm)], (THREADS - 1) * 1000u + 0xFF);
+}
+
+TEST_MAIN()
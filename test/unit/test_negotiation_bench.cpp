@@ -0,0 +1,121 @@
+// NegotiationBench sur le STUSB4500 simulé : latences sur l'horloge virtuelle, RDO inchangé, dépassement d'échantillons.
+
+#include "check.hpp"
+#include "chip_sim.hpp"
+#include "host_platform.hpp"
+#include "ctrl/stusb4500-ctrl.hpp"
+#include "ctrl/stusb4500-negotiation_bench.hpp"
+#include "pd/stusb4500-pdo.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    const std::vector<uint32_t> CHARGER_60W{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 3000),
+                                            host::ChipSim::fixed(15000, 3000), host::ChipSim::fixed(20000, 3000)};
+
+    PowerProfile sink_table(uint16_t pdo3_mv)
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, 1500};
+        power.pdos[1] = {9000, 1500};
+        power.pdos[2] = {pdo3_mv, 1500};
+        return power;
+    }
+
+    // Chargeur attaché, contrat établi sur la table initiale (PDO3 à 20 V)
+    void attach_with_contract(host::ChipSim &chip)
+    {
+        host::reset();
+        I2CDevices dev;
+        CHECK_OK(PDOTable(dev, sink_table(20000)).write());
+        chip.attach(CHARGER_60W);
+        host::advance_us(1000000);
+        CHECK_EQ(chip.contract_mv(), 20000u);
+    }
+} // namespace
+
+TEST_CASE(samples_beyond_capacity_are_counted)
+{
+    LatencySamples samples;
+    for (uint32_t i = 1; i <= LatencySamples::MAX_SAMPLES + 6; ++i)
+        samples.add(i);
+    CHECK_EQ(samples.count, LatencySamples::MAX_SAMPLES);
+    CHECK_EQ(samples.dropped, 6u);
+    CHECK_EQ(samples.min(), 1u);
+    CHECK_EQ(samples.max(), static_cast<uint32_t>(LatencySamples::MAX_SAMPLES));
+    CHECK_EQ(samples.percentile(50), static_cast<uint32_t>(LatencySamples::MAX_SAMPLES / 2));
+}
+
+TEST_CASE(soft_reset_latency_on_simulated_chip)
+{
+    host::ChipSim chip;
+    attach_with_contract(chip);
+
+    I2CDevices dev;
+    NegotiationBench bench(dev);
+    NegotiationResult result;
+    chip.reset_counters();
+    CHECK_OK(bench.run(10, result));
+
+    // Soft reset -> capacités (30 ms) -> Accept (15 ms) -> PS_RDY après la transition à 20 V (20 ms)
+    const uint32_t expected_us = 30000 + 15000 + 20000;
+    CHECK_EQ(result.to_ready.count, 10u);
+    CHECK(result.to_ready.min() >= expected_us);
+    // Une période de scrutation : un tick plus ~1 ms de lectures PE et RDO à 100 kHz
+    CHECK(result.to_ready.max() <= expected_us + 4000);
+    CHECK_EQ(chip.soft_resets, 10u);
+    // Même table, même contrat : aucun nouveau RDO à dater
+    CHECK_EQ(result.rdo_unchanged, 10);
+    CHECK_EQ(result.to_rdo.count, 0u);
+    // Un tick par scrutation : ~2 lectures par milliseconde, pas d'attente active
+    CHECK(chip.counters().reads < 10u * 2u * 70u);
+    std::printf("soft reset : p50 %u us, max %u us, %u lectures I2C par itération\n",
+                static_cast<unsigned>(result.to_ready.percentile(50)), static_cast<unsigned>(result.to_ready.max()),
+                static_cast<unsigned>(chip.counters().reads / 10));
+}
+
+TEST_CASE(table_change_latency_dates_new_rdo)
+{
+    host::ChipSim chip;
+    attach_with_contract(chip);
+
+    I2CDevices dev;
+    NegotiationBench bench(dev);
+    NegotiationResult result;
+    uint16_t next_mv = 15000;
+    CHECK_OK(bench.run(8, result, [&]() {
+        // Alterne PDO3 entre 15 V et 20 V : chaque itération produit un RDO différent
+        esp_err_t err = PDOTable(dev, sink_table(next_mv)).write();
+        next_mv = next_mv == 15000 ? 20000 : 15000;
+        return err != ESP_OK ? err : CTRL(dev).send_soft_reset();
+    }));
+
+    CHECK_EQ(result.to_ready.count, 8u);
+    CHECK_EQ(result.to_rdo.count, 8u);
+    CHECK_EQ(result.rdo_unchanged, 0);
+    CHECK(result.to_rdo.min() >= 30000 + 15000 + 15000);
+    CHECK(result.to_rdo.max() <= result.to_ready.max());
+    CHECK(result.to_ready.max() <= 30000 + 15000 + 20000 + 4000);
+}
+
+TEST_CASE(stuck_policy_engine_times_out)
+{
+    host::ChipSim chip;
+    attach_with_contract(chip);
+
+    I2CDevices dev;
+    NegotiationBench bench(dev);
+    NegotiationResult result;
+    const int64_t start = host::now_us();
+    CHECK(bench.run(2, result, [&]() {
+        chip.freeze_pe(0x14);
+        return ESP_OK;
+    }, 200) == ESP_ERR_TIMEOUT);
+    CHECK_EQ(result.timeouts, 2);
+    CHECK_EQ(result.to_ready.count, 0u);
+    CHECK(host::now_us() - start < 2 * 200000 + 10000);
+}
+
+TEST_MAIN()
@@ -0,0 +1,132 @@
+// Table des PDO sink : drapeaux (dual-role, higher capability, unconstrained, USB comm, FRS) propres au PDO1.
+
+#include "check.hpp"
+#include "chip_sim.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "config/stusb4500-config.hpp"
+#include "config/stusb4500-config_patch.hpp"
+#include "pd/stusb4500-pdo.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    PowerProfile flagged_profile()
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, 1500};
+        power.pdos[1] = {9000, 2000};
+        power.pdos[2] = {20000, 3000};
+        power.dual_role_power = true;
+        power.higher_capability = true;
+        power.unconstrained_power = true;
+        power.usb_comm_capable = true;
+        power.frs = FastRoleSwap::A_3_0;
+        return power;
+    }
+
+    void check_flags(const PowerProfile &power)
+    {
+        CHECK(power.dual_role_power);
+        CHECK(power.higher_capability);
+        CHECK(power.unconstrained_power);
+        CHECK(power.usb_comm_capable);
+        CHECK(power.frs == FastRoleSwap::A_3_0);
+    }
+} // namespace
+
+TEST_CASE(encode_sets_flags_in_pdo1_only)
+{
+    const PowerProfile power = flagged_profile();
+    CHECK_EQ(power.encode(0) & PowerProfile::PDO1_FLAGS, PowerProfile::PDO1_FLAGS);
+    CHECK_EQ(power.encode(1) & PowerProfile::PDO1_FLAGS, 0u);
+    CHECK_EQ(power.encode(2) & PowerProfile::PDO1_FLAGS, 0u);
+    CHECK_EQ(power.encode(2), host::ChipSim::fixed(20000, 3000));
+}
+
+TEST_CASE(table_write_keeps_reserved_bits_clear)
+{
+    host::ChipSim chip;
+    I2CDevices dev;
+    CHECK_OK(PDOTable(dev, flagged_profile()).write(true));
+    CHECK_EQ(chip.sink_pdo(0) & PowerProfile::PDO1_FLAGS, PowerProfile::PDO1_FLAGS);
+    CHECK_EQ(chip.sink_pdo(1), host::ChipSim::fixed(9000, 2000));
+    CHECK_EQ(chip.sink_pdo(2), host::ChipSim::fixed(20000, 3000));
+}
+
+TEST_CASE(table_read_takes_flags_from_pdo1)
+{
+    host::ChipSim chip;
+    I2CDevices dev;
+    CHECK_OK(PDOTable(dev, flagged_profile()).write());
+    // Bits réservés non nuls dans PDO3 : ils ne doivent pas écraser les drapeaux du PDO1
+    chip.regs[host::ChipSim::SINK_PDO1 + 8 + 3] |= 0x20;
+
+    PDOTable table(dev);
+    CHECK_OK(table.read());
+    check_flags(table.power());
+    CHECK_EQ(table.power().pdos[2].voltage_mv, 20000);
+
+    // Et PDO1 sans drapeaux n'hérite pas de ceux de PDO3
+    chip.regs[host::ChipSim::SINK_PDO1 + 3] &= 0xC0;
+    chip.regs[host::ChipSim::SINK_PDO1 + 2] &= 0x7F;
+    CHECK_OK(table.read());
+    CHECK(!table.power().dual_role_power);
+    CHECK(table.power().frs == FastRoleSwap::NotSupported);
+}
+
+TEST_CASE(single_pdo_write_masks_flags)
+{
+    host::ChipSim chip;
+    I2CDevices dev;
+    PDO pdo3(dev, 3, {20000, 3000});
+    pdo3.power().usb_comm_capable = true;
+    CHECK_OK(pdo3.write());
+    CHECK_EQ(chip.sink_pdo(2), host::ChipSim::fixed(20000, 3000));
+}
+
+TEST_CASE(config_patch_flag_change_touches_pdo1_only)
+{
+    ConfigParams current;
+    current.power_ = flagged_profile();
+    ConfigParams target = current;
+    target.power_.usb_comm_capable = false;
+
+    I2CDevices dev;
+    ConfigPatch patch(dev);
+    patch.compute(current, target);
+    CHECK_EQ(patch.size(), 1u);
+    CHECK_EQ(patch[0].reg, PDOTable::base_reg_addr);
+    CHECK_EQ(patch[0].len, PDOTable::pdo_len);
+    CHECK(patch.needs_renegotiation());
+}
+
+TEST_CASE(reconfigure_uses_one_based_index)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+
+    ConfigParams params;
+    params.power_.pdos[0] = {5000, 1500};
+    params.power_.pdos[1] = {9000, 2000};
+    params.power_.pdos[2] = {15000, 1000};
+    Config cfg(dev, params);
+
+    // PDO3 = pdos[2] ; hors de 1..3, rien n'est écrit
+    CHECK_OK(manager.reconfigure(3, cfg));
+    CHECK_EQ(chip.sink_pdo(2), host::ChipSim::fixed(15000, 1000));
+    CHECK_EQ(chip.sink_pdo_count(), 3);
+    const uint32_t pdo1 = chip.sink_pdo(0);
+    CHECK_EQ(manager.reconfigure(0, cfg), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(manager.reconfigure(4, cfg), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(chip.sink_pdo(0), pdo1);
+    CHECK_EQ(chip.sink_pdo_count(), 3);
+}
+
+TEST_MAIN()
@@ -0,0 +1,71 @@
+// Miroir du policy engine : transitions admises, détection d'un état d'attente bloqué depuis la tâche du driver.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "status/stusb4500-pe_tracker.hpp"
+
+using namespace stusb4500;
+
+TEST_CASE(ready_to_request_states_is_legal)
+{
+    // Nouvelles capacités lues en retard : l'évaluation n'a pas été échantillonnée
+    CHECK(PETracker::is_legal(0x18, 0x16));
+    CHECK(PETracker::is_legal(0x18, 0x17));
+    CHECK(PETracker::is_legal(0x18, 0x15));
+    CHECK(!PETracker::is_legal(0x18, 0x13));
+    CHECK(!PETracker::is_legal(0x16, 0x13));
+
+    PETracker pe;
+    const uint8_t sequence[] = {0x13, 0x15, 0x18, 0x16, 0x17, 0x18, 0x17, 0x18};
+    int64_t now = 1000;
+    for (uint8_t state : sequence)
+        CHECK(pe.observe(state, now += 1000));
+    CHECK_EQ(pe.illegal_transitions(), 0u);
+    CHECK_EQ(pe.transitions(), 7u);
+}
+
+TEST_CASE(time_to_stuck_follows_wait_states)
+{
+    PETracker pe(100000);
+    CHECK_EQ(pe.time_to_stuck(0), -1);
+    pe.observe(0x18, 1000);
+    CHECK_EQ(pe.time_to_stuck(2000), -1);
+
+    pe.observe(0x16, 10000);
+    CHECK_EQ(pe.time_to_stuck(10000), 100000);
+    CHECK_EQ(pe.time_to_stuck(60000), 50000);
+    CHECK(!pe.check_stuck(109999));
+    CHECK_EQ(pe.time_to_stuck(120000), 0);
+    CHECK(pe.check_stuck(120000));
+    // Signalé une seule fois par passage
+    CHECK_EQ(pe.time_to_stuck(130000), -1);
+    CHECK(!pe.check_stuck(200000));
+    CHECK_EQ(pe.stuck_events(), 1u);
+}
+
+TEST_CASE(task_reports_stuck_wait_without_alert)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    manager.init();
+    host::run_task_for(100000);
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+    host::run_task_for(1000000);
+    CHECK_EQ(manager.pe_tracker().current(), PETracker::PE_SNK_READY);
+
+    // La source répond Wait puis se tait : plus aucune alerte, watchdog désarmé par le contrat
+    chip.receive_control(0x0C, 0x16);
+    host::run_task_for(PETracker::DEFAULT_STUCK_US / 2);
+    CHECK_EQ(manager.pe_tracker().current(), 0x16);
+    CHECK_EQ(manager.pe_tracker().illegal_transitions(), 0u);
+    CHECK_EQ(manager.pe_tracker().stuck_events(), 0u);
+
+    host::run_task_for(PETracker::DEFAULT_STUCK_US / 2 + 10000);
+    CHECK_EQ(manager.pe_tracker().stuck_events(), 1u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,86 @@
+// Sélection du contrat (ContractPolicy) et application de la table sink par le manager sur le STUSB4500 simulé.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "pd/stusb4500-policy.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    SourceCapabilities caps_of(const std::vector<uint32_t> &objects)
+    {
+        SourceCapabilities caps;
+        caps.decode(objects.data(), objects.size());
+        return caps;
+    }
+
+    const std::vector<uint32_t> CHARGER_60W{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 3000),
+                                            host::ChipSim::fixed(15000, 3000), host::ChipSim::fixed(20000, 3000)};
+} // namespace
+
+TEST_CASE(pdo1_current_is_clamped)
+{
+    LoadProfile load;
+    load.max_current_ma = 1000;
+    PDObjectProfile pdo1;
+    pdo1.current_ma = 1500;
+
+    const SinkPlan plan = ContractPolicy::select(caps_of(CHARGER_60W), load, pdo1);
+    CHECK_EQ(plan.pdo_number, 3);
+    CHECK_EQ(plan.pdos[0].voltage_mv, 5000);
+    CHECK_EQ(plan.pdos[0].current_ma, 1000);
+    CHECK_EQ(plan.pdos[2].voltage_mv, 20000);
+    CHECK_EQ(plan.pdos[2].current_ma, 1000);
+}
+
+TEST_CASE(same_pdos_compares_pdo1)
+{
+    LoadProfile load;
+    load.max_current_ma = 1000;
+    PowerProfile sink;
+    sink.pdos[0].current_ma = 1500;
+
+    const SinkPlan plan = ContractPolicy::select(caps_of(CHARGER_60W), load, sink.pdos[0]);
+    sink.pdo_number = plan.pdo_number;
+    for (size_t i = 1; i < sink.pdos.size(); ++i)
+        sink.pdos[i] = plan.pdos[i];
+    // Seul le courant du PDO1 diffère : la table doit quand même être réécrite
+    CHECK(!plan.same_pdos(sink));
+    sink.pdos[0] = plan.pdos[0];
+    CHECK(plan.same_pdos(sink));
+}
+
+TEST_CASE(apply_policy_writes_clamped_pdo1)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    CHECK_EQ(host::ChipSim::sink_ma(chip.sink_pdo(0)), 1500u); // PDO1 du Kconfig
+
+    LoadProfile load;
+    load.max_current_ma = 1000;
+    manager.set_load_profile(load);
+    chip.attach(CHARGER_60W);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+
+    CHECK_EQ(chip.sink_pdo_count(), 3);
+    CHECK_EQ(host::ChipSim::sink_mv(chip.sink_pdo(0)), 5000u);
+    CHECK_EQ(host::ChipSim::sink_ma(chip.sink_pdo(0)), 1000u);
+    CHECK_EQ(host::ChipSim::sink_mv(chip.sink_pdo(2)), 20000u);
+    CHECK_EQ(host::ChipSim::sink_ma(chip.sink_pdo(2)), 1000u);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(chip.soft_resets, 1u);
+
+    // Capacités renvoyées à l'identique : la table est déjà à jour, pas de nouvelle renégociation
+    manager.set_load_profile(load);
+    chip.resend_caps(CHARGER_60W);
+    host::run_alerts_until(manager, host::now_us() + 1000000);
+    CHECK_EQ(chip.soft_resets, 1u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,167 @@
+// Bilan de puissance : séquence de contrats sur l'horloge virtuelle, seule puis à travers le manager et le STUSB4500 simulé.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "status/stusb4500-power_accounting.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr int64_t SECOND_US = 1000000;
+    constexpr int64_t HOUR_US = 3600 * SECOND_US;
+    // Horodatages esp_timer, jamais nuls en service (session_start_us == 0 signifie « aucune session »)
+    constexpr int64_t T0 = SECOND_US;
+} // namespace
+
+TEST_CASE(contract_sequence_accumulates_energy)
+{
+    PowerAccounting power;
+    power.on_contract(5000, 3000, T0);                // 15 W
+    power.on_contract(5000, 3000, T0 + HOUR_US / 2);  // identique : ignoré
+    power.on_contract(20000, 3000, T0 + HOUR_US);     // 60 W
+    CHECK_EQ(power.stats().session_contracts, 2u);
+    CHECK_EQ(power.stats().session_energy_mwh(), 15000u);
+
+    // Le contrat en cours est extrapolé sans être clos
+    const PowerStats now = power.stats().at(T0 + HOUR_US + HOUR_US / 2);
+    CHECK_EQ(now.session_energy_mwh(), 15000u + 30000u);
+    CHECK_EQ(power.stats().session_energy_mwh(), 15000u);
+
+    power.on_detach(T0 + 2 * HOUR_US);
+    const PowerStats &closed = power.stats();
+    CHECK_EQ(closed.session_start_us, 0);
+    CHECK_EQ(closed.contract_power_mw, 0u);
+    CHECK_EQ(closed.session_energy_mwh(), 75000u);
+    CHECK_EQ(closed.total_energy_mwh(), 75000u);
+    CHECK_EQ(closed.peak_power_mw, 60000u);
+    CHECK_EQ(closed.longest_contract_us, HOUR_US);
+    CHECK_EQ(closed.sessions, 1u);
+
+    // Nouvelle session : énergie de session remise à zéro, total conservé
+    power.on_contract(9000, 2000, T0 + 3 * HOUR_US);
+    power.on_detach(T0 + 4 * HOUR_US);
+    CHECK_EQ(power.stats().sessions, 2u);
+    CHECK_EQ(power.stats().session_contracts, 1u);
+    CHECK_EQ(power.stats().session_energy_mwh(), 18000u);
+    CHECK_EQ(power.stats().total_energy_mwh(), 93000u);
+}
+
+TEST_CASE(no_contract_no_energy)
+{
+    PowerAccounting power;
+    power.on_contract(0, 0, T0);
+    CHECK_EQ(power.stats().sessions, 0u);
+    CHECK_EQ(power.stats().at(T0 + HOUR_US).total_energy_mw_us, 0u);
+}
+
+TEST_CASE(simulated_charger_session)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip); // PDO2 15 V 1,5 A, PDO3 20 V 1 A
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(15000, 3000),
+                 host::ChipSim::fixed(20000, 3000)});
+    host::run_alerts_until(manager, host::now_us() + SECOND_US);
+
+    PowerStats stats;
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(stats.contract_voltage_mv, 20000);
+    CHECK_EQ(stats.contract_current_ma, 1000);
+    CHECK_EQ(stats.contract_power_mw, 20000u);
+    CHECK_EQ(stats.sessions, 1u);
+    // Contrat daté quand le driver relit le RDO, quelques transactions après PS_RDY
+    const int64_t first_us = stats.contract_start_us;
+    CHECK(first_us >= chip.contract_us && first_us - chip.contract_us < 10000);
+
+    // Une heure à 20 W, lue sans accès au bus
+    host::advance_to(first_us + HOUR_US);
+    chip.reset_counters();
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(chip.counters().transactions(), 0u);
+    CHECK_EQ(stats.session_energy_mwh(), 20000u);
+
+    // La source retire 20 V : nouveau contrat à 15 V 1,5 A
+    chip.resend_caps({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(15000, 3000)});
+    host::run_alerts_until(manager, host::now_us() + SECOND_US);
+    CHECK_EQ(chip.contract_mv(), 15000u);
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(stats.contract_power_mw, 22500u);
+    CHECK_EQ(stats.session_contracts, 2u);
+    CHECK_EQ(stats.peak_power_mw, 22500u);
+    const int64_t second_us = stats.contract_start_us;
+
+    host::advance_to(second_us + HOUR_US);
+    chip.detach();
+    host::run_alerts_until(manager, host::now_us() + SECOND_US);
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(stats.contract_power_mw, 0u);
+    CHECK_EQ(stats.session_start_us, 0);
+    CHECK_EQ(stats.sessions, 1u);
+    const int64_t detach_us = stats.contract_start_us;
+    CHECK(detach_us - (second_us + HOUR_US) < 10000);
+    // Le contrat 20 W reste en vigueur pendant la renégociation, jusqu'à la relecture du RDO à 15 V
+    CHECK_EQ(stats.longest_contract_us, second_us - first_us);
+
+    // 20 W pendant au moins une heure, au plus jusqu'au second contrat, puis 22,5 W jusqu'au détachement
+    const uint64_t second_mw_us = 22500ull * static_cast<uint64_t>(detach_us - second_us);
+    const uint64_t min_mw_us = 20000ull * static_cast<uint64_t>(HOUR_US) + second_mw_us;
+    const uint64_t max_mw_us = 20000ull * static_cast<uint64_t>(second_us - first_us) + second_mw_us;
+    CHECK(stats.session_energy_mw_us >= min_mw_us && stats.session_energy_mw_us <= max_mw_us);
+    CHECK_EQ(stats.total_energy_mw_us, stats.session_energy_mw_us);
+    CHECK_EQ(stats.session_energy_mwh(), 20000u + 22500u);
+    const uint64_t expected_mw_us = stats.total_energy_mw_us;
+
+    // Extrapolation après la session : plus rien ne s'accumule
+    host::advance_us(HOUR_US);
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(stats.total_energy_mw_us, expected_mw_us);
+}
+
+TEST_CASE(renegotiated_same_contract_is_not_recounted)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    const std::vector<uint32_t> source{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)};
+    chip.attach(source);
+    host::run_alerts_until(manager, host::now_us() + SECOND_US);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    Metrics::instance().reset();
+
+    // Mêmes capacités renvoyées : PE hors READY le temps de la négociation, contrat identique à l'issue
+    PowerStats stats;
+    CHECK(manager.read_power_stats(stats));
+    const int64_t start_us = stats.contract_start_us;
+    for (int i = 0; i < 3; ++i)
+    {
+        chip.resend_caps(source);
+        host::run_alerts_until(manager, host::now_us() + SECOND_US);
+        CHECK_EQ(chip.contract_mv(), 20000u);
+    }
+    CHECK(manager.read_power_stats(stats));
+    CHECK_EQ(stats.session_contracts, 1u);
+    CHECK_EQ(stats.contract_start_us, start_us);
+    CHECK_EQ(Metrics::instance().snapshot().contract_changes, 0u);
+    StatusSnapshot snapshot;
+    CHECK(manager.read_snapshot(snapshot));
+    CHECK_EQ(snapshot.active_voltage_mv, 20000u);
+
+    // Détachement : contrat clos, compté comme changement
+    chip.detach();
+    host::run_alerts_until(manager, host::now_us() + SECOND_US);
+    CHECK(manager.read_snapshot(snapshot));
+    CHECK_EQ(snapshot.active_voltage_mv, 0u);
+    CHECK_EQ(Metrics::instance().snapshot().contract_changes, 1u);
+    CHECK_EQ(Metrics::instance().snapshot().contract_power_mw, 0u);
+}
+
+TEST_MAIN()
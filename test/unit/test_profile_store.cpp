@@ -0,0 +1,96 @@
+// Profils de puissance nommés : blob persistant (drapeaux du PDO1) et bascule de profil sur un chargeur connu.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "memory_store.hpp"
+#include "pd/stusb4500-charger_cache.hpp"
+#include "storage/stusb4500-profile_store.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    const std::vector<uint32_t> CHARGER_A{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(9000, 3000),
+                                          host::ChipSim::fixed(15000, 3000), host::ChipSim::fixed(20000, 3000)};
+
+    PowerProfile flagged_profile()
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, 1500};
+        power.pdos[1] = {9000, 2000};
+        power.pdos[2] = {20000, 3000};
+        power.dual_role_power = true;
+        power.higher_capability = true;
+        power.unconstrained_power = true;
+        power.usb_comm_capable = true;
+        power.frs = FastRoleSwap::A_3_0;
+        return power;
+    }
+
+    PowerProfile table_of(uint16_t pdo1_ma, uint16_t pdo3_mv)
+    {
+        PowerProfile power;
+        power.pdo_number = 3;
+        power.pdos[0] = {5000, pdo1_ma};
+        power.pdos[1] = {9000, 1000};
+        power.pdos[2] = {pdo3_mv, 1000};
+        return power;
+    }
+} // namespace
+
+TEST_CASE(profile_store_round_trip)
+{
+    host::MemoryStore store;
+    ProfileStore profiles(store);
+    CHECK_OK(profiles.save("flags", flagged_profile()));
+    const std::vector<uint8_t> &blob = store.blobs.begin()->second;
+    CHECK_EQ(load_le32(blob.data() + 2 + 4) & PowerProfile::PDO1_FLAGS, 0u);
+    CHECK_EQ(load_le32(blob.data() + 2 + 8) & PowerProfile::PDO1_FLAGS, 0u);
+
+    PowerProfile loaded;
+    CHECK_OK(profiles.load("flags", loaded));
+    CHECK(loaded.dual_role_power);
+    CHECK(loaded.higher_capability);
+    CHECK(loaded.unconstrained_power);
+    CHECK(loaded.usb_comm_capable);
+    CHECK(loaded.frs == FastRoleSwap::A_3_0);
+    CHECK_EQ(loaded.pdo_number, 3);
+    CHECK_EQ(loaded.pdos[1].current_ma, 2000);
+}
+
+TEST_CASE(switched_profile_replaces_remembered_table)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    host::MemoryStore store;
+    CHECK_OK(ProfileStore(store).save("p15", table_of(1000, 15000)));
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+    CHECK_OK(manager.set_store(&store));
+
+    chip.attach(CHARGER_A);
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+
+    // Profil choisi par l'application : l'entrée de A ne doit pas restaurer l'ancienne table à la renégociation
+    CHECK_OK(manager.switch_profile("p15"));
+    host::run_alerts_until(manager, host::now_us() + 2000000);
+    CHECK_EQ(chip.contract_mv(), 15000u);
+    CHECK_EQ(chip.sink_pdo(2), host::ChipSim::fixed(15000, 1000));
+
+    // L'entrée est réenregistrée avec la nouvelle table
+    CHECK_EQ(manager.known_chargers().size(), 1u);
+    const ChargerEntry *entry = manager.known_chargers().most_recent();
+    CHECK(entry != nullptr);
+    PowerProfile power;
+    entry->to_profile(power);
+    CHECK_EQ(power.pdos[2].voltage_mv, 15000);
+    CHECK_EQ(entry->rdo, chip.rdo());
+}
+
+TEST_MAIN()
@@ -0,0 +1,150 @@
+// Lecture RX en deux temps : octets réellement transférés sur le bus simulé.
+
+#include <vector>
+
+#include "check.hpp"
+#include "fake_bus.hpp"
+#include "pd/stusb4500-rx_datas.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+#include "pd/stusb4500-trace.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr uint8_t RX_HEADER = 0x31;
+    constexpr uint8_t FULL_WINDOW = 30; // lecture d'origine : 0x31-0x4E en une rafale
+
+    void load_message(host::FakeBus &bus, uint8_t type, const std::vector<uint32_t> &objects)
+    {
+        const uint16_t header = static_cast<uint16_t>(type | objects.size() << 12);
+        bus.regs[RX_HEADER] = header & 0xFF;
+        bus.regs[RX_HEADER + 1] = header >> 8;
+        for (size_t i = 0; i < objects.size(); ++i)
+            for (size_t b = 0; b < 4; ++b)
+                bus.regs[RX_HEADER + 2 + 4 * i + b] = static_cast<uint8_t>(objects[i] >> (8 * b));
+        bus.reset_counters();
+    }
+
+    uint32_t fixed(uint32_t mv, uint32_t ma)
+    {
+        return (mv / 50) << 10 | (ma / 10);
+    }
+} // namespace
+
+TEST_CASE(control_message_reads_header_only)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    load_message(bus, 0x06, {}); // PS_RDY
+
+    const uint32_t saved = RXDatas::bytes_saved();
+    CHECK_OK(rx.read());
+    CHECK_EQ(bus.counters().reads, 1u);
+    CHECK_EQ(bus.counters().read_bytes, 2u);
+    CHECK(rx.is_control_message());
+    CHECK_EQ(RXDatas::bytes_saved() - saved, FULL_WINDOW - 2u);
+}
+
+TEST_CASE(data_message_reads_announced_objects)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    const std::vector<uint32_t> caps{fixed(5000, 3000), fixed(9000, 3000), fixed(15000, 3000), fixed(20000, 2250)};
+    load_message(bus, RXDatas::SOURCE_CAPABILITIES, caps);
+
+    CHECK_OK(rx.read());
+    CHECK_EQ(bus.counters().reads, 2u);
+    CHECK_EQ(bus.counters().read_bytes, 2u + 4u * 4u);
+    CHECK(rx.is_source_capabilities());
+    SourceCapabilities decoded;
+    CHECK(rx.source_capabilities(decoded));
+    CHECK_EQ(decoded.size(), 4u);
+    for (size_t i = 0; i < caps.size(); ++i)
+        CHECK_EQ(rx.data_object(i), caps[i]);
+}
+
+TEST_CASE(expected_size_is_a_single_burst)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    load_message(bus, RXDatas::SOURCE_CAPABILITIES, {fixed(5000, 3000), fixed(9000, 2000)});
+
+    CHECK_OK(rx.read(2));
+    CHECK_EQ(bus.counters().reads, 1u);
+    CHECK_EQ(bus.counters().read_bytes, 10u);
+    CHECK_EQ(rx.num_objects(), 2);
+}
+
+TEST_CASE(underestimated_size_is_topped_up)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    const std::vector<uint32_t> caps{fixed(5000, 3000), fixed(9000, 3000), fixed(12000, 3000), fixed(15000, 3000),
+                                     fixed(20000, 3000)};
+    bus.keep_log = true;
+    load_message(bus, RXDatas::SOURCE_CAPABILITIES, caps);
+
+    CHECK_OK(rx.read(2));
+    CHECK_EQ(bus.counters().reads, 2u);
+    CHECK_EQ(bus.counters().read_bytes, 2u + 5u * 4u);
+    // Le complément reprend juste après les objets déjà lus
+    CHECK_EQ(bus.transactions()[1].reg, RX_HEADER + 10);
+    CHECK_EQ(bus.transactions()[1].data.size(), 12u);
+    CHECK_EQ(rx.num_objects(), 5);
+    CHECK_EQ(rx.data_object(4), caps[4]);
+}
+
+TEST_CASE(full_message_never_exceeds_window)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    load_message(bus, RXDatas::SOURCE_CAPABILITIES, std::vector<uint32_t>(7, fixed(5000, 3000)));
+
+    CHECK_OK(rx.read());
+    CHECK_EQ(bus.counters().read_bytes, static_cast<uint32_t>(FULL_WINDOW));
+    // Deux transactions au lieu d'une : 3 octets d'adressage de plus sur le fil dans le pire cas
+    CHECK_EQ(bus.counters().bus_bytes, FULL_WINDOW + 2u * 3u);
+}
+
+TEST_CASE(message_type_uses_five_bits)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    // Type de données 0x11 (réservé) : ne doit pas être lu comme Source_Capabilities (0x01)
+    load_message(bus, 0x11, {fixed(5000, 3000)});
+
+    CHECK_OK(rx.read());
+    CHECK_EQ(rx.message_type(), 0x11);
+    CHECK(!rx.is_source_capabilities());
+    SourceCapabilities caps;
+    CHECK(!rx.source_capabilities(caps));
+
+    // La trace décode le même header de la même façon
+    MessageTrace trace;
+    trace.record(rx, 0x18, 1);
+    TraceRecord entry;
+    CHECK(trace.at(0, entry));
+    CHECK_EQ(entry.message_type(), rx.message_type());
+    CHECK_EQ(entry.num_objects, 1);
+}
+
+TEST_CASE(failed_header_read_is_reported)
+{
+    host::FakeBus bus;
+    I2CDevices dev;
+    RXDatas rx(dev);
+    load_message(bus, 0x06, {});
+    bus.fail_next = 3; // les trois tentatives de read_register()
+
+    CHECK(rx.read() != ESP_OK);
+    CHECK_EQ(bus.counters().reads, 0u);
+}
+
+TEST_MAIN()
@@ -0,0 +1,137 @@
+// Seqlock de StatusSnapshot : un écrivain, plusieurs lecteurs concurrents, aucune copie déchirée.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "status/stusb4500-snapshot.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    // Tous les champs dérivent de k : une copie mêlant deux publications est détectable
+    StatusSnapshot make_snapshot(uint32_t k)
+    {
+        StatusSnapshot s;
+        s.timestamp_us = static_cast<int64_t>(k) * 1000;
+        s.status_timestamp_us = s.timestamp_us + 1;
+        s.rdo_timestamp_us = s.timestamp_us + 2;
+        const uint8_t b = static_cast<uint8_t>(k);
+        s.alert_status_1 = b;
+        s.port_status_0 = b;
+        s.port_status_1 = b;
+        s.typec_monitoring_status_0 = b;
+        s.typec_monitoring_status_1 = b;
+        s.cc_status = b;
+        s.cc_hw_fault_0 = b;
+        s.cc_hw_fault_1 = b;
+        s.pd_typec_status = b;
+        s.typec_status = b;
+        s.prt_status = b;
+        s.policy_engine_state = b;
+        s.rdo = k;
+        s.active_pdo = static_cast<uint8_t>(k % 3 + 1);
+        s.active_voltage_mv = static_cast<uint16_t>(k);
+        s.active_current_ma = static_cast<uint16_t>(k >> 16);
+        return s;
+    }
+
+    bool consistent(const StatusSnapshot &s)
+    {
+        const uint32_t k = s.rdo;
+        const StatusSnapshot expected = make_snapshot(k);
+        return s.timestamp_us == expected.timestamp_us && s.status_timestamp_us == expected.status_timestamp_us &&
+               s.rdo_timestamp_us == expected.rdo_timestamp_us && s.alert_status_1 == expected.alert_status_1 &&
+               s.port_status_0 == expected.port_status_0 && s.port_status_1 == expected.port_status_1 &&
+               s.typec_monitoring_status_0 == expected.typec_monitoring_status_0 &&
+               s.typec_monitoring_status_1 == expected.typec_monitoring_status_1 && s.cc_status == expected.cc_status &&
+               s.cc_hw_fault_0 == expected.cc_hw_fault_0 && s.cc_hw_fault_1 == expected.cc_hw_fault_1 &&
+               s.pd_typec_status == expected.pd_typec_status && s.typec_status == expected.typec_status &&
+               s.prt_status == expected.prt_status && s.policy_engine_state == expected.policy_engine_state &&
+               s.active_pdo == expected.active_pdo && s.active_voltage_mv == expected.active_voltage_mv &&
+               s.active_current_ma == expected.active_current_ma;
+    }
+} // namespace
+
+TEST_CASE(read_before_publish_is_empty)
+{
+    SnapshotPublisher publisher;
+    StatusSnapshot s = make_snapshot(7);
+    CHECK(publisher.read(s));
+    CHECK_EQ(s.sequence, 0u);
+    CHECK_EQ(s.rdo, 0u);
+}
+
+TEST_CASE(sequence_counts_publications)
+{
+    SnapshotPublisher publisher;
+    for (uint32_t k = 1; k <= 5; ++k)
+        publisher.publish(make_snapshot(k));
+    StatusSnapshot s;
+    CHECK(publisher.read(s));
+    CHECK_EQ(s.sequence, 5u);
+    CHECK(consistent(s));
+    CHECK_EQ(s.rdo, 5u);
+}
+
+TEST_CASE(concurrent_readers_never_see_torn_copy)
+{
+    constexpr uint32_t PUBLISHES = 1000000;
+    constexpr int READERS = 3;
+
+    SnapshotPublisher publisher;
+    publisher.publish(make_snapshot(1));
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0};
+    std::atomic<uint32_t> backwards{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> gave_up{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < READERS; ++r)
+    {
+        readers.emplace_back([&] {
+            uint32_t last = 0;
+            uint64_t local_reads = 0;
+            uint64_t local_gave_up = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                StatusSnapshot s;
+                if (!publisher.read(s))
+                {
+                    ++local_gave_up;
+                    continue;
+                }
+                ++local_reads;
+                if (!consistent(s) || s.sequence != s.rdo)
+                    ++torn;
+                if (s.sequence < last)
+                    ++backwards;
+                last = s.sequence;
+            }
+            reads += local_reads;
+            gave_up += local_gave_up;
+        });
+    }
+
+    for (uint32_t k = 2; k <= PUBLISHES; ++k)
+        publisher.publish(make_snapshot(k));
+    done = true;
+    for (std::thread &t : readers)
+        t.join();
+
+    std::printf("%llu lectures cohérentes, %llu abandons après 16 essais\n",
+                static_cast<unsigned long long>(reads.load()), static_cast<unsigned long long>(gave_up.load()));
+    CHECK_EQ(torn.load(), 0u);
+    CHECK_EQ(backwards.load(), 0u);
+    CHECK(reads.load() > 0);
+
+    StatusSnapshot last;
+    CHECK(publisher.read(last));
+    CHECK_EQ(last.sequence, PUBLISHES);
+    CHECK(consistent(last));
+}
+
+TEST_MAIN()
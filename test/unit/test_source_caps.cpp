@@ -0,0 +1,156 @@
+// Décodage de Source_Capabilities relevés sur des chargeurs : PDO fixes, PPS, AVS, batterie, variable.
+// Chaque capture est la fenêtre RX (header + objets, little-endian) telle que lue en 0x31.
+
+#include <vector>
+
+#include "check.hpp"
+#include "pd/stusb4500-rx_datas.hpp"
+#include "pd/stusb4500-source_caps.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    std::vector<uint8_t> rx_window(const std::vector<uint32_t> &objects)
+    {
+        const uint16_t header = static_cast<uint16_t>(RXDatas::SOURCE_CAPABILITIES | objects.size() << 12);
+        std::vector<uint8_t> window{static_cast<uint8_t>(header), static_cast<uint8_t>(header >> 8)};
+        for (uint32_t obj : objects)
+            for (int b = 0; b < 4; ++b)
+                window.push_back(static_cast<uint8_t>(obj >> (8 * b)));
+        return window;
+    }
+
+    SourceCapabilities decode_capture(const std::vector<uint32_t> &objects)
+    {
+        I2CDevices dev;
+        RXDatas rx(dev);
+        const std::vector<uint8_t> window = rx_window(objects);
+        rx.decode(window.data(), window.size());
+        SourceCapabilities caps;
+        CHECK(rx.source_capabilities(caps));
+        return caps;
+    }
+
+    void check_fixed(const SourcePDO &pdo, uint16_t mv, uint16_t ma)
+    {
+        CHECK(pdo.type == SourcePDOType::Fixed);
+        CHECK_EQ(pdo.min_voltage_mv, mv);
+        CHECK_EQ(pdo.max_voltage_mv, mv);
+        CHECK_EQ(pdo.max_current_ma, ma);
+        CHECK_EQ(pdo.max_power_mw, static_cast<uint32_t>(mv) * ma / 1000);
+    }
+} // namespace
+
+TEST_CASE(laptop_65w_with_pps)
+{
+    // 5 V/9 V/15 V 3 A, 20 V 3,25 A, PPS 3,3-21 V 3,25 A
+    const SourceCapabilities caps = decode_capture({0x0F01912C, 0x0002D12C, 0x0004B12C, 0x00064145, 0xC1A42141});
+    CHECK_EQ(caps.size(), 5u);
+    check_fixed(caps[0], 5000, 3000);
+    CHECK(caps[0].unconstrained_power);
+    CHECK(caps[0].usb_comm_capable);
+    CHECK(caps[0].dual_role_data);
+    CHECK(caps[0].unchunked_ext);
+    CHECK(!caps[0].dual_role_power);
+    CHECK(!caps[0].epr_capable);
+    check_fixed(caps[1], 9000, 3000);
+    check_fixed(caps[2], 15000, 3000);
+    check_fixed(caps[3], 20000, 3250);
+
+    const SourcePDO &pps = caps[4];
+    CHECK(pps.type == SourcePDOType::PPS);
+    CHECK_EQ(pps.min_voltage_mv, 3300);
+    CHECK_EQ(pps.max_voltage_mv, 21000);
+    CHECK_EQ(pps.max_current_ma, 3250);
+    CHECK(!pps.pps_power_limited);
+    CHECK(pps.covers(12000));
+    CHECK(!pps.covers(3000));
+    CHECK_EQ(caps.max_power_mw(), 68250u);
+    CHECK(caps.at_position(5) == &caps[4]);
+    CHECK(caps.at_position(6) == nullptr);
+    CHECK(caps.at_position(0) == nullptr);
+}
+
+TEST_CASE(epr_140w_with_avs)
+{
+    // Chargeur EPR : 28 V 5 A fixe et APDO EPR AVS 15-28 V, 140 W
+    const SourceCapabilities caps =
+        decode_capture({0x2E81912C, 0x0002D12C, 0x0004B12C, 0x000641F4, 0x0008C1F4, 0xD230968C});
+    CHECK_EQ(caps.size(), 6u);
+    check_fixed(caps[0], 5000, 3000);
+    CHECK(caps[0].epr_capable);
+    CHECK(caps[0].dual_role_power);
+    check_fixed(caps[3], 20000, 5000);
+    check_fixed(caps[4], 28000, 5000);
+
+    const SourcePDO &avs = caps[5];
+    CHECK(avs.type == SourcePDOType::EPR_AVS);
+    CHECK_EQ(avs.min_voltage_mv, 15000);
+    CHECK_EQ(avs.max_voltage_mv, 28000);
+    CHECK_EQ(avs.max_power_mw, 140000u);
+    CHECK_EQ(avs.max_current_ma, 9333); // PDP à Vmin
+    CHECK_EQ(caps.max_power_mw(), 140000u);
+}
+
+TEST_CASE(spr_avs)
+{
+    // SPR AVS 9-20 V : 3 A à 15 V, 2,25 A à 20 V
+    const SourceCapabilities caps = decode_capture({0x0801912C, 0x0002D12C, 0x0004B12C, 0x000640E1, 0xE004B0E1});
+    CHECK_EQ(caps.size(), 5u);
+    const SourcePDO &avs = caps[4];
+    CHECK(avs.type == SourcePDOType::SPR_AVS);
+    CHECK_EQ(avs.min_voltage_mv, 9000);
+    CHECK_EQ(avs.max_voltage_mv, 20000);
+    CHECK_EQ(avs.max_current_ma, 3000);
+    CHECK_EQ(avs.max_power_mw, 45000u);
+}
+
+TEST_CASE(battery_and_variable_supplies)
+{
+    // Bloc batterie : 5 V 2 A, batterie 5-12 V 30 W, variable 5-12 V 2,5 A
+    const SourceCapabilities caps = decode_capture({0x000190C8, 0x4F019078, 0x8F0190FA});
+    CHECK_EQ(caps.size(), 3u);
+    check_fixed(caps[0], 5000, 2000);
+
+    const SourcePDO &battery = caps[1];
+    CHECK(battery.type == SourcePDOType::Battery);
+    CHECK_EQ(battery.min_voltage_mv, 5000);
+    CHECK_EQ(battery.max_voltage_mv, 12000);
+    CHECK_EQ(battery.max_power_mw, 30000u);
+    CHECK_EQ(battery.max_current_ma, 6000);
+
+    const SourcePDO &variable = caps[2];
+    CHECK(variable.type == SourcePDOType::Variable);
+    CHECK_EQ(variable.min_voltage_mv, 5000);
+    CHECK_EQ(variable.max_voltage_mv, 12000);
+    CHECK_EQ(variable.max_current_ma, 2500);
+    CHECK_EQ(variable.max_power_mw, 30000u);
+}
+
+TEST_CASE(truncated_capture_keeps_received_objects)
+{
+    // Header annonçant 4 objets, seuls 2 reçus
+    std::vector<uint8_t> window = rx_window({0x0801912C, 0x0002D12C, 0x0004B12C, 0x000640E1});
+    window.resize(2 + 2 * 4);
+    I2CDevices dev;
+    RXDatas rx(dev);
+    rx.decode(window.data(), window.size());
+    SourceCapabilities caps;
+    CHECK(rx.source_capabilities(caps));
+    CHECK_EQ(caps.size(), 2u);
+    check_fixed(caps[1], 9000, 3000);
+}
+
+TEST_CASE(control_message_is_not_capabilities)
+{
+    const uint8_t ps_rdy[2] = {0x06, 0x00};
+    I2CDevices dev;
+    RXDatas rx(dev);
+    rx.decode(ps_rdy, sizeof(ps_rdy));
+    SourceCapabilities caps;
+    CHECK(!rx.source_capabilities(caps));
+    CHECK(caps.empty());
+}
+
+TEST_MAIN()
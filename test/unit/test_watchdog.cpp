@@ -0,0 +1,230 @@
+// Échelle de reprise du watchdog de négociation : action non exécutée rejouée, échelle complète, rafale de hard resets
+// et défauts CC, seule puis depuis la tâche du driver face à une source simulée défaillante.
+
+#include "check.hpp"
+#include "driver_harness.hpp"
+#include "host_platform.hpp"
+#include "ctrl/stusb4500-watchdog.hpp"
+
+using namespace stusb4500;
+
+namespace
+{
+    constexpr int64_t DEADLINE_US = static_cast<int64_t>(STUSB4500_CONTRACT_DEADLINE_MS) * 1000;
+    using Action = NegotiationWatchdog::Action;
+    constexpr uint8_t VBUS_DISCH_FAULT = 1 << 4; // CC_HW_FAULT_STATUS_1
+} // namespace
+
+TEST_CASE(failed_action_is_retried_at_same_step)
+{
+    NegotiationWatchdog watchdog;
+    watchdog.on_attach(1000);
+    CHECK(watchdog.poll(1000 + DEADLINE_US - 1) == Action::None);
+
+    int64_t now = 1000 + DEADLINE_US;
+    CHECK(watchdog.poll(now) == Action::SoftReset);
+    watchdog.on_action_failed(Action::SoftReset, now);
+    CHECK_EQ(watchdog.counters().soft_resets, 0u);
+    CHECK_EQ(watchdog.counters().failed_actions, 1u);
+    CHECK_EQ(watchdog.level(), 0);
+    CHECK_EQ(watchdog.time_to_deadline(now), NegotiationWatchdog::Settings{}.failed_action_retry_us);
+
+    // Même marche, délai de base : pas de doublement pour une action qui n'a pas eu lieu
+    now += NegotiationWatchdog::Settings{}.failed_action_retry_us;
+    CHECK(watchdog.poll(now) == Action::SoftReset);
+    CHECK_EQ(watchdog.counters().soft_resets, 1u);
+    CHECK_EQ(watchdog.time_to_deadline(now), DEADLINE_US);
+    CHECK(watchdog.poll(now + DEADLINE_US) == Action::HardReset);
+    CHECK_EQ(watchdog.time_to_deadline(now + DEADLINE_US), 2 * DEADLINE_US);
+}
+
+TEST_CASE(cc_fault_on_empty_port_is_only_counted)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    CHECK_OK(manager.init_device());
+
+    // Décharge de VBUS en défaut au détachement : port vide, rien à reprendre
+    chip.cc_fault(VBUS_DISCH_FAULT);
+    host::run_alerts_until(manager, host::now_us() + 100000);
+    CHECK_EQ(manager.watchdog().counters().cc_faults, 1u);
+    CHECK(!manager.watchdog().armed());
+    CHECK_EQ(manager.watchdog().time_to_deadline(host::now_us()), -1);
+
+    // L'attachement suivant part du bas de l'échelle
+    chip.attach({host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)});
+    host::run_alerts_until(manager, host::now_us() + 1000000);
+    CHECK_EQ(chip.contract_mv(), 20000u);
+    CHECK_EQ(manager.watchdog().level(), 0);
+    CHECK(!manager.watchdog().armed());
+    CHECK_EQ(chip.soft_resets, 0u);
+}
+
+namespace
+{
+    const std::vector<uint32_t> SOURCE{host::ChipSim::fixed(5000, 3000), host::ChipSim::fixed(20000, 3000)};
+
+    // La source ne répond pas : soft reset du watchdog à l'échéance, bus en défaut à cet instant
+    void soft_reset_retried_after_bus_error(host::ChipSim &chip, STUSB4500Manager &manager)
+    {
+        const int64_t attach_us = host::now_us();
+        chip.attach(SOURCE);
+        chip.freeze_pe(0x13);
+        host::run_task_for(DEADLINE_US - 10000);
+        CHECK_EQ(chip.soft_resets, 0u);
+        chip.fail_next = 1; // écriture de TX_HEADER_LOW : commande, une seule tentative
+        host::run_task_for(attach_us + DEADLINE_US + 20000 - host::now_us());
+        CHECK_EQ(chip.soft_resets, 0u);
+        CHECK_EQ(manager.watchdog().counters().failed_actions, 1u);
+        CHECK_EQ(manager.watchdog().counters().soft_resets, 0u);
+
+        // Nouvel essai après failed_action_retry_us, pas après l'échéance suivante
+        host::run_task_for(NegotiationWatchdog::Settings{}.failed_action_retry_us + 20000);
+        CHECK_EQ(chip.soft_resets, 1u);
+        CHECK_EQ(manager.watchdog().counters().soft_resets, 1u);
+
+        // Soft reset accepté : la négociation aboutit
+        host::run_task_for(1000000);
+        CHECK_EQ(chip.contract_mv(), 20000u);
+        CHECK(!manager.watchdog().armed());
+    }
+
+    // Source muette : soft reset à D, hard reset à 2D, repli 5 V à 4D
+    void full_ladder_on_silent_source(host::ChipSim &chip, STUSB4500Manager &manager)
+    {
+        const NegotiationWatchdog::Counters before = manager.watchdog().counters();
+        const uint32_t soft_resets = chip.soft_resets;
+        chip.silent = true;
+        const int64_t attach_us = host::now_us();
+        chip.attach(SOURCE);
+
+        host::run_task_for(attach_us + DEADLINE_US + 10000 - host::now_us());
+        CHECK_EQ(chip.soft_resets, soft_resets + 1);
+        CHECK_EQ(chip.hard_resets, 0u);
+        host::run_task_for(attach_us + 2 * DEADLINE_US + 10000 - host::now_us());
+        CHECK_EQ(chip.hard_resets, 1u);
+        CHECK_EQ(chip.sink_pdo_count(), 3);
+        host::run_task_for(attach_us + 4 * DEADLINE_US - 20000 - host::now_us());
+        CHECK_EQ(chip.sink_pdo_count(), 3);
+        host::run_task_for(30000);
+        CHECK_EQ(chip.sink_pdo_count(), 1);
+        CHECK_EQ(chip.soft_resets, soft_resets + 2); // soft reset du repli
+
+        const NegotiationWatchdog::Counters &after = manager.watchdog().counters();
+        CHECK_EQ(after.soft_resets - before.soft_resets, 1u);
+        CHECK_EQ(after.hard_resets - before.hard_resets, 1u);
+        CHECK_EQ(after.fallbacks - before.fallbacks, 1u);
+        // Échéance suivante à 8D, le repli reste la dernière marche
+        CHECK(manager.watchdog().time_to_deadline(host::now_us()) > 4 * DEADLINE_US - 20000);
+
+        // La source se réveille : contrat 5 V sur le PDO de repli, échelle désarmée
+        chip.silent = false;
+        chip.resend_caps(SOURCE);
+        host::run_task_for(100000);
+        CHECK_EQ(chip.contract_mv(), 5000u);
+        CHECK(!manager.watchdog().armed());
+        CHECK_EQ(manager.watchdog().counters().recoveries - before.recoveries, 1u);
+
+        // Détachement : table configurée restaurée
+        chip.detach();
+        host::run_task_for(100000);
+        CHECK_EQ(chip.sink_pdo_count(), 3);
+    }
+
+    // Défaut CC port vide, puis attachement normal : aucune action du watchdog
+    void cc_fault_while_detached(host::ChipSim &chip, STUSB4500Manager &manager)
+    {
+        const NegotiationWatchdog::Counters before = manager.watchdog().counters();
+        const uint32_t soft_resets = chip.soft_resets;
+        const uint32_t hard_resets = chip.hard_resets;
+        chip.cc_fault(VBUS_DISCH_FAULT);
+        host::run_task_for(5 * DEADLINE_US);
+        CHECK_EQ(manager.watchdog().counters().cc_faults - before.cc_faults, 1u);
+        CHECK(!manager.watchdog().armed());
+        CHECK_EQ(chip.soft_resets, soft_resets);
+        CHECK_EQ(chip.hard_resets, hard_resets);
+
+        chip.attach(SOURCE);
+        host::run_task_for(2 * DEADLINE_US);
+        CHECK_EQ(chip.contract_mv(), 20000u);
+        CHECK_EQ(chip.soft_resets, soft_resets);
+        CHECK_EQ(chip.hard_resets, hard_resets);
+        CHECK_EQ(manager.watchdog().counters().fallbacks, before.fallbacks);
+        CHECK_EQ(chip.sink_pdo_count(), 3);
+    }
+
+    // Rafale de hard resets de la source : repli 5 V sans attendre l'échéance
+    void hard_reset_burst_falls_back(host::ChipSim &chip, STUSB4500Manager &manager)
+    {
+        const NegotiationWatchdog::Counters before = manager.watchdog().counters();
+        const uint8_t limit = NegotiationWatchdog::Settings{}.hard_reset_limit;
+        for (uint8_t i = 0; i + 1 < limit; ++i)
+        {
+            chip.receive_hard_reset();
+            host::run_task_for(100000);
+            CHECK_EQ(chip.sink_pdo_count(), 3);
+        }
+        chip.receive_hard_reset();
+        host::run_task_for(10000);
+        CHECK_EQ(chip.sink_pdo_count(), 1);
+        const NegotiationWatchdog::Counters &after = manager.watchdog().counters();
+        CHECK_EQ(after.hard_resets_received - before.hard_resets_received, limit);
+        CHECK_EQ(after.fallbacks - before.fallbacks, 1u);
+        CHECK_EQ(after.soft_resets, before.soft_resets);
+        CHECK_EQ(after.hard_resets, before.hard_resets);
+
+        // Capacités renvoyées après le soft reset du repli : contrat 5 V
+        host::run_task_for(200000);
+        CHECK_EQ(chip.contract_mv(), 5000u);
+        chip.detach();
+        host::run_task_for(100000);
+    }
+
+    // Défaut CC pendant la négociation : soft reset immédiat, avant l'échéance
+    void cc_fault_jumps_the_deadline(host::ChipSim &chip, STUSB4500Manager &manager)
+    {
+        const NegotiationWatchdog::Counters before = manager.watchdog().counters();
+        const uint32_t soft_resets = chip.soft_resets;
+        chip.silent = true;
+        chip.attach(SOURCE);
+        host::run_task_for(500000);
+        CHECK_EQ(chip.soft_resets, soft_resets);
+
+        chip.cc_fault(VBUS_DISCH_FAULT);
+        host::run_task_for(10000);
+        CHECK_EQ(chip.soft_resets, soft_resets + 1);
+        CHECK_EQ(manager.watchdog().counters().cc_faults - before.cc_faults, 1u);
+        CHECK_EQ(manager.watchdog().counters().soft_resets - before.soft_resets, 1u);
+
+        chip.silent = false;
+        chip.resend_caps(SOURCE);
+        host::run_task_for(100000);
+        CHECK_EQ(chip.contract_mv(), 20000u);
+        CHECK(!manager.watchdog().armed());
+    }
+} // namespace
+
+// Une seule tâche par processus : les scénarios s'enchaînent sur le même manager, port détaché entre deux
+TEST_CASE(task_recovers_faulty_source)
+{
+    host::reset();
+    host::ChipSim chip;
+    host::load_kconfig(chip);
+    I2CDevices dev;
+    STUSB4500Manager manager(dev);
+    manager.init();
+    host::run_task_for(100000);
+
+    soft_reset_retried_after_bus_error(chip, manager);
+    chip.detach();
+    host::run_task_for(100000);
+    full_ladder_on_silent_source(chip, manager);
+    cc_fault_while_detached(chip, manager);
+    hard_reset_burst_falls_back(chip, manager);
+    cc_fault_jumps_the_deadline(chip, manager);
+}
+
+TEST_MAIN()
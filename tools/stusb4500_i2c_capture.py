@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Décode une capture I2C produite par BusRecorder (STUSB4500).
+
+Usage : stusb4500_i2c_capture.py capture.bin [--csv]
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = 0x52433249  # "I2CR"
+HEADER = struct.Struct("<IB3x")
+RECORD = struct.Struct("<IBBB")
+FLAG_WRITE = 0x01
+FLAG_ERROR = 0x02
+
+
+def decode(blob):
+    magic, version = HEADER.unpack_from(blob, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic 0x%08X" % magic)
+    if version != 1:
+        raise ValueError("unsupported capture v%d" % version)
+
+    offset = HEADER.size
+    t_us = 0
+    while offset + RECORD.size <= len(blob):
+        delta_us, flags, reg, length = RECORD.unpack_from(blob, offset)
+        offset += RECORD.size
+        err = 0
+        if flags & FLAG_ERROR:
+            (err,) = struct.unpack_from("<i", blob, offset)
+            offset += 4
+        write = bool(flags & FLAG_WRITE)
+        payload = length if (write or not err) else 0
+        data = blob[offset:offset + payload]
+        if len(data) != payload:
+            print("capture tronquée", file=sys.stderr)
+            return
+        offset += payload
+        t_us += delta_us
+        yield t_us, write, reg, length, err, data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture")
+    parser.add_argument("--csv", action="store_true", help="sortie CSV au lieu du texte")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        blob = f.read()
+
+    if args.csv:
+        print("time_us,op,reg,len,err,data")
+    for t_us, write, reg, length, err, data in decode(blob):
+        op = "W" if write else "R"
+        hexdata = data.hex(" ").upper()
+        if args.csv:
+            print("%d,%s,0x%02X,%d,%d,%s" % (t_us, op, reg, length, err, hexdata))
+        else:
+            status = "" if not err else "  err=0x%X" % (err & 0xFFFFFFFF)
+            print("%12.3f ms  %s 0x%02X [%2d]  %s%s" % (t_us / 1000.0, op, reg, length, hexdata, status))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
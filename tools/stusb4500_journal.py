@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Décode une image de la partition écrite par EventJournal (STUSB4500).
+
+Usage : stusb4500_journal.py journal.bin [--csv]
+        (esptool.py read_flash <offset> <taille> journal.bin)
+"""
+import argparse
+import struct
+import sys
+
+RECORD = struct.Struct("<IIBBHI")
+ERASED = b"\xff" * RECORD.size
+
+EVENTS = {
+    1: "Boot", 2: "Attach", 3: "Detach", 4: "Contract", 5: "SoftReset", 6: "HardReset",
+    7: "HardResetReceived", 8: "CCFault", 9: "Fallback", 10: "NvmWrite", 11: "Overflow",
+    12: "BusRecovery",
+}
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def details(event, arg16, arg32):
+    name = EVENTS.get(event)
+    if name == "Contract":
+        return "PDO %d  %d mV  %d mA" % (arg16, arg32 >> 16, (arg32 & 0xFFFF) * 10)
+    if name == "CCFault":
+        return "CC_HW_FAULT_STATUS_1=0x%02X" % arg16
+    if name == "NvmWrite":
+        return "ok" if arg32 == 0 else "err=0x%X" % arg32
+    if name == "Overflow":
+        return "%d événements perdus" % arg32
+    if name == "BusRecovery":
+        return "%s en %.1f ms" % ("resynchronisé" if arg16 else "abandon", arg32 / 1000.0)
+    return ""
+
+
+def decode(blob):
+    """Enregistrements valides, triés par numéro de séquence (l'anneau peut reboucler)."""
+    records = []
+    corrupt = 0
+    for offset in range(0, len(blob) - RECORD.size + 1, RECORD.size):
+        raw = blob[offset:offset + RECORD.size]
+        if raw == ERASED:
+            continue
+        seq, uptime_ms, event, crc, arg16, arg32 = RECORD.unpack(raw)
+        if crc8(raw[:9] + b"\x00" + raw[10:]) != crc:
+            corrupt += 1
+            continue
+        records.append((seq, uptime_ms, event, arg16, arg32))
+    records.sort()
+    return records, corrupt
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image")
+    parser.add_argument("--csv", action="store_true", help="sortie CSV au lieu du texte")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        blob = f.read()
+
+    records, corrupt = decode(blob)
+    if args.csv:
+        print("sequence,uptime_ms,event,arg16,arg32")
+    for seq, uptime_ms, event, arg16, arg32 in records:
+        name = EVENTS.get(event, "Unknown(%d)" % event)
+        if args.csv:
+            print("%d,%d,%s,%d,%d" % (seq, uptime_ms, name, arg16, arg32))
+        else:
+            print("#%-8d %10.3f s  %-18s %s" % (seq, uptime_ms / 1000.0, name, details(event, arg16, arg32)))
+    if corrupt:
+        print("%d enregistrement(s) rejeté(s) (CRC)" % corrupt, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Décode une image binaire produite par MessageTrace::dump() (STUSB4500).
+
+Usage : stusb4500_trace.py trace.bin [--csv]
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = 0x52544450  # "PDTR"
+HEADER = struct.Struct("<IBBH")
+RECORD = struct.Struct("<qHBB7I")
+
+CONTROL_MESSAGES = {
+    1: "GoodCRC", 2: "GotoMin", 3: "Accept", 4: "Reject", 5: "Ping", 6: "PS_RDY",
+    7: "Get_Source_Cap", 8: "Get_Sink_Cap", 9: "DR_Swap", 10: "PR_Swap", 11: "VCONN_Swap",
+    12: "Wait", 13: "Soft_Reset", 16: "Not_Supported", 17: "Get_Source_Cap_Extended",
+    18: "Get_Status", 19: "FR_Swap", 20: "Get_PPS_Status", 21: "Get_Country_Codes",
+}
+
+DATA_MESSAGES = {
+    1: "Source_Capabilities", 2: "Request", 3: "BIST", 4: "Sink_Capabilities",
+    5: "Battery_Status", 6: "Alert", 7: "Get_Country_Info", 8: "Enter_USB",
+    9: "EPR_Request", 10: "EPR_Mode", 11: "Source_Info", 12: "Revision", 15: "Vendor_Defined",
+}
+
+
+def message_name(header):
+    msg_type = header & 0x1F
+    num_objects = (header >> 12) & 0x07
+    table = DATA_MESSAGES if num_objects else CONTROL_MESSAGES
+    return table.get(msg_type, "Reserved(%d)" % msg_type)
+
+
+def decode(blob):
+    magic, version, record_size, count = HEADER.unpack_from(blob, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic 0x%08X" % magic)
+    if version != 1 or record_size != RECORD.size:
+        raise ValueError("unsupported dump v%d (record %d bytes)" % (version, record_size))
+
+    offset = HEADER.size
+    for _ in range(count):
+        ts, header, pe_state, num_objects, *objects = RECORD.unpack_from(blob, offset)
+        offset += record_size
+        yield ts, header, pe_state, objects[:num_objects]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump")
+    parser.add_argument("--csv", action="store_true", help="sortie CSV au lieu du texte")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        blob = f.read()
+
+    first = None
+    if args.csv:
+        print("timestamp_us,pe_state,header,message,objects")
+    for ts, header, pe_state, objects in decode(blob):
+        first = ts if first is None else first
+        words = " ".join("%08X" % o for o in objects)
+        if args.csv:
+            print("%d,0x%02X,0x%04X,%s,%s" % (ts, pe_state, header, message_name(header), words))
+        else:
+            print("%12.3f ms  PE=0x%02X  hdr=0x%04X  %-22s %s"
+                  % ((ts - first) / 1000.0, pe_state, header, message_name(header), words))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())